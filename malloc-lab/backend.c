@@ -0,0 +1,143 @@
+/*
+ * backend.c - Allocator backends the driver can run side by side
+ *             (see backend.h)
+ *
+ * The builds of mm.c and mm_implicit.c name their functions with a
+ * prefix (mm.h), which DECLARE_MM declares here. A shared library is
+ * opened RTLD_LOCAL, so its malloc doesn't replace the driver's own,
+ * and its functions are looked up by prefix + malloc etc.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dlfcn.h>
+#include "backend.h"
+
+#define DECLARE_MM(p) \
+    int p##mm_init(void); \
+    void *p##mm_malloc(size_t size); \
+    void p##mm_free(void *ptr); \
+    void *p##mm_realloc(void *ptr, size_t size); \
+    void p##mm_stats(mm_stats_t *st); \
+    int p##mm_check(int level);
+
+#define MM_BACKEND(p, name, desc, check) \
+    {name, desc, p##mm_init, p##mm_malloc, p##mm_free, p##mm_realloc, p##mm_stats, check, 1}
+
+DECLARE_MM(seg_)
+DECLARE_MM(tree_)
+DECLARE_MM(slab_)
+DECLARE_MM(implicit_)
+
+static int libc_init(void)
+{
+    return 0;
+}
+
+/* Linked into the driver */
+static const mm_backend_t builtin[] = {
+    MM_BACKEND(, "mm", "mm.c as configured (config.h, MMFLAGS)", mm_check),
+    MM_BACKEND(implicit_, "implicit", "implicit free list, next fit (mm_implicit.c)", NULL),
+    MM_BACKEND(seg_, "seg", "mm.c with segregated lists only (no tree, no slab)", seg_mm_check),
+    MM_BACKEND(tree_, "tree", "mm.c with lists and the large block tree (no slab)", tree_mm_check),
+    MM_BACKEND(slab_, "slab", "mm.c with lists and the small block slab (no tree)", slab_mm_check),
+    {"libc", "the C library's malloc", libc_init, malloc, free, realloc, NULL, NULL, 0},
+};
+
+#define NUM_BUILTIN (sizeof(builtin) / sizeof(builtin[0]))
+
+/* Shared libraries, loaded on demand */
+static struct {
+    const char *name;
+    const char *desc;
+    const char *lib;        /* dlopen'd by this name */
+    const char *prefix;     /* of its malloc, free and realloc */
+    mm_backend_t be;        /* filled in once loaded */
+} shared[] = {
+    {"jemalloc", "jemalloc (dlopen)", "libjemalloc.so.2", ""},
+    {"tcmalloc", "tcmalloc (dlopen)", "libtcmalloc.so.4", "tc_"},
+    {"mimalloc", "mimalloc (dlopen)", "libmimalloc.so.2", "mi_"},
+};
+
+#define NUM_SHARED (sizeof(shared) / sizeof(shared[0]))
+
+/* Look up prefix + name in handle */
+static void *dl_sym(void *handle, const char *prefix, const char *name)
+{
+    char sym[64];
+
+    snprintf(sym, sizeof(sym), "%s%s", prefix, name);
+    return dlsym(handle, sym);
+}
+
+/* Fill in be from the library lib; 0 with the reason in err on failure */
+static int dl_load(mm_backend_t *be, const char *lib, const char *prefix,
+                   char *err, size_t errlen)
+{
+    void *handle;
+
+    if ((handle = dlopen(lib, RTLD_NOW | RTLD_LOCAL)) == NULL) {
+        snprintf(err, errlen, "%s", dlerror());
+        return 0;
+    }
+    be->init = libc_init;
+    be->malloc = (void *(*)(size_t))dl_sym(handle, prefix, "malloc");
+    be->free = (void (*)(void *))dl_sym(handle, prefix, "free");
+    be->realloc = (void *(*)(void *, size_t))dl_sym(handle, prefix, "realloc");
+    be->stats = NULL;
+    be->check = NULL;
+    be->heap = 0;
+    if (be->malloc == NULL || be->free == NULL || be->realloc == NULL) {
+        snprintf(err, errlen, "%s has no %smalloc, %sfree and %srealloc",
+                 lib, prefix, prefix, prefix);
+        dlclose(handle);
+        return 0;
+    }
+    return 1;
+}
+
+const mm_backend_t *backend_find(const char *name, char *err, size_t errlen)
+{
+    mm_backend_t *be;
+    size_t i;
+
+    for (i = 0; i < NUM_BUILTIN; i++)
+        if (strcmp(builtin[i].name, name) == 0)
+            return &builtin[i];
+    for (i = 0; i < NUM_SHARED; i++)
+        if (strcmp(shared[i].name, name) == 0) {
+            if (shared[i].be.name == NULL) {
+                if (!dl_load(&shared[i].be, shared[i].lib, shared[i].prefix, err, errlen))
+                    return NULL;
+                shared[i].be.name = shared[i].name;
+                shared[i].be.desc = shared[i].desc;
+            }
+            return &shared[i].be;
+        }
+    if (strncmp(name, "dl:", 3) == 0) {
+        if ((be = calloc(1, sizeof(*be))) == NULL) {
+            snprintf(err, errlen, "out of memory");
+            return NULL;
+        }
+        if (!dl_load(be, name + 3, "", err, errlen)) {
+            free(be);
+            return NULL;
+        }
+        be->name = strdup(name);
+        be->desc = be->name;
+        return be;
+    }
+    snprintf(err, errlen, "no backend called %s", name);
+    return NULL;
+}
+
+void backend_list(FILE *fp)
+{
+    size_t i;
+
+    for (i = 0; i < NUM_BUILTIN; i++)
+        fprintf(fp, "  %-10s %s\n", builtin[i].name, builtin[i].desc);
+    for (i = 0; i < NUM_SHARED; i++)
+        fprintf(fp, "  %-10s %s\n", shared[i].name, shared[i].desc);
+    fprintf(fp, "  %-10s %s\n", "dl:<path>", "malloc, free and realloc of the library at <path>");
+}
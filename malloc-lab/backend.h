@@ -0,0 +1,42 @@
+/*
+ * backend.h - Allocator backends the driver can run side by side
+ *
+ * A backend is a table of the functions mdriver calls. Several are
+ * linked into the driver: mm.c as configured, three more builds of it
+ * with some layers compiled out (each built with its own MM_PREFIX,
+ * see mm.h), the implicit next-fit baseline of mm_implicit.c, and the
+ * C library's malloc. Allocators that are shared libraries (jemalloc,
+ * tcmalloc, mimalloc, or any other library given as dl:<path>) are
+ * looked up with dlopen when first asked for.
+ *
+ * Backends that allocate from memlib's heap reset it with
+ * mem_reset_brk before init, so their utilization and footprint can
+ * be measured; the others manage their own memory, and only their
+ * correctness, throughput and latency can be.
+ */
+#ifndef __BACKEND_H_
+#define __BACKEND_H_
+
+#include <stdio.h>
+#include "mm.h"
+
+typedef struct {
+    const char *name;
+    const char *desc;
+    int (*init)(void);
+    void *(*malloc)(size_t size);
+    void (*free)(void *ptr);
+    void *(*realloc)(void *ptr, size_t size);
+    void (*stats)(mm_stats_t *st);  /* NULL: no heap statistics */
+    int (*check)(int level);        /* NULL: no consistency checks */
+    int heap;                       /* allocates from memlib's heap? */
+} mm_backend_t;
+
+/* The backend called name (loading its library if it is one), or NULL
+ * with the reason in err */
+const mm_backend_t *backend_find(const char *name, char *err, size_t errlen);
+
+/* Print the names and descriptions of the backends to fp */
+void backend_list(FILE *fp);
+
+#endif /* __BACKEND_H_ */
@@ -0,0 +1,224 @@
+/*
+ * bench.c - Repeated timing with confidence intervals, and baselines
+ *           (see bench.h)
+ *
+ * The interval for the median of n samples is between the order
+ * statistics of ranks n/2 -+ 1.96 sqrt(n)/2 (the normal approximation
+ * to the binomial), which holds whatever the distribution of the
+ * samples; with fewer than 6 samples it is the whole range.
+ *
+ * Baselines are written one trace per line, and read back by picking
+ * the keys out of each trace's line, which is all the reader needs to
+ * understand of JSON.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sched.h>
+#include "bench.h"
+#include "clock.h"
+
+int bench_pin(int cpu)
+{
+    cpu_set_t set;
+
+    if (cpu < 0 && (cpu = sched_getcpu()) < 0)
+        return -1;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) < 0)
+        return -1;
+    return cpu;
+}
+
+static double now_secs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned long long now_cycles(void)
+{
+    unsigned hi, lo;
+
+    access_counter(&hi, &lo);
+    return ((unsigned long long)hi << 32) | lo;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+/* Sort x[0..n-1] and return its median, with the 95% interval in *lo, *hi */
+static double median_ci(double *x, int n, double *lo, double *hi)
+{
+    double h = 0.98 * sqrt((double)n);
+    int j = (int)floor(n / 2.0 - h) - 1, k = (int)ceil(n / 2.0 + 1 + h) - 1;
+
+    qsort(x, n, sizeof(double), cmp_double);
+    *lo = x[(n < 6 || j < 0) ? 0 : j];
+    *hi = x[(n < 6 || k > n - 1) ? n - 1 : k];
+    return (n % 2) ? x[n / 2] : (x[n / 2 - 1] + x[n / 2]) / 2;
+}
+
+void bench_run(bench_funct f, void *argp, int warmup, int n, bench_result_t *r)
+{
+    double *secs = malloc(n * sizeof(double)), *cyc = malloc(n * sizeof(double));
+    double t0, lo, hi;
+    unsigned long long c0;
+    int i;
+
+    if (secs == NULL || cyc == NULL) {
+        fprintf(stderr, "bench_run: out of memory\n");
+        exit(1);
+    }
+    for (i = 0; i < warmup; i++)
+        f(argp);
+    for (i = 0; i < n; i++) {
+        t0 = now_secs();
+        c0 = now_cycles();
+        f(argp);
+        cyc[i] = (double)(now_cycles() - c0);
+        secs[i] = now_secs() - t0;
+    }
+
+    r->samples = n;
+    r->secs = median_ci(secs, n, &r->secs_lo, &r->secs_hi);
+    r->kops = r->ops / r->secs / 1e3;
+    r->kops_lo = r->ops / r->secs_hi / 1e3;
+    r->kops_hi = r->ops / r->secs_lo / 1e3;
+    r->cycles_per_op = median_ci(cyc, n, &lo, &hi) / r->ops;
+    free(secs);
+    free(cyc);
+}
+
+/* Write s as a JSON string */
+static void put_string(FILE *fp, const char *s)
+{
+    fputc('"', fp);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', fp);
+        fputc(*s, fp);
+    }
+    fputc('"', fp);
+}
+
+int bench_save(const char *path, const bench_result_t *r, int n, const char *config)
+{
+    FILE *fp;
+    int i;
+
+    if ((fp = fopen(path, "w")) == NULL)
+        return 0;
+    fprintf(fp, "{\n  \"version\": 1,\n  \"config\": ");
+    put_string(fp, config);
+    fprintf(fp, ",\n  \"traces\": [\n");
+    for (i = 0; i < n; i++) {
+        fprintf(fp, "    {\"name\": ");
+        put_string(fp, r[i].name);
+        fprintf(fp, ", \"ops\": %.0f, \"util\": %.6f, \"samples\": %d, "
+                "\"secs\": %.9g, \"secs_lo\": %.9g, \"secs_hi\": %.9g, "
+                "\"kops\": %.6g, \"kops_lo\": %.6g, \"kops_hi\": %.6g, "
+                "\"cycles_per_op\": %.6g}%s\n",
+                r[i].ops, r[i].util, r[i].samples, r[i].secs, r[i].secs_lo,
+                r[i].secs_hi, r[i].kops, r[i].kops_lo, r[i].kops_hi,
+                r[i].cycles_per_op, (i < n - 1) ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    return fclose(fp) == 0;
+}
+
+/* The number after "key": in line, or 0 */
+static double get_number(const char *line, const char *key)
+{
+    char pat[64];
+    const char *p;
+
+    snprintf(pat, sizeof(pat), "\"%s\":", key);
+    return ((p = strstr(line, pat)) != NULL) ? strtod(p + strlen(pat), NULL) : 0;
+}
+
+int bench_load(const char *path, bench_result_t **r)
+{
+    FILE *fp;
+    char line[4 * BENCH_NAME_LEN], *p;
+    bench_result_t *b;
+    int n = 0, cap = 0;
+    size_t len;
+
+    if ((fp = fopen(path, "r")) == NULL)
+        return -1;
+    *r = NULL;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if ((p = strstr(line, "{\"name\": \"")) == NULL)
+            continue;
+        if (n == cap) {
+            cap = cap ? 2 * cap : 16;
+            if ((*r = realloc(*r, cap * sizeof(bench_result_t))) == NULL) {
+                fclose(fp);
+                return -1;
+            }
+        }
+        b = &(*r)[n++];
+        memset(b, 0, sizeof(*b));
+        for (p += strlen("{\"name\": \""), len = 0; *p && *p != '"'; p++) {
+            if (*p == '\\' && p[1] != '\0')
+                p++;
+            if (len < BENCH_NAME_LEN - 1)
+                b->name[len++] = *p;
+        }
+        b->ops = get_number(p, "ops");
+        b->util = get_number(p, "util");
+        b->samples = (int)get_number(p, "samples");
+        b->secs = get_number(p, "secs");
+        b->secs_lo = get_number(p, "secs_lo");
+        b->secs_hi = get_number(p, "secs_hi");
+        b->kops = get_number(p, "kops");
+        b->kops_lo = get_number(p, "kops_lo");
+        b->kops_hi = get_number(p, "kops_hi");
+        b->cycles_per_op = get_number(p, "cycles_per_op");
+    }
+    fclose(fp);
+    return n;
+}
+
+int bench_compare(const bench_result_t *r, int n, const bench_result_t *base, int nbase,
+                  double threshold)
+{
+    const bench_result_t *b;
+    double dk, du;
+    int i, j, slow, bloat, regressions = 0;
+
+    printf("%5s %10s %10s %21s %8s %7s %7s  %s\n", "trace", "base Kops", "Kops",
+           "95% CI", "change", "util", "change", "verdict");
+    for (i = 0; i < n; i++) {
+        for (j = 0, b = NULL; j < nbase && b == NULL; j++)
+            if (strcmp(base[j].name, r[i].name) == 0)
+                b = &base[j];
+        if (b == NULL || b->kops <= 0) {
+            printf("%5d %10s %10.0f [%9.0f,%9.0f] %8s %6.1f%% %7s  new (%s)\n", i, "-",
+                   r[i].kops, r[i].kops_lo, r[i].kops_hi, "", r[i].util * 100, "", r[i].name);
+            continue;
+        }
+        dk = r[i].kops / b->kops - 1;
+        du = (b->util > 0) ? r[i].util / b->util - 1 : 0;
+        slow = dk < -threshold && r[i].kops_hi < b->kops_lo;
+        bloat = du < -threshold;
+        regressions += slow || bloat;
+        printf("%5d %10.0f %10.0f [%9.0f,%9.0f] %+7.1f%% %6.1f%% %+6.1f%%  %s\n", i,
+               b->kops, r[i].kops, r[i].kops_lo, r[i].kops_hi, dk * 100,
+               r[i].util * 100, du * 100,
+               slow && bloat ? "REGRESSED (throughput, util)" :
+               slow ? "REGRESSED (throughput)" : bloat ? "REGRESSED (util)" : "ok");
+    }
+    return regressions;
+}
@@ -0,0 +1,56 @@
+/*
+ * bench.h - Repeated timing with confidence intervals, and baselines
+ *
+ * The benchmark mode of mdriver (-b) pins itself to one CPU, runs a
+ * trace a few times untimed to warm the caches and the heap's pages,
+ * and then times it n times. Each sample is read from
+ * CLOCK_MONOTONIC_RAW (not slewed by NTP) and from the cycle counter
+ * (clock.c). A run is summarized by the median and a distribution-free
+ * 95% confidence interval for it, from the order statistics, so a few
+ * samples slowed by a timer interrupt or a migration don't move it.
+ *
+ * Results can be saved as a JSON baseline and later runs checked
+ * against one: a trace regresses if its throughput fell by more than
+ * the threshold and its confidence interval lies wholly below the
+ * baseline's (so noise alone doesn't fail the gate), or if its
+ * utilization fell by more than the threshold.
+ */
+#ifndef __BENCH_H_
+#define __BENCH_H_
+
+#define BENCH_NAME_LEN 256
+
+/* Summary of n timed runs of one trace */
+typedef struct {
+    char name[BENCH_NAME_LEN];  /* trace file */
+    double ops;                 /* requests per run */
+    double util;                /* utilization (from eval_mm_util) */
+    int samples;                /* timed runs */
+    double secs;                /* median secs per run ... */
+    double secs_lo, secs_hi;    /* ... and its 95% confidence interval */
+    double kops, kops_lo, kops_hi;  /* the same as Kops/s */
+    double cycles_per_op;       /* median cycle counter ticks per request */
+} bench_result_t;
+
+typedef void (*bench_funct)(void *);
+
+/* Pin the calling thread to cpu (-1: the one it is on); returns the cpu or -1 */
+int bench_pin(int cpu);
+
+/* Time f(argp) n times after warmup untimed runs and summarize into r */
+void bench_run(bench_funct f, void *argp, int warmup, int n, bench_result_t *r);
+
+/* Write n results to path as JSON; 0 on error */
+int bench_save(const char *path, const bench_result_t *r, int n, const char *config);
+
+/* Read a baseline written by bench_save; returns the number of results
+ * (put in a malloc'd array at *r) or -1 if it can't be read */
+int bench_load(const char *path, bench_result_t **r);
+
+/* Compare n results with a baseline of nbase (by trace name), printing
+ * a line per trace; returns the number of regressions beyond threshold
+ * (a fraction, e.g. 0.05) */
+int bench_compare(const bench_result_t *r, int n, const bench_result_t *base, int nbase,
+                  double threshold);
+
+#endif /* __BENCH_H_ */
@@ -0,0 +1,720 @@
+/*
+ * capture.c - Capture the allocations of a running program as a trace
+ *
+ * usage: MMCAPTURE=<out.bin> LD_PRELOAD=./libmmcapture.so <program> ...
+ *
+ * An LD_PRELOAD library that interposes malloc, free, realloc, calloc,
+ * reallocarray and the aligned mallocs (posix_memalign, aligned_alloc,
+ * memalign), passes each call on to the C library's own
+ * (__libc_malloc etc.), and writes the requests to <out.bin> as a
+ * binary trace (trace.h) that mdriver replays directly, or rep2bin -D
+ * turns into a .rep file it reads. A %p in the path is replaced by the
+ * process id (the default is mmcapture.%p.bin), and a path without one
+ * gets .<pid> appended, so each process a program starts writes its
+ * own trace instead of truncating its parent's.
+ *
+ * Each thread appends its requests to a ring of its own, with no lock:
+ * a record carries a sequence number from one shared counter, taken
+ * after the C library returns a block and before it is given one back,
+ * so the numbers order the requests on each address as they happened.
+ * A writer thread merges the rings in sequence order, up to the lowest
+ * number a thread may still be about to publish, and writes the trace
+ * as it goes. It gives each block a dense id from 0 when it is
+ * allocated; a realloc keeps the id (it is recorded as two halves, the
+ * old block before the call and the new one after it). The id table
+ * holds the block's first address. When the program exits, the blocks
+ * still live are freed at the end of the trace, as in the -bal traces.
+ *
+ * mm_malloc(0) is NULL, so zero-byte mallocs aren't recorded, nor are
+ * frees of blocks the capture never saw allocated. Aligned mallocs are
+ * recorded as plain mallocs of their size. A forked child stops
+ * recording (its exec starts a new capture), and a process that ends
+ * without running its exit handlers (exec, _exit, a signal) leaves an
+ * empty trace.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "trace.h"
+
+#define RING_LEN 8192			/* records per thread ring (a power of two) */
+#define OUT_CHUNK 4096			/* trace records per write */
+#define WRITER_SLEEP 1000000	/* ns the writer waits when it has caught up */
+#define PATH_LEN 4096
+#define NO_ID UINT32_MAX
+#define NO_SEQ UINT64_MAX
+#define OPS_OFFSET ((sizeof(trace_hdr_t) + 7) & ~(size_t)7)
+
+#define TLS __thread __attribute__((tls_model("initial-exec")))
+
+/* The C library's allocator, which the hooks call */
+extern void *__libc_malloc(size_t size);
+extern void __libc_free(void *ptr);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_memalign(size_t align, size_t size);
+
+/* Record types */
+enum
+{
+	R_ALLOC,	/* new block q of size bytes */
+	R_FREE,		/* block p is freed */
+	R_UNMAP,	/* realloc, before the call: p is given back */
+	R_REMAP		/* realloc, after the call: p became q (NULL: failed) */
+};
+
+typedef struct
+{
+	uint64_t seq;	/* order of the request */
+	uint64_t size;
+	void *p, *q;
+	uint32_t type;
+} rec_t;
+
+/* One thread's records, from the thread (head) to the writer (tail) */
+typedef struct ring
+{
+	struct ring *next;		/* list of all rings */
+	int owned;				/* a live thread writes to it */
+	uint64_t busy;			/* lower bound on the seq of a record being written */
+	uint64_t head, tail;	/* records written, records merged */
+	uint32_t pend;			/* the writer's: id of a realloc between its halves */
+	rec_t recs[RING_LEN];
+} ring_t;
+
+/* Shared between the hooks and the writer */
+static int capturing;				/* record requests? */
+static uint64_t seq_clock;			/* next sequence number */
+static ring_t *rings;				/* every ring so far */
+static pthread_key_t ring_key;		/* gives a ring back when its thread exits */
+static pthread_t writer;
+static int writer_stop;
+static pid_t capture_pid;			/* the process capturing (not a forked child) */
+
+static TLS ring_t *my_ring;
+static TLS int in_capture;			/* inside the capture itself: don't record */
+
+/* The writer's state */
+static int out_fd = -1;
+static char out_path[PATH_LEN];
+static traceop_t out[OUT_CHUNK];
+static size_t out_len;
+static uint64_t num_ops, num_ids;
+static int out_failed;
+static uint64_t *first_addr;		/* by id: the block's first address (the id table) */
+static uint64_t *id_size;			/* by id: its size now */
+static size_t ids_cap;
+static uint64_t live_bytes, peak_bytes;
+
+/* Open-addressing map from address to id, linear probing */
+static uint64_t *map_keys;			/* addresses (0 = empty slot) */
+static uint32_t *map_vals;
+static size_t map_cap, map_count;
+
+static void warn(const char *msg)
+{
+	char buf[256];
+	int n = snprintf(buf, sizeof(buf), "mmcapture: %s: %s\n", out_path, msg);
+
+	if (write(STDERR_FILENO, buf, n) < 0)
+		return;
+}
+
+/*
+ * Address map
+ */
+static size_t hash64(uint64_t x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	return (size_t)x;
+}
+
+static void map_put(uint64_t key, uint32_t val);
+
+/* Double the map when it is half full */
+static int map_grow(void)
+{
+	uint64_t *keys = map_keys;
+	uint32_t *vals = map_vals;
+	size_t i, cap = map_cap;
+
+	map_cap = cap ? 2 * cap : 1 << 16;
+	map_keys = __libc_calloc(map_cap, sizeof(uint64_t));
+	map_vals = __libc_calloc(map_cap, sizeof(uint32_t));
+	if (map_keys == NULL || map_vals == NULL)
+		return 0;
+	map_count = 0;
+	for (i = 0; i < cap; i++)
+		if (keys[i] != 0)
+			map_put(keys[i], vals[i]);
+	__libc_free(keys);
+	__libc_free(vals);
+	return 1;
+}
+
+/* Slot of key, or of the empty slot where it would go */
+static size_t map_slot(uint64_t key)
+{
+	size_t j;
+
+	for (j = hash64(key) & (map_cap - 1); map_keys[j] != 0 && map_keys[j] != key;
+		 j = (j + 1) & (map_cap - 1))
+		;
+	return j;
+}
+
+static void map_put(uint64_t key, uint32_t val)
+{
+	size_t j = map_slot(key);
+
+	if (map_keys[j] == 0)
+		map_count++;
+	map_keys[j] = key;
+	map_vals[j] = val;
+}
+
+/* The id key maps to, removing it from the map; NO_ID if absent */
+static uint32_t map_take(uint64_t key)
+{
+	size_t i, j, k;
+	uint32_t val;
+
+	if (map_cap == 0 || map_keys[i = map_slot(key)] == 0)
+		return NO_ID;
+	val = map_vals[i];
+	map_count--;
+
+	/* Backward shift deletion: pull later keys of the run into the hole */
+	for (j = (i + 1) & (map_cap - 1); map_keys[j] != 0; j = (j + 1) & (map_cap - 1))
+	{
+		k = hash64(map_keys[j]) & (map_cap - 1);
+		if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j))
+		{
+			map_keys[i] = map_keys[j];
+			map_vals[i] = map_vals[j];
+			i = j;
+		}
+	}
+	map_keys[i] = 0;
+	return val;
+}
+
+/*
+ * Trace output
+ */
+static void emit(uint32_t type, uint32_t id, uint64_t size)
+{
+	if (out_failed || num_ops >= INT32_MAX)
+		return;
+	out[out_len].type = type;
+	out[out_len].index = id;
+	out[out_len].size = size;
+	num_ops++;
+	if (++out_len == OUT_CHUNK)
+	{
+		if (write(out_fd, out, sizeof(out)) != (ssize_t)sizeof(out))
+		{
+			warn("write failed; the trace is incomplete");
+			out_failed = 1;
+		}
+		out_len = 0;
+	}
+}
+
+/* A new id for block q of size bytes */
+static uint32_t new_id(void *q, uint64_t size)
+{
+	uint64_t *addr, *sz;
+	size_t cap;
+	uint32_t id;
+
+	if (num_ids == ids_cap)
+	{
+		/* On failure the old tables stay, so the ids so far still write out */
+		cap = ids_cap ? 2 * ids_cap : 1 << 16;
+		if ((addr = __libc_realloc(first_addr, cap * sizeof(uint64_t))) != NULL)
+			first_addr = addr;
+		if ((sz = __libc_realloc(id_size, cap * sizeof(uint64_t))) != NULL)
+			id_size = sz;
+		if (addr == NULL || sz == NULL)
+		{
+			warn("out of memory; the trace is incomplete");
+			out_failed = 1;
+			return NO_ID;
+		}
+		ids_cap = cap;
+	}
+	id = (uint32_t)num_ids++;
+	first_addr[id] = (uintptr_t)q;
+	id_size[id] = size;
+	return id;
+}
+
+/* Remember that block q has id id; a stale block at q was freed unseen */
+static void bind(void *q, uint32_t id)
+{
+	uint32_t old;
+
+	if ((old = map_take((uintptr_t)q)) != NO_ID)
+	{
+		live_bytes -= id_size[old];
+		emit(FREE, old, 0);
+	}
+	if (2 * (map_count + 1) > map_cap && !map_grow())
+	{
+		warn("out of memory; the trace is incomplete");
+		out_failed = 1;
+		return;
+	}
+	map_put((uintptr_t)q, id);
+}
+
+static void set_size(uint32_t id, uint64_t size)
+{
+	live_bytes += size - id_size[id];
+	id_size[id] = size;
+	if (live_bytes > peak_bytes)
+		peak_bytes = live_bytes;
+}
+
+/* Turn one record of ring r into trace records */
+static void replay(ring_t *r, const rec_t *rec)
+{
+	uint32_t id;
+
+	if (out_failed || num_ops >= INT32_MAX)	/* mdriver's limit */
+		return;
+	switch (rec->type)
+	{
+	case R_ALLOC:
+		if (rec->size == 0 || (id = new_id(rec->q, 0)) == NO_ID)
+			break;
+		bind(rec->q, id);
+		set_size(id, rec->size);
+		emit(ALLOC, id, rec->size);
+		break;
+
+	case R_FREE:
+		if ((id = map_take((uintptr_t)rec->p)) != NO_ID)
+		{
+			set_size(id, 0);
+			emit(FREE, id, 0);
+		}
+		break;
+
+	case R_UNMAP:
+		r->pend = map_take((uintptr_t)rec->p);
+		break;
+
+	case R_REMAP:
+		id = r->pend;
+		r->pend = NO_ID;
+		if (rec->q == NULL)			/* realloc failed: the old block stays */
+		{
+			if (id != NO_ID)
+				bind(rec->p, id);
+		}
+		else if (id != NO_ID)
+		{
+			bind(rec->q, id);
+			set_size(id, rec->size);
+			emit(REALLOC, id, rec->size);
+		}
+		else if ((id = new_id(rec->q, 0)) != NO_ID)	/* of a block never seen */
+		{
+			bind(rec->q, id);
+			set_size(id, rec->size);
+			emit(ALLOC, id, rec->size);
+		}
+		break;
+	}
+}
+
+/*
+ * merge - Replay the records of all rings in sequence order, up to the
+ *     first one that may not have been published yet: the lowest seq a
+ *     thread is busy with, or the next one when none is. A thread can
+ *     only be handed a seq that isn't below the counter as read here.
+ *     Returns the number of records replayed.
+ */
+static size_t merge(void)
+{
+	uint64_t limit, b, seq;
+	ring_t *r, *min;
+	size_t n = 0;
+
+	limit = __atomic_load_n(&seq_clock, __ATOMIC_SEQ_CST);
+	for (r = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); r != NULL; r = r->next)
+		if ((b = __atomic_load_n(&r->busy, __ATOMIC_SEQ_CST)) < limit)
+			limit = b;
+
+	for (;;)
+	{
+		min = NULL;
+		seq = limit;
+		for (r = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); r != NULL; r = r->next)
+			if (r->tail < __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) &&
+				r->recs[r->tail & (RING_LEN - 1)].seq < seq)
+			{
+				min = r;
+				seq = r->recs[r->tail & (RING_LEN - 1)].seq;
+			}
+		if (min == NULL)
+			return n;
+		replay(min, &min->recs[min->tail & (RING_LEN - 1)]);
+		__atomic_store_n(&min->tail, min->tail + 1, __ATOMIC_RELEASE);
+		n++;
+	}
+}
+
+static void *writer_main(void *arg)
+{
+	struct timespec ts = {0, WRITER_SLEEP};
+
+	(void)arg;
+	in_capture = 1;
+	while (!__atomic_load_n(&writer_stop, __ATOMIC_ACQUIRE))
+		if (merge() == 0)
+			nanosleep(&ts, NULL);
+	return NULL;
+}
+
+/* Write a varint of the id table into buf at *len, flushing as it fills */
+static void put_varint(char *buf, size_t *len, size_t cap, uint64_t v)
+{
+	if (*len + 10 > cap)
+	{
+		if (write(out_fd, buf, *len) != (ssize_t)*len)
+			out_failed = 1;
+		*len = 0;
+	}
+	while (v >= 0x80)
+	{
+		buf[(*len)++] = (char)((v & 0x7f) | 0x80);
+		v >>= 7;
+	}
+	buf[(*len)++] = (char)v;
+}
+
+/* Write the header of a trace of the ops and ids so far, whose id
+ * table is ids_len bytes */
+static int put_header(uint64_t ids_len)
+{
+	trace_hdr_t hdr;
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, TRACE_MAGIC, TRACE_MAGIC_LEN);
+	hdr.version = TRACE_VERSION;
+	hdr.byte_order = TRACE_BYTE_ORDER;
+	hdr.op_size = sizeof(traceop_t);
+	hdr.weight = 1;
+	hdr.sugg_heapsize = peak_bytes;
+	hdr.num_ids = num_ids;
+	hdr.num_ops = num_ops;
+	hdr.ops_offset = OPS_OFFSET;
+	hdr.ids_offset = OPS_OFFSET + num_ops * sizeof(traceop_t);
+	hdr.ids_len = ids_len;
+	return pwrite(out_fd, &hdr, sizeof(hdr), 0) == (ssize_t)sizeof(hdr);
+}
+
+/*
+ * finish - Free the blocks still live, then write the id table and the
+ *     header
+ */
+static void finish(void)
+{
+	char buf[4096];
+	ring_t *r;
+	size_t i, len = 0;
+	uint64_t prev = 0;
+	int64_t d;
+
+	for (r = rings; r != NULL; r = r->next)	/* a realloc cut short by exit */
+		if (r->pend != NO_ID)
+			emit(FREE, r->pend, 0);
+	for (i = 0; i < map_cap; i++)
+		if (map_keys[i] != 0)
+			emit(FREE, map_vals[i], 0);
+	if (out_len > 0 && write(out_fd, out, out_len * sizeof(traceop_t)) !=
+						   (ssize_t)(out_len * sizeof(traceop_t)))
+		out_failed = 1;
+
+	for (i = 0; i < num_ids; i++)
+	{
+		d = (int64_t)(first_addr[i] - prev);
+		put_varint(buf, &len, sizeof(buf), ((uint64_t)d << 1) ^ (uint64_t)(d >> 63));
+		prev = first_addr[i];
+	}
+	if (len > 0 && write(out_fd, buf, len) != (ssize_t)len)
+		out_failed = 1;
+	if (!put_header((uint64_t)lseek(out_fd, 0, SEEK_CUR) - OPS_OFFSET -
+					num_ops * sizeof(traceop_t)) || out_failed)
+		warn("write failed; the trace is incomplete");
+	close(out_fd);
+}
+
+/*
+ * Recording, in the hooks
+ */
+
+/* Give the ring of an exiting thread back, for the next thread (a
+ * later free in the thread's exit takes a ring again) */
+static void ring_release(void *arg)
+{
+	my_ring = NULL;
+	__atomic_store_n(&((ring_t *)arg)->owned, 0, __ATOMIC_RELEASE);
+}
+
+/* The calling thread's ring: one given back by an exited thread, or a new one */
+static ring_t *ring_get(void)
+{
+	ring_t *r;
+	int zero;
+
+	in_capture = 1;
+	for (r = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); r != NULL; r = r->next)
+	{
+		zero = 0;
+		if (__atomic_compare_exchange_n(&r->owned, &zero, 1, 0, __ATOMIC_ACQUIRE,
+										__ATOMIC_RELAXED))
+			break;
+	}
+	if (r == NULL)
+	{
+		r = mmap(NULL, sizeof(ring_t), PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (r == MAP_FAILED)
+		{
+			in_capture = 0;
+			return NULL;
+		}
+		r->owned = 1;
+		r->busy = NO_SEQ;
+		r->pend = NO_ID;
+		r->next = __atomic_load_n(&rings, __ATOMIC_RELAXED);
+		while (!__atomic_compare_exchange_n(&rings, &r->next, r, 1, __ATOMIC_RELEASE,
+											__ATOMIC_RELAXED))
+			;
+	}
+	pthread_setspecific(ring_key, r);
+	in_capture = 0;
+	return my_ring = r;
+}
+
+/*
+ * record - Append a record to the calling thread's ring. The thread
+ *     marks itself busy with a lower bound on the seq it will get
+ *     before taking it, so the writer doesn't merge past the record
+ *     until it is published; if the ring is full, it waits for the
+ *     writer. Returns 0 if the thread has no ring.
+ */
+static int record(uint32_t type, void *p, void *q, uint64_t size)
+{
+	ring_t *r = my_ring;
+	rec_t *rec;
+
+	if (r == NULL && (r = ring_get()) == NULL)
+		return 0;
+	__atomic_store_n(&r->busy, __atomic_load_n(&seq_clock, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+	while (r->head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) == RING_LEN)
+		sched_yield();
+	rec = &r->recs[r->head & (RING_LEN - 1)];
+	rec->seq = __atomic_fetch_add(&seq_clock, 1, __ATOMIC_SEQ_CST);
+	rec->type = type;
+	rec->p = p;
+	rec->q = q;
+	rec->size = size;
+	__atomic_store_n(&r->head, r->head + 1, __ATOMIC_RELEASE);
+	__atomic_store_n(&r->busy, NO_SEQ, __ATOMIC_RELEASE);
+	return 1;
+}
+
+#define RECORDING() (__atomic_load_n(&capturing, __ATOMIC_RELAXED) && !in_capture)
+
+void *malloc(size_t size)
+{
+	void *q = __libc_malloc(size);
+
+	if (q != NULL && RECORDING())
+		record(R_ALLOC, NULL, q, size);
+	return q;
+}
+
+void free(void *p)
+{
+	if (p != NULL && RECORDING())
+		record(R_FREE, p, NULL, 0);
+	__libc_free(p);
+}
+
+void *calloc(size_t n, size_t size)
+{
+	void *q = __libc_calloc(n, size);
+
+	if (q != NULL && RECORDING())
+		record(R_ALLOC, NULL, q, n * size);
+	return q;
+}
+
+void *realloc(void *p, size_t size)
+{
+	void *q;
+	int rec;
+
+	if (p == NULL)
+		return malloc(size);
+	if (size == 0)				/* the C library frees p */
+	{
+		free(p);
+		return NULL;
+	}
+	rec = RECORDING() && record(R_UNMAP, p, NULL, 0);
+	q = __libc_realloc(p, size);
+	if (rec)					/* the second half even if the capture has stopped */
+		record(R_REMAP, p, q, size);
+	return q;
+}
+
+void *reallocarray(void *p, size_t n, size_t size)
+{
+	if (size != 0 && n > SIZE_MAX / size)
+	{
+		errno = ENOMEM;
+		return NULL;
+	}
+	return realloc(p, n * size);
+}
+
+void *memalign(size_t align, size_t size)
+{
+	void *q = __libc_memalign(align, size);
+
+	if (q != NULL && RECORDING())
+		record(R_ALLOC, NULL, q, size);
+	return q;
+}
+
+void *aligned_alloc(size_t align, size_t size)
+{
+	return memalign(align, size);
+}
+
+int posix_memalign(void **ptr, size_t align, size_t size)
+{
+	void *q;
+
+	if (align == 0 || align % sizeof(void *) != 0 || (align & (align - 1)) != 0)
+		return EINVAL;
+	if ((q = memalign(align, size)) == NULL && size != 0)
+		return ENOMEM;
+	*ptr = q;
+	return 0;
+}
+
+/*
+ * Start and stop
+ */
+
+/* A forked child has no writer: stop recording */
+static void child_after_fork(void)
+{
+	__atomic_store_n(&capturing, 0, __ATOMIC_RELAXED);
+	my_ring = NULL;
+}
+
+/*
+ * The output path from MMCAPTURE, with %p replaced by the process id,
+ * or the id appended if there is no %p: a child that execs starts a
+ * capture of its own, which must not truncate the file its parent is
+ * still writing
+ */
+static void make_path(void)
+{
+	const char *fmt = getenv("MMCAPTURE");
+	size_t i, n = 0;
+	int pid_seen = 0;
+
+	if (fmt == NULL || *fmt == '\0')
+		fmt = "mmcapture.%p.bin";
+	for (i = 0; fmt[i] != '\0' && n < PATH_LEN - 48; i++)
+		if (fmt[i] == '%' && fmt[i + 1] == 'p')
+		{
+			n += snprintf(out_path + n, PATH_LEN - n, "%ld", (long)getpid());
+			pid_seen = 1;
+			i++;
+		}
+		else
+			out_path[n++] = fmt[i];
+	if (!pid_seen)
+		n += snprintf(out_path + n, PATH_LEN - n, ".%ld", (long)getpid());
+	out_path[n] = '\0';
+}
+
+__attribute__((constructor)) static void capture_start(void)
+{
+	in_capture = 1;
+	make_path();
+	if ((out_fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+	{
+		warn(strerror(errno));
+		in_capture = 0;
+		return;
+	}
+	if (!put_header(0) ||				/* an empty trace until finish */
+		lseek(out_fd, OPS_OFFSET, SEEK_SET) < 0 ||
+		pthread_key_create(&ring_key, ring_release) != 0 ||
+		pthread_atfork(NULL, NULL, child_after_fork) != 0 ||
+		pthread_create(&writer, NULL, writer_main, NULL) != 0)
+	{
+		warn("can't start the capture");
+		close(out_fd);
+		out_fd = -1;
+		in_capture = 0;
+		return;
+	}
+	capture_pid = getpid();
+	__atomic_store_n(&capturing, 1, __ATOMIC_SEQ_CST);
+	in_capture = 0;
+}
+
+/*
+ * capture_stop - At exit: stop recording, let the requests already
+ *     under way publish their records, stop the writer, merge what is
+ *     left and finish the trace
+ */
+__attribute__((destructor)) static void capture_stop(void)
+{
+	struct timespec ts = {0, WRITER_SLEEP};
+	ring_t *r;
+	int i;
+
+	if (out_fd < 0 || getpid() != capture_pid)
+		return;
+	in_capture = 1;
+	__atomic_store_n(&capturing, 0, __ATOMIC_SEQ_CST);
+	for (i = 0; i < 100; i++)					/* at most 0.1 s */
+	{
+		for (r = __atomic_load_n(&rings, __ATOMIC_ACQUIRE); r != NULL; r = r->next)
+			if (__atomic_load_n(&r->busy, __ATOMIC_SEQ_CST) != NO_SEQ)
+				break;
+		if (r == NULL)
+			break;
+		nanosleep(&ts, NULL);
+	}
+	__atomic_store_n(&writer_stop, 1, __ATOMIC_RELEASE);
+	pthread_join(writer, NULL);
+	while (merge() > 0)
+		;
+	finish();
+	out_fd = -1;
+}
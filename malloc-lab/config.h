@@ -1,72 +1,322 @@
-#ifndef __CONFIG_H_
-#define __CONFIG_H_
-
-/*
- * config.h - malloc lab configuration file
- *
- * Copyright (c) 2002, R. Bryant and D. O'Hallaron, All rights reserved.
- * May not be used, modified, or copied without permission.
- */
-
-/*
- * This is the default path where the driver will look for the
- * default tracefiles. You can override it at runtime with the -t flag.
- */
-#define TRACEDIR "./traces/"
-
-/*
- * This is the list of default tracefiles in TRACEDIR that the driver
- * will use for testing. Modify this if you want to add or delete
- * traces from the driver's test suite. For example, if you don't want
- * your students to implement realloc, you can delete the last two
- * traces.
- */
-#define DEFAULT_TRACEFILES \
-  "amptjp-bal.rep",\
-  "cccp-bal.rep",\
-  "cp-decl-bal.rep",\
-  "expr-bal.rep",\
-  "coalescing-bal.rep",\
-  "random-bal.rep",\
-  "random2-bal.rep",\
-  "binary-bal.rep",\
-  "binary2-bal.rep",\
-  "realloc-bal.rep",\
-  "realloc2-bal.rep"
-
-/*
- * This constant gives the estimated performance of the libc malloc
- * package using our traces on some reference system, typically the
- * same kind of system the students use. Its purpose is to cap the
- * contribution of throughput to the performance index. Once the
- * students surpass the AVG_LIBC_THRUPUT, they get no further benefit
- * to their score.  This deters students from building extremely fast,
- * but extremely stupid malloc packages.
- */
-#define AVG_LIBC_THRUPUT      600E3  /* 600 Kops/sec */
-
- /* 
-  * This constant determines the contributions of space utilization
-  * (UTIL_WEIGHT) and throughput (1 - UTIL_WEIGHT) to the performance
-  * index.  
-  */
-#define UTIL_WEIGHT .60
-
-/* 
- * Alignment requirement in bytes (either 4 or 8) 
- */
-#define ALIGNMENT 8  
-
-/* 
- * Maximum heap size in bytes 
- */
-#define MAX_HEAP (20*(1<<20))  /* 20 MB */
-
-/*****************************************************************************
- * Set exactly one of these USE_xxx constants to "1" to select a timing method
- *****************************************************************************/
-#define USE_FCYC   0   /* cycle counter w/K-best scheme (x86 & Alpha only) */
-#define USE_ITIMER 0   /* interval timer (any Unix box) */
-#define USE_GETTOD 1   /* gettimeofday (any Unix box) */
-
-#endif /* __CONFIG_H */
+#ifndef __CONFIG_H_
+#define __CONFIG_H_
+
+/*
+ * config.h - malloc lab configuration file
+ *
+ * Copyright (c) 2002, R. Bryant and D. O'Hallaron, All rights reserved.
+ * May not be used, modified, or copied without permission.
+ */
+
+/*
+ * This is the default path where the driver will look for the
+ * default tracefiles. You can override it at runtime with the -t flag.
+ */
+#define TRACEDIR "./traces/"
+
+/*
+ * This is the list of default tracefiles in TRACEDIR that the driver
+ * will use for testing. Modify this if you want to add or delete
+ * traces from the driver's test suite. For example, if you don't want
+ * your students to implement realloc, you can delete the last two
+ * traces.
+ */
+#define DEFAULT_TRACEFILES \
+  "amptjp-bal.rep",\
+  "cccp-bal.rep",\
+  "cp-decl-bal.rep",\
+  "expr-bal.rep",\
+  "coalescing-bal.rep",\
+  "random-bal.rep",\
+  "random2-bal.rep",\
+  "binary-bal.rep",\
+  "binary2-bal.rep",\
+  "realloc-bal.rep",\
+  "realloc2-bal.rep"
+
+/*
+ * This constant gives the estimated performance of the libc malloc
+ * package using our traces on some reference system, typically the
+ * same kind of system the students use. Its purpose is to cap the
+ * contribution of throughput to the performance index. Once the
+ * students surpass the AVG_LIBC_THRUPUT, they get no further benefit
+ * to their score.  This deters students from building extremely fast,
+ * but extremely stupid malloc packages.
+ */
+#define AVG_LIBC_THRUPUT      600E3  /* 600 Kops/sec */
+
+ /* 
+  * This constant determines the contributions of space utilization
+  * (UTIL_WEIGHT) and throughput (1 - UTIL_WEIGHT) to the performance
+  * index.  
+  */
+#define UTIL_WEIGHT .60
+
+/*
+ * 64-bit heap layout. When set, mm.c uses size_t-wide boundary tags so
+ * a single block (and the heap) can grow past 4 GB, and payloads are
+ * 16-byte aligned for SSE/AVX data. Pair it with a larger MAX_HEAP,
+ * e.g. MMFLAGS="-DMM_64BIT=1 -DMAX_HEAP='((size_t)8<<30)'".
+ */
+#ifndef MM_64BIT
+#define MM_64BIT 0
+#endif
+
+/* 
+ * Alignment requirement in bytes (8, or 16 in the 64-bit layout) 
+ */
+#if MM_64BIT
+#define ALIGNMENT 16
+#else
+#define ALIGNMENT 8  
+#endif
+
+/* 
+ * Maximum heap size in bytes 
+ */
+#ifndef MAX_HEAP
+#define MAX_HEAP ((size_t)20 << 20)  /* 20 MB */
+#endif
+
+/*
+ * Where memlib gets the simulated heap from:
+ *   MEM_MALLOC - one libc malloc of MAX_HEAP bytes in mem_init
+ *   MEM_MMAP   - an mmap(PROT_NONE) reservation of MAX_HEAP bytes whose
+ *                pages mem_sbrk commits on demand and mem_trim hands
+ *                back with madvise(MADV_DONTNEED)
+ * With MEM_MMAP, MEM_HUGEPAGE selects the page size of the heap:
+ *   0 - base pages
+ *   1 - ask for transparent huge pages (MADV_HUGEPAGE)
+ *   2 - MAP_HUGETLB pages from the hugetlbfs pool, falling back to 1
+ *       when the pool is too small
+ * and pages are committed and released in 2 MB units when it is set.
+ */
+#define MEM_MALLOC 0
+#define MEM_MMAP   1
+
+#ifndef MEM_BACKEND
+#define MEM_BACKEND MEM_MALLOC
+#endif
+
+#ifndef MEM_HUGEPAGE
+#define MEM_HUGEPAGE 0
+#endif
+
+/*****************************************************************************
+ * Set exactly one of these USE_xxx constants to "1" to select a timing method
+ *****************************************************************************/
+#define USE_FCYC   0   /* cycle counter w/K-best scheme (x86 & Alpha only) */
+#define USE_ITIMER 0   /* interval timer (any Unix box) */
+#define USE_GETTOD 1   /* gettimeofday (any Unix box) */
+
+/*****************************************************************************
+ * Allocator (mm.c) build options. Each one can be overridden from the
+ * make command line without editing this file, e.g.
+ *
+ *     unix> make clean; make MMFLAGS="-DFIT_POLICY=FIT_BEST"
+ *****************************************************************************/
+
+/*
+ * Placement policy used by find_fit to pick a block out of the
+ * segregated free lists:
+ *   FIT_FIRST - first block in the size class (or a larger one) that fits
+ *   FIT_NEXT  - like FIT_FIRST, but resume where the last search in that
+ *               class stopped
+ *   FIT_BEST  - smallest block that fits
+ *   FIT_GOOD  - smallest of the first GOOD_FIT_LIMIT blocks that fit
+ */
+#define FIT_FIRST 0
+#define FIT_NEXT  1
+#define FIT_BEST  2
+#define FIT_GOOD  3
+
+#ifndef FIT_POLICY
+#define FIT_POLICY FIT_FIRST
+#endif
+
+#ifndef GOOD_FIT_LIMIT
+#define GOOD_FIT_LIMIT 8     /* candidates examined by FIT_GOOD */
+#endif
+
+/*
+ * Size classes of the segregated free lists. CLASS_BOUNDS lists the
+ * smallest block size of each class below CLASS_TABLE_MAX (a power of
+ * two); from there on every power of two is a class of its own, and the
+ * last of the MM_NUM_CLASSES (mm.h) takes everything larger. mkclasses
+ * turns the bounds into the lookup table mm.c maps small sizes with
+ * (sizeclass.h), so e.g. finer classes for a workload of small objects
+ * only need
+ *
+ *     unix> make clean; make MMFLAGS="-DCLASS_BOUNDS=0,32,48,64,96,128,192,256,384,512,768"
+ */
+#ifndef CLASS_BOUNDS
+#define CLASS_BOUNDS 0, 32, 64, 128, 256, 512
+#endif
+
+#ifndef CLASS_TABLE_MAX
+#define CLASS_TABLE_MAX 1024
+#endif
+
+/*
+ * Free blocks of at least TREE_MIN_SIZE bytes are kept in a size-ordered
+ * tree (a treap keyed by size and address) instead of the segregated
+ * lists, so large requests get an O(log n) best fit whatever FIT_POLICY
+ * is. Set to 0 to keep every free block in the lists.
+ */
+#ifndef TREE_MIN_SIZE
+#define TREE_MIN_SIZE 1024
+#endif
+
+/*
+ * Requests of at most SLAB_MAX_SIZE bytes are served by a slab layer:
+ * SLAB_PAGE-aligned pages carved into equal slots tracked by a bitmap,
+ * with no per-slot header. Must be a multiple of ALIGNMENT; set to 0
+ * to send every request through the boundary-tag heap.
+ */
+#ifndef SLAB_MAX_SIZE
+#define SLAB_MAX_SIZE 128
+#endif
+
+#ifndef SLAB_PAGE
+#define SLAB_PAGE (1<<12)    /* slab run size (bytes, a power of two) */
+#endif
+
+/*
+ * When a free leaves a free block of at least TRIM_THRESHOLD bytes at
+ * the end of the heap, everything but CHUNKSIZE bytes of it is handed
+ * back with mem_trim. Set to 0 to trim only on an explicit mm_trim().
+ */
+#ifndef TRIM_THRESHOLD
+#define TRIM_THRESHOLD (128 * 1024)
+#endif
+
+/*
+ * Requests of at least MMAP_THRESHOLD bytes get a page-aligned mapping
+ * of their own (mem_map) instead of a heap block: freeing one unmaps it
+ * and realloc resizes it with mremap. Set to 0 to keep every block in
+ * the heap.
+ */
+#ifndef MMAP_THRESHOLD
+#define MMAP_THRESHOLD (128 * 1024)
+#endif
+
+/*
+ * Deferred coalescing. When set, a freed block of at most
+ * QUICK_MAX_SIZE bytes (header included) is parked, still marked
+ * allocated, on a quick list for its exact size, and the next request
+ * of that size takes it back unchanged. Parked blocks are only freed
+ * and coalesced in a sweep over all quick lists, run when a request
+ * finds no fit or when a list grows past QUICK_COUNT blocks.
+ */
+#ifndef DEFER_COALESCE
+#define DEFER_COALESCE 0
+#endif
+
+#ifndef QUICK_MAX_SIZE
+#define QUICK_MAX_SIZE 512   /* largest parked block (bytes) */
+#endif
+
+#ifndef QUICK_COUNT
+#define QUICK_COUNT 64       /* longest quick list before a sweep */
+#endif
+
+/*
+ * Block layout. When set, allocated blocks carry only a header and the
+ * "previous block allocated" state lives in bit 1 of the next header, so
+ * footers are written only on free blocks (4 bytes of overhead instead
+ * of 8 per allocated block).
+ */
+#ifndef FOOTERLESS_ALLOC
+#define FOOTERLESS_ALLOC 0
+#endif
+
+/*
+ * Heap checking. mm_check(1) or higher makes the allocator check every
+ * block it hands out, frees or coalesces, at O(1) cost per request;
+ * mm_check(2) also walks the whole heap. Set to 0 to compile the
+ * per-request checks out, leaving only the explicit heap walk.
+ */
+#ifndef MM_CHECK
+#define MM_CHECK 1
+#endif
+
+/*
+ * Multi-threaded mode. When set, mm_malloc/mm_free/mm_realloc may be
+ * called from several threads. Each thread caches up to TCACHE_COUNT
+ * freed blocks per size (blocks up to TCACHE_MAX_SIZE bytes) and serves
+ * them without synchronization. Misses refill TCACHE_BATCH blocks and
+ * full bins flush half their blocks, each under a single acquisition of
+ * the mutex that protects the shared heap.
+ */
+#ifndef MM_THREADS
+#define MM_THREADS 0
+#endif
+
+#ifndef TCACHE_MAX_SIZE
+#define TCACHE_MAX_SIZE 1024 /* largest block size (bytes) kept in a tcache */
+#endif
+
+#ifndef TCACHE_COUNT
+#define TCACHE_COUNT 16      /* blocks cached per size */
+#endif
+
+#ifndef TCACHE_BATCH
+#define TCACHE_BATCH 8       /* blocks fetched from the shared heap per miss */
+#endif
+
+/*
+ * Per-thread arenas (requires MM_THREADS). Instead of one shared heap,
+ * each thread allocates from its own arena: private free lists over
+ * regions of the simulated heap taken in multiples of ARENA_GRAIN bytes.
+ * A block freed by a thread other than its owner goes onto the owner's
+ * lock-free remote-free stack, which the owner drains on its next
+ * mm_malloc. Threads beyond MAX_ARENAS share arenas round-robin.
+ */
+#ifndef MM_ARENAS
+#define MM_ARENAS 0
+#endif
+
+#ifndef MAX_ARENAS
+#define MAX_ARENAS 64        /* at most 255 */
+#endif
+
+#ifndef ARENA_GRAIN
+#define ARENA_GRAIN (1<<12)  /* arena region granularity (bytes) */
+#endif
+
+/*
+ * Regions (region.h) bump-allocate out of REGION_CHUNK-byte blocks
+ * taken from mm_malloc, and a request larger than a quarter of that
+ * gets a block of its own. Should stay below MMAP_THRESHOLD, so that
+ * the chunks come from the heap.
+ */
+#ifndef REGION_CHUNK
+#define REGION_CHUNK (16 * 1024)
+#endif
+
+/*
+ * Sampling heap profiler (prof.h). With MM_PROFILE the allocator's
+ * hooks are compiled in and a profile can be started at run time; no
+ * profile runs until mm_prof_start. A profile samples about once per
+ * PROF_RATE bytes allocated unless given another rate, keeps up to
+ * PROF_DEPTH frames per stack, and while none runs each thread enters
+ * the profiler once per PROF_IDLE bytes allocated, to notice a profile
+ * starting or a dump asked for by signal.
+ */
+#ifndef MM_PROFILE
+#define MM_PROFILE 1
+#endif
+
+#ifndef PROF_RATE
+#define PROF_RATE (512 * 1024)
+#endif
+
+#ifndef PROF_DEPTH
+#define PROF_DEPTH 32
+#endif
+
+#ifndef PROF_IDLE
+#define PROF_IDLE (1L << 20)
+#endif
+
+#endif /* __CONFIG_H */
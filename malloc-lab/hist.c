@@ -0,0 +1,109 @@
+/*
+ * hist.c - Log-linear latency histograms (see hist.h)
+ *
+ * Values below HIST_SUB_BUCKETS get a bucket each. A larger value v
+ * whose most significant bit is bit m lands in group m - HIST_SUB_BITS + 1,
+ * at the sub-bucket given by the HIST_SUB_BITS bits below bit m.
+ */
+#include <string.h>
+#include "hist.h"
+
+/* Bucket index of value v */
+static int bucket_of(unsigned long long v)
+{
+    int msb;
+
+    if (v < HIST_SUB_BUCKETS)
+        return (int)v;
+    msb = 63 - __builtin_clzll(v);
+    return (msb - HIST_SUB_BITS + 1) * HIST_SUB_BUCKETS
+        + (int)((v >> (msb - HIST_SUB_BITS)) & (HIST_SUB_BUCKETS - 1));
+}
+
+/* Smallest value that falls in bucket i */
+static unsigned long long bucket_lo(int i)
+{
+    int group = i / HIST_SUB_BUCKETS, sub = i % HIST_SUB_BUCKETS;
+
+    if (group == 0)
+        return (unsigned long long)sub;
+    return (unsigned long long)(HIST_SUB_BUCKETS + sub) << (group - 1);
+}
+
+/*
+ * hist_reset - Empty a histogram
+ */
+void hist_reset(hist_t *h)
+{
+    memset(h, 0, sizeof(*h));
+    h->min = ~0ULL;
+}
+
+/*
+ * hist_record - Count one value
+ */
+void hist_record(hist_t *h, unsigned long long v)
+{
+    h->buckets[bucket_of(v)]++;
+    h->count++;
+    h->sum += v;
+    if (v < h->min)
+        h->min = v;
+    if (v > h->max)
+        h->max = v;
+}
+
+/*
+ * hist_merge - Add the counts of src to dst
+ */
+void hist_merge(hist_t *dst, const hist_t *src)
+{
+    int i;
+
+    for (i = 0; i < HIST_BUCKETS; i++)
+        dst->buckets[i] += src->buckets[i];
+    dst->count += src->count;
+    dst->sum += src->sum;
+    if (src->min < dst->min)
+        dst->min = src->min;
+    if (src->max > dst->max)
+        dst->max = src->max;
+}
+
+/*
+ * hist_percentile - Estimate the value below which a fraction p of the
+ *     values lie. Returns the midpoint of the bucket holding that rank,
+ *     clamped to the exact min and max.
+ */
+unsigned long long hist_percentile(const hist_t *h, double p)
+{
+    unsigned long long rank, seen = 0, lo, hi, v;
+    int i;
+
+    if (h->count == 0)
+        return 0;
+    rank = (unsigned long long)(p * h->count);
+    if (rank >= h->count)
+        rank = h->count - 1;
+    for (i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen > rank)
+            break;
+    }
+    lo = bucket_lo(i);
+    hi = (i + 1 < HIST_BUCKETS) ? bucket_lo(i + 1) - 1 : ~0ULL;
+    v = lo + (hi - lo) / 2;
+    if (v < h->min)
+        v = h->min;
+    if (v > h->max)
+        v = h->max;
+    return v;
+}
+
+/*
+ * hist_mean - Mean of the recorded values (0 if none)
+ */
+double hist_mean(const hist_t *h)
+{
+    return h->count ? (double)h->sum / h->count : 0;
+}
@@ -0,0 +1,39 @@
+/*
+ * hist.h - Log-linear latency histograms
+ *
+ * Values (e.g. cycle counts) are counted in buckets whose width grows
+ * with the value: each power of two is split into HIST_SUB_BUCKETS
+ * linear sub-buckets, so a recorded value is known to within
+ * 1/HIST_SUB_BUCKETS of itself at any magnitude and recording is a
+ * shift and an increment.
+ */
+#ifndef __HIST_H_
+#define __HIST_H_
+
+#define HIST_SUB_BITS 4
+#define HIST_SUB_BUCKETS (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * HIST_SUB_BUCKETS)
+
+typedef struct {
+    unsigned long long count;             /* number of recorded values */
+    unsigned long long sum;               /* their sum (for the mean) */
+    unsigned long long min, max;          /* exact extremes */
+    unsigned long long buckets[HIST_BUCKETS];
+} hist_t;
+
+/* Empty a histogram */
+void hist_reset(hist_t *h);
+
+/* Count one value */
+void hist_record(hist_t *h, unsigned long long v);
+
+/* Add the counts of src to dst */
+void hist_merge(hist_t *dst, const hist_t *src);
+
+/* Estimate the value below which a fraction p (0..1) of the values lie */
+unsigned long long hist_percentile(const hist_t *h, double p);
+
+/* Mean of the recorded values (0 if none) */
+double hist_mean(const hist_t *h);
+
+#endif /* __HIST_H_ */
@@ -1,1071 +1,3895 @@
-/*
- * mdriver.c - CS:APP Malloc Lab Driver
- *
- * Uses a collection of trace files to tests a malloc/free/realloc
- * implementation in mm.c.
- *
- * Copyright (c) 2002, R. Bryant and D. O'Hallaron, All rights reserved.
- * May not be used, modified, or copied without permission.
- */
-#include <stdio.h>
-#include <stdlib.h>
-#include <unistd.h>
-#include <errno.h>
-#include <string.h>
-#include <assert.h>
-#include <float.h>
-#include <time.h>
-
-extern char *optarg; // Added declaration for optarg
-
-#include "mm.h"
-#include "memlib.h"
-#include "fsecs.h"
-#include "config.h"
-
-/**********************
- * Constants and macros
- **********************/
-
-/* Misc */
-#define MAXLINE 1024	   /* max string size */
-#define HDRLINES 4		   /* number of header lines in a trace file */
-#define LINENUM(i) (i + 5) /* cnvt trace request nums to linenums (origin 1) */
-
-/* Returns true if p is ALIGNMENT-byte aligned */
-#define IS_ALIGNED(p) ((((unsigned int)(p)) % ALIGNMENT) == 0)
-
-/******************************
- * The key compound data types
- *****************************/
-
-/* Records the extent of each block's payload */
-typedef struct range_t
-{
-	char *lo;			  /* low payload address */
-	char *hi;			  /* high payload address */
-	struct range_t *next; /* next list element */
-} range_t;
-
-/* Characterizes a single trace operation (allocator request) */
-typedef struct
-{
-	enum
-	{
-		ALLOC,
-		FREE,
-		REALLOC
-	} type;	   /* type of request */
-	int index; /* index for free() to use later */
-	int size;  /* byte size of alloc/realloc request */
-} traceop_t;
-
-/* Holds the information for one trace file*/
-typedef struct
-{
-	int sugg_heapsize;	 /* suggested heap size (unused) */
-	int num_ids;		 /* number of alloc/realloc ids */
-	int num_ops;		 /* number of distinct requests */
-	int weight;			 /* weight for this trace (unused) */
-	traceop_t *ops;		 /* array of requests */
-	char **blocks;		 /* array of ptrs returned by malloc/realloc... */
-	size_t *block_sizes; /* ... and a corresponding array of payload sizes */
-} trace_t;
-
-/*
- * Holds the params to the xxx_speed functions, which are timed by fcyc.
- * This struct is necessary because fcyc accepts only a pointer array
- * as input.
- */
-typedef struct
-{
-	trace_t *trace;
-	range_t *ranges;
-} speed_t;
-
-/* Summarizes the important stats for some malloc function on some trace */
-typedef struct
-{
-	/* defined for both libc malloc and student malloc package (mm.c) */
-	double ops;	 /* number of ops (malloc/free/realloc) in the trace */
-	int valid;	 /* was the trace processed correctly by the allocator? */
-	double secs; /* number of secs needed to run the trace */
-
-	/* defined only for the student malloc package */
-	double util; /* space utilization for this trace (always 0 for libc) */
-
-	/* Note: secs and util are only defined if valid is true */
-} stats_t;
-
-/********************
- * Global variables
- *******************/
-int verbose = 0;	   /* global flag for verbose output */
-static int errors = 0; /* number of errs found when running student malloc */
-char msg[MAXLINE];	   /* for whenever we need to compose an error message */
-
-/* Directory where default tracefiles are found */
-static char tracedir[MAXLINE] = TRACEDIR;
-
-/* The filenames of the default tracefiles */
-static char *default_tracefiles[] = {
-	DEFAULT_TRACEFILES, NULL};
-
-/*********************
- * Function prototypes
- *********************/
-
-/* these functions manipulate range lists */
-static int add_range(range_t **ranges, char *lo, int size,
-					 int tracenum, int opnum);
-static void remove_range(range_t **ranges, char *lo);
-static void clear_ranges(range_t **ranges);
-
-/* These functions read, allocate, and free storage for traces */
-static trace_t *read_trace(char *tracedir, char *filename);
-static void free_trace(trace_t *trace);
-
-/* Routines for evaluating the correctness and speed of libc malloc */
-static int eval_libc_valid(trace_t *trace, int tracenum);
-static void eval_libc_speed(void *ptr);
-
-/* Routines for evaluating correctnes, space utilization, and speed
-   of the student's malloc package in mm.c */
-static int eval_mm_valid(trace_t *trace, int tracenum, range_t **ranges);
-static double eval_mm_util(trace_t *trace, int tracenum, range_t **ranges);
-static void eval_mm_speed(void *ptr);
-
-/* Various helper routines */
-static void printresults(int n, stats_t *stats);
-static void usage(void);
-static void unix_error(char *msg);
-static void malloc_error(int tracenum, int opnum, char *msg);
-static void app_error(char *msg);
-
-/**************
- * Main routine
- **************/
-int main(int argc, char **argv)
-{
-	int i;
-	int c;
-	char **tracefiles = NULL;	/* null-terminated array of trace file names */
-	int num_tracefiles = 0;		/* the number of traces in that array */
-	trace_t *trace = NULL;		/* stores a single trace file in memory */
-	range_t *ranges = NULL;		/* keeps track of block extents for one trace */
-	stats_t *libc_stats = NULL; /* libc stats for each trace */
-	stats_t *mm_stats = NULL;	/* mm (i.e. student) stats for each trace */
-	speed_t speed_params;		/* input parameters to the xx_speed routines */
-
-	int team_check = 1; /* If set, check team structure (reset by -a) */
-	int run_libc = 0;	/* If set, run libc malloc (set by -l) */
-	int autograder = 0; /* If set, emit summary info for autograder (-g) */
-
-	/* temporaries used to compute the performance index */
-	double secs, ops, util, avg_mm_util, avg_mm_throughput, p1, p2, perfindex;
-	int numcorrect;
-
-	/*
-	 * Read and interpret the command line arguments
-	 */
-	while ((c = getopt(argc, argv, "f:t:hvVgal")) != EOF)
-	{
-		printf("getopt returned: %d\n", c); // 디버깅용 출력 추가
-
-		switch (c)
-		{
-		case 'g': /* Generate summary info for the autograder */
-			autograder = 1;
-			break;
-		case 'f': /* Use one specific trace file only (relative to curr dir) */
-			num_tracefiles = 1;
-			if ((tracefiles = realloc(tracefiles, 2 * sizeof(char *))) == NULL)
-				unix_error("ERROR: realloc failed in main");
-			strcpy(tracedir, "./");
-			tracefiles[0] = strdup(optarg);
-			tracefiles[1] = NULL;
-			break;
-		case 't':					 /* Directory where the traces are located */
-			if (num_tracefiles == 1) /* ignore if -f already encountered */
-				break;
-			strcpy(tracedir, optarg);
-			if (tracedir[strlen(tracedir) - 1] != '/')
-				strcat(tracedir, "/"); /* path always ends with "/" */
-			break;
-		case 'a': /* Don't check team structure */
-			team_check = 0;
-			break;
-		case 'l': /* Run libc malloc */
-			run_libc = 1;
-			break;
-		case 'v': /* Print per-trace performance breakdown */
-			verbose = 1;
-			break;
-		case 'V': /* Be more verbose than -v */
-			verbose = 2;
-			break;
-		case 'h': /* Print this message */
-			usage();
-			exit(0);
-		default:
-			usage();
-			exit(1);
-		}
-	}
-
-	/*
-	 * Check and print team info
-	 */
-	if (team_check)
-	{
-		/* Students must fill in their team information */
-		if (!strcmp(team.teamname, ""))
-		{
-			printf("ERROR: Please provide the information about your team in mm.c.\n");
-			exit(1);
-		}
-		else
-			printf("Team Name:%s\n", team.teamname);
-		if ((*team.name1 == '\0') || (*team.id1 == '\0'))
-		{
-			printf("ERROR.  You must fill in all team member 1 fields!\n");
-			exit(1);
-		}
-		else
-			printf("Member 1 :%s:%s\n", team.name1, team.id1);
-
-		if (((*team.name2 != '\0') && (*team.id2 == '\0')) ||
-			((*team.name2 == '\0') && (*team.id2 != '\0')))
-		{
-			printf("ERROR.  You must fill in all or none of the team member 2 ID fields!\n");
-			exit(1);
-		}
-		else if (*team.name2 != '\0')
-			printf("Member 2 :%s:%s\n", team.name2, team.id2);
-	}
-
-	/*
-	 * If no -f command line arg, then use the entire set of tracefiles
-	 * defined in default_traces[]
-	 */
-	if (tracefiles == NULL)
-	{
-		tracefiles = default_tracefiles;
-		num_tracefiles = sizeof(default_tracefiles) / sizeof(char *) - 1;
-		printf("Using default tracefiles in %s\n", tracedir);
-	}
-
-	/* Initialize the timing package */
-	init_fsecs();
-
-	/*
-	 * Optionally run and evaluate the libc malloc package
-	 */
-	if (run_libc)
-	{
-		if (verbose > 1)
-			printf("\nTesting libc malloc\n");
-
-		/* Allocate libc stats array, with one stats_t struct per tracefile */
-		libc_stats = (stats_t *)calloc(num_tracefiles, sizeof(stats_t));
-		if (libc_stats == NULL)
-			unix_error("libc_stats calloc in main failed");
-
-		/* Evaluate the libc malloc package using the K-best scheme */
-		for (i = 0; i < num_tracefiles; i++)
-		{
-			trace = read_trace(tracedir, tracefiles[i]);
-			libc_stats[i].ops = trace->num_ops;
-			if (verbose > 1)
-				printf("Checking libc malloc for correctness, ");
-			libc_stats[i].valid = eval_libc_valid(trace, i);
-			if (libc_stats[i].valid)
-			{
-				speed_params.trace = trace;
-				if (verbose > 1)
-					printf("and performance.\n");
-				libc_stats[i].secs = fsecs(eval_libc_speed, &speed_params);
-			}
-			free_trace(trace);
-		}
-
-		/* Display the libc results in a compact table */
-		if (verbose)
-		{
-			printf("\nResults for libc malloc:\n");
-			printresults(num_tracefiles, libc_stats);
-		}
-	}
-
-	/*
-	 * Always run and evaluate the student's mm package
-	 */
-	if (verbose > 1)
-		printf("\nTesting mm malloc\n");
-
-	/* Allocate the mm stats array, with one stats_t struct per tracefile */
-	mm_stats = (stats_t *)calloc(num_tracefiles, sizeof(stats_t));
-	if (mm_stats == NULL)
-		unix_error("mm_stats calloc in main failed");
-
-	/* Initialize the simulated memory system in memlib.c */
-	mem_init();
-
-	/* Evaluate student's mm malloc package using the K-best scheme */
-	for (i = 0; i < num_tracefiles; i++)
-	{
-		trace = read_trace(tracedir, tracefiles[i]);
-		mm_stats[i].ops = trace->num_ops;
-		if (verbose > 1)
-			printf("Checking mm_malloc for correctness, ");
-		mm_stats[i].valid = eval_mm_valid(trace, i, &ranges);
-		if (mm_stats[i].valid)
-		{
-			if (verbose > 1)
-				printf("efficiency, ");
-			mm_stats[i].util = eval_mm_util(trace, i, &ranges);
-			speed_params.trace = trace;
-			speed_params.ranges = ranges;
-			if (verbose > 1)
-				printf("and performance.\n");
-			mm_stats[i].secs = fsecs(eval_mm_speed, &speed_params);
-		}
-		free_trace(trace);
-	}
-
-	/* Display the mm results in a compact table */
-	if (verbose)
-	{
-		printf("\nResults for mm malloc:\n");
-		printresults(num_tracefiles, mm_stats);
-		printf("\n");
-	}
-
-	/*
-	 * Accumulate the aggregate statistics for the student's mm package
-	 */
-	secs = 0;
-	ops = 0;
-	util = 0;
-	numcorrect = 0;
-	for (i = 0; i < num_tracefiles; i++)
-	{
-		secs += mm_stats[i].secs;
-		ops += mm_stats[i].ops;
-		util += mm_stats[i].util;
-		if (mm_stats[i].valid)
-			numcorrect++;
-	}
-	avg_mm_util = util / num_tracefiles;
-
-	/*
-	 * Compute and print the performance index
-	 */
-	if (errors == 0)
-	{
-		avg_mm_throughput = ops / secs;
-
-		p1 = UTIL_WEIGHT * avg_mm_util;
-		if (avg_mm_throughput > AVG_LIBC_THRUPUT)
-		{
-			p2 = (double)(1.0 - UTIL_WEIGHT);
-		}
-		else
-		{
-			p2 = ((double)(1.0 - UTIL_WEIGHT)) *
-				 (avg_mm_throughput / AVG_LIBC_THRUPUT);
-		}
-
-		perfindex = (p1 + p2) * 100.0;
-		printf("Perf index = %.0f (util) + %.0f (thru) = %.0f/100\n",
-			   p1 * 100,
-			   p2 * 100,
-			   perfindex);
-	}
-	else
-	{ /* There were errors */
-		perfindex = 0.0;
-		printf("Terminated with %d errors\n", errors);
-	}
-
-	if (autograder)
-	{
-		printf("correct:%d\n", numcorrect);
-		printf("perfidx:%.0f\n", perfindex);
-	}
-
-	exit(0);
-}
-
-/*****************************************************************
- * The following routines manipulate the range list, which keeps
- * track of the extent of every allocated block payload. We use the
- * range list to detect any overlapping allocated blocks.
- ****************************************************************/
-
-/*
- * add_range - As directed by request opnum in trace tracenum,
- *     we've just called the student's mm_malloc to allocate a block of
- *     size bytes at addr lo. After checking the block for correctness,
- *     we create a range struct for this block and add it to the range list.
- */
-static int add_range(range_t **ranges, char *lo, int size,
-					 int tracenum, int opnum)
-{
-	char *hi = lo + size - 1;
-	range_t *p;
-	char msg[MAXLINE];
-
-	assert(size > 0);
-
-	/* Payload addresses must be ALIGNMENT-byte aligned */
-	if (!IS_ALIGNED(lo))
-	{
-		sprintf(msg, "Payload address (%p) not aligned to %d bytes",
-				lo, ALIGNMENT);
-		malloc_error(tracenum, opnum, msg);
-		return 0;
-	}
-
-	/* The payload must lie within the extent of the heap */
-	if ((lo < (char *)mem_heap_lo()) || (lo > (char *)mem_heap_hi()) ||
-		(hi < (char *)mem_heap_lo()) || (hi > (char *)mem_heap_hi()))
-	{
-		sprintf(msg, "Payload (%p:%p) lies outside heap (%p:%p)",
-				lo, hi, mem_heap_lo(), mem_heap_hi());
-		malloc_error(tracenum, opnum, msg);
-		return 0;
-	}
-
-	/* The payload must not overlap any other payloads */
-	for (p = *ranges; p != NULL; p = p->next)
-	{
-		if ((lo >= p->lo && lo <= p->hi) ||
-			(hi >= p->lo && hi <= p->hi))
-		{
-			sprintf(msg, "Payload (%p:%p) overlaps another payload (%p:%p)\n",
-					lo, hi, p->lo, p->hi);
-			malloc_error(tracenum, opnum, msg);
-			return 0;
-		}
-	}
-
-	/*
-	 * Everything looks OK, so remember the extent of this block
-	 * by creating a range struct and adding it the range list.
-	 */
-	if ((p = (range_t *)malloc(sizeof(range_t))) == NULL)
-		unix_error("malloc error in add_range");
-	p->next = *ranges;
-	p->lo = lo;
-	p->hi = hi;
-	*ranges = p;
-	return 1;
-}
-
-/*
- * remove_range - Free the range record of block whose payload starts at lo
- */
-static void remove_range(range_t **ranges, char *lo)
-{
-	range_t *p;
-	range_t **prevpp = ranges;
-	int size;
-
-	for (p = *ranges; p != NULL; p = p->next)
-	{
-		if (p->lo == lo)
-		{
-			*prevpp = p->next;
-			size = p->hi - p->lo + 1;
-			free(p);
-			break;
-		}
-		prevpp = &(p->next);
-	}
-}
-
-/*
- * clear_ranges - free all of the range records for a trace
- */
-static void clear_ranges(range_t **ranges)
-{
-	range_t *p;
-	range_t *pnext;
-
-	for (p = *ranges; p != NULL; p = pnext)
-	{
-		pnext = p->next;
-		free(p);
-	}
-	*ranges = NULL;
-}
-
-/**********************************************
- * The following routines manipulate tracefiles
- *********************************************/
-
-/*
- * read_trace - read a trace file and store it in memory
- */
-static trace_t *read_trace(char *tracedir, char *filename)
-{
-	FILE *tracefile;
-	trace_t *trace;
-	char type[MAXLINE];
-	char path[MAXLINE];
-	unsigned index, size;
-	unsigned max_index = 0;
-	unsigned op_index;
-
-	if (verbose > 1)
-		printf("Reading tracefile: %s\n", filename);
-
-	/* Allocate the trace record */
-	if ((trace = (trace_t *)malloc(sizeof(trace_t))) == NULL)
-		unix_error("malloc 1 failed in read_trance");
-
-	/* Read the trace file header */
-	strcpy(path, tracedir);
-	strcat(path, filename);
-	if ((tracefile = fopen(path, "r")) == NULL)
-	{
-		sprintf(msg, "Could not open %s in read_trace", path);
-		unix_error(msg);
-	}
-	fscanf(tracefile, "%d", &(trace->sugg_heapsize)); /* not used */
-	fscanf(tracefile, "%d", &(trace->num_ids));
-	fscanf(tracefile, "%d", &(trace->num_ops));
-	fscanf(tracefile, "%d", &(trace->weight)); /* not used */
-
-	/* We'll store each request line in the trace in this array */
-	if ((trace->ops =
-			 (traceop_t *)malloc(trace->num_ops * sizeof(traceop_t))) == NULL)
-		unix_error("malloc 2 failed in read_trace");
-
-	/* We'll keep an array of pointers to the allocated blocks here... */
-	if ((trace->blocks =
-			 (char **)malloc(trace->num_ids * sizeof(char *))) == NULL)
-		unix_error("malloc 3 failed in read_trace");
-
-	/* ... along with the corresponding byte sizes of each block */
-	if ((trace->block_sizes =
-			 (size_t *)malloc(trace->num_ids * sizeof(size_t))) == NULL)
-		unix_error("malloc 4 failed in read_trace");
-
-	/* read every request line in the trace file */
-	index = 0;
-	op_index = 0;
-	while (fscanf(tracefile, "%s", type) != EOF)
-	{
-		switch (type[0])
-		{
-		case 'a':
-			fscanf(tracefile, "%u %u", &index, &size);
-			trace->ops[op_index].type = ALLOC;
-			trace->ops[op_index].index = index;
-			trace->ops[op_index].size = size;
-			max_index = (index > max_index) ? index : max_index;
-			break;
-		case 'r':
-			fscanf(tracefile, "%u %u", &index, &size);
-			trace->ops[op_index].type = REALLOC;
-			trace->ops[op_index].index = index;
-			trace->ops[op_index].size = size;
-			max_index = (index > max_index) ? index : max_index;
-			break;
-		case 'f':
-			fscanf(tracefile, "%ud", &index);
-			trace->ops[op_index].type = FREE;
-			trace->ops[op_index].index = index;
-			break;
-		default:
-			printf("Bogus type character (%c) in tracefile %s\n",
-				   type[0], path);
-			exit(1);
-		}
-		op_index++;
-	}
-	fclose(tracefile);
-	assert(max_index == trace->num_ids - 1);
-	assert(trace->num_ops == op_index);
-
-	return trace;
-}
-
-/*
- * free_trace - Free the trace record and the three arrays it points
- *              to, all of which were allocated in read_trace().
- */
-void free_trace(trace_t *trace)
-{
-	free(trace->ops); /* free the three arrays... */
-	free(trace->blocks);
-	free(trace->block_sizes);
-	free(trace); /* and the trace record itself... */
-}
-
-/**********************************************************************
- * The following functions evaluate the correctness, space utilization,
- * and throughput of the libc and mm malloc packages.
- **********************************************************************/
-
-/*
- * eval_mm_valid - Check the mm malloc package for correctness
- */
-static int eval_mm_valid(trace_t *trace, int tracenum, range_t **ranges)
-{
-	int i, j;
-	int index;
-	int size;
-	int oldsize;
-	char *newp;
-	char *oldp;
-	char *p;
-
-	/* Reset the heap and free any records in the range list */
-	mem_reset_brk();
-	clear_ranges(ranges);
-
-	/* Call the mm package's init function */
-	if (mm_init() < 0)
-	{
-		malloc_error(tracenum, 0, "mm_init failed.");
-		return 0;
-	}
-
-	/* Interpret each operation in the trace in order */
-	for (i = 0; i < trace->num_ops; i++)
-	{
-		index = trace->ops[i].index;
-		size = trace->ops[i].size;
-
-		switch (trace->ops[i].type)
-		{
-
-		case ALLOC: /* mm_malloc */
-
-			/* Call the student's malloc */
-			if ((p = mm_malloc(size)) == NULL)
-			{
-				malloc_error(tracenum, i, "mm_malloc failed.");
-				return 0;
-			}
-
-			/*
-			 * Test the range of the new block for correctness and add it
-			 * to the range list if OK. The block must be  be aligned properly,
-			 * and must not overlap any currently allocated block.
-			 */
-			if (add_range(ranges, p, size, tracenum, i) == 0)
-				return 0;
-
-			/* ADDED: cgw
-			 * fill range with low byte of index.  This will be used later
-			 * if we realloc the block and wish to make sure that the old
-			 * data was copied to the new block
-			 */
-			memset(p, index & 0xFF, size);
-
-			/* Remember region */
-			trace->blocks[index] = p;
-			trace->block_sizes[index] = size;
-			break;
-
-		case REALLOC: /* mm_realloc */
-
-			/* Call the student's realloc */
-			oldp = trace->blocks[index];
-			if ((newp = mm_realloc(oldp, size)) == NULL)
-			{
-				malloc_error(tracenum, i, "mm_realloc failed.");
-				return 0;
-			}
-
-			/* Remove the old region from the range list */
-			remove_range(ranges, oldp);
-
-			/* Check new block for correctness and add it to range list */
-			if (add_range(ranges, newp, size, tracenum, i) == 0)
-				return 0;
-
-			/* ADDED: cgw
-			 * Make sure that the new block contains the data from the old
-			 * block and then fill in the new block with the low order byte
-			 * of the new index
-			 */
-			oldsize = trace->block_sizes[index];
-			if (size < oldsize)
-				oldsize = size;
-			for (j = 0; j < oldsize; j++)
-			{
-				if (newp[j] != (index & 0xFF))
-				{
-					malloc_error(tracenum, i, "mm_realloc did not preserve the "
-											  "data from old block");
-					return 0;
-				}
-			}
-			memset(newp, index & 0xFF, size);
-
-			/* Remember region */
-			trace->blocks[index] = newp;
-			trace->block_sizes[index] = size;
-			break;
-
-		case FREE: /* mm_free */
-
-			/* Remove region from list and call student's free function */
-			p = trace->blocks[index];
-			remove_range(ranges, p);
-			mm_free(p);
-			break;
-
-		default:
-			app_error("Nonexistent request type in eval_mm_valid");
-		}
-	}
-
-	/* As far as we know, this is a valid malloc package */
-	return 1;
-}
-
-/*
- * eval_mm_util - Evaluate the space utilization of the student's package
- *   The idea is to remember the high water mark "hwm" of the heap for
- *   an optimal allocator, i.e., no gaps and no internal fragmentation.
- *   Utilization is the ratio hwm/heapsize, where heapsize is the
- *   size of the heap in bytes after running the student's malloc
- *   package on the trace. Note that our implementation of mem_sbrk()
- *   doesn't allow the students to decrement the brk pointer, so brk
- *   is always the high water mark of the heap.
- *
- */
-static double eval_mm_util(trace_t *trace, int tracenum, range_t **ranges)
-{
-	int i;
-	int index;
-	int size, newsize, oldsize;
-	int max_total_size = 0;
-	int total_size = 0;
-	char *p;
-	char *newp, *oldp;
-
-	/* initialize the heap and the mm malloc package */
-	mem_reset_brk();
-	if (mm_init() < 0)
-		app_error("mm_init failed in eval_mm_util");
-
-	for (i = 0; i < trace->num_ops; i++)
-	{
-		switch (trace->ops[i].type)
-		{
-
-		case ALLOC: /* mm_alloc */
-			index = trace->ops[i].index;
-			size = trace->ops[i].size;
-
-			if ((p = mm_malloc(size)) == NULL)
-				app_error("mm_malloc failed in eval_mm_util");
-
-			/* Remember region and size */
-			trace->blocks[index] = p;
-			trace->block_sizes[index] = size;
-
-			/* Keep track of current total size
-			 * of all allocated blocks */
-			total_size += size;
-
-			/* Update statistics */
-			max_total_size = (total_size > max_total_size) ? total_size : max_total_size;
-			break;
-
-		case REALLOC: /* mm_realloc */
-			index = trace->ops[i].index;
-			newsize = trace->ops[i].size;
-			oldsize = trace->block_sizes[index];
-
-			oldp = trace->blocks[index];
-			if ((newp = mm_realloc(oldp, newsize)) == NULL)
-				app_error("mm_realloc failed in eval_mm_util");
-
-			/* Remember region and size */
-			trace->blocks[index] = newp;
-			trace->block_sizes[index] = newsize;
-
-			/* Keep track of current total size
-			 * of all allocated blocks */
-			total_size += (newsize - oldsize);
-
-			/* Update statistics */
-			max_total_size = (total_size > max_total_size) ? total_size : max_total_size;
-			break;
-
-		case FREE: /* mm_free */
-			index = trace->ops[i].index;
-			size = trace->block_sizes[index];
-			p = trace->blocks[index];
-
-			mm_free(p);
-
-			/* Keep track of current total size
-			 * of all allocated blocks */
-			total_size -= size;
-
-			break;
-
-		default:
-			app_error("Nonexistent request type in eval_mm_util");
-		}
-	}
-
-	return ((double)max_total_size / (double)mem_heapsize());
-}
-
-/*
- * eval_mm_speed - This is the function that is used by fcyc()
- *    to measure the running time of the mm malloc package.
- */
-static void eval_mm_speed(void *ptr)
-{
-	int i, index, size, newsize;
-	char *p, *newp, *oldp, *block;
-	trace_t *trace = ((speed_t *)ptr)->trace;
-
-	/* Reset the heap and initialize the mm package */
-	mem_reset_brk();
-	if (mm_init() < 0)
-		app_error("mm_init failed in eval_mm_speed");
-
-	/* Interpret each trace request */
-	for (i = 0; i < trace->num_ops; i++)
-		switch (trace->ops[i].type)
-		{
-
-		case ALLOC: /* mm_malloc */
-			index = trace->ops[i].index;
-			size = trace->ops[i].size;
-			if ((p = mm_malloc(size)) == NULL)
-				app_error("mm_malloc error in eval_mm_speed");
-			trace->blocks[index] = p;
-			break;
-
-		case REALLOC: /* mm_realloc */
-			index = trace->ops[i].index;
-			newsize = trace->ops[i].size;
-			oldp = trace->blocks[index];
-			if ((newp = mm_realloc(oldp, newsize)) == NULL)
-				app_error("mm_realloc error in eval_mm_speed");
-			trace->blocks[index] = newp;
-			break;
-
-		case FREE: /* mm_free */
-			index = trace->ops[i].index;
-			block = trace->blocks[index];
-			mm_free(block);
-			break;
-
-		default:
-			app_error("Nonexistent request type in eval_mm_valid");
-		}
-}
-
-/*
- * eval_libc_valid - We run this function to make sure that the
- *    libc malloc can run to completion on the set of traces.
- *    We'll be conservative and terminate if any libc malloc call fails.
- *
- */
-static int eval_libc_valid(trace_t *trace, int tracenum)
-{
-	int i, newsize;
-	char *p, *newp, *oldp;
-
-	for (i = 0; i < trace->num_ops; i++)
-	{
-		switch (trace->ops[i].type)
-		{
-
-		case ALLOC: /* malloc */
-			if ((p = malloc(trace->ops[i].size)) == NULL)
-			{
-				malloc_error(tracenum, i, "libc malloc failed");
-				unix_error("System message");
-			}
-			trace->blocks[trace->ops[i].index] = p;
-			break;
-
-		case REALLOC: /* realloc */
-			newsize = trace->ops[i].size;
-			oldp = trace->blocks[trace->ops[i].index];
-			if ((newp = realloc(oldp, newsize)) == NULL)
-			{
-				malloc_error(tracenum, i, "libc realloc failed");
-				unix_error("System message");
-			}
-			trace->blocks[trace->ops[i].index] = newp;
-			break;
-
-		case FREE: /* free */
-			free(trace->blocks[trace->ops[i].index]);
-			break;
-
-		default:
-			app_error("invalid operation type  in eval_libc_valid");
-		}
-	}
-
-	return 1;
-}
-
-/*
- * eval_libc_speed - This is the function that is used by fcyc() to
- *    measure the running time of the libc malloc package on the set
- *    of traces.
- */
-static void eval_libc_speed(void *ptr)
-{
-	int i;
-	int index, size, newsize;
-	char *p, *newp, *oldp, *block;
-	trace_t *trace = ((speed_t *)ptr)->trace;
-
-	for (i = 0; i < trace->num_ops; i++)
-	{
-		switch (trace->ops[i].type)
-		{
-		case ALLOC: /* malloc */
-			index = trace->ops[i].index;
-			size = trace->ops[i].size;
-			if ((p = malloc(size)) == NULL)
-				unix_error("malloc failed in eval_libc_speed");
-			trace->blocks[index] = p;
-			break;
-
-		case REALLOC: /* realloc */
-			index = trace->ops[i].index;
-			newsize = trace->ops[i].size;
-			oldp = trace->blocks[index];
-			if ((newp = realloc(oldp, newsize)) == NULL)
-				unix_error("realloc failed in eval_libc_speed\n");
-
-			trace->blocks[index] = newp;
-			break;
-
-		case FREE: /* free */
-			index = trace->ops[i].index;
-			block = trace->blocks[index];
-			free(block);
-			break;
-		}
-	}
-}
-
-/*************************************
- * Some miscellaneous helper routines
- ************************************/
-
-/*
- * printresults - prints a performance summary for some malloc package
- */
-static void printresults(int n, stats_t *stats)
-{
-	int i;
-	double secs = 0;
-	double ops = 0;
-	double util = 0;
-
-	/* Print the individual results for each trace */
-	printf("%5s%7s %5s%8s%10s%6s\n",
-		   "trace", " valid", "util", "ops", "secs", "Kops");
-	for (i = 0; i < n; i++)
-	{
-		if (stats[i].valid)
-		{
-			printf("%2d%10s%5.0f%%%8.0f%10.6f%6.0f\n",
-				   i,
-				   "yes",
-				   stats[i].util * 100.0,
-				   stats[i].ops,
-				   stats[i].secs,
-				   (stats[i].ops / 1e3) / stats[i].secs);
-			secs += stats[i].secs;
-			ops += stats[i].ops;
-			util += stats[i].util;
-		}
-		else
-		{
-			printf("%2d%10s%6s%8s%10s%6s\n",
-				   i,
-				   "no",
-				   "-",
-				   "-",
-				   "-",
-				   "-");
-		}
-	}
-
-	/* Print the aggregate results for the set of traces */
-	if (errors == 0)
-	{
-		printf("%12s%5.0f%%%8.0f%10.6f%6.0f\n",
-			   "Total       ",
-			   (util / n) * 100.0,
-			   ops,
-			   secs,
-			   (ops / 1e3) / secs);
-	}
-	else
-	{
-		printf("%12s%6s%8s%10s%6s\n",
-			   "Total       ",
-			   "-",
-			   "-",
-			   "-",
-			   "-");
-	}
-}
-
-/*
- * app_error - Report an arbitrary application error
- */
-void app_error(char *msg)
-{
-	printf("%s\n", msg);
-	exit(1);
-}
-
-/*
- * unix_error - Report a Unix-style error
- */
-void unix_error(char *msg)
-{
-	printf("%s: %s\n", msg, strerror(errno));
-	exit(1);
-}
-
-/*
- * malloc_error - Report an error returned by the mm_malloc package
- */
-void malloc_error(int tracenum, int opnum, char *msg)
-{
-	errors++;
-	printf("ERROR [trace %d, line %d]: %s\n", tracenum, LINENUM(opnum), msg);
-}
-
-/*
- * usage - Explain the command line arguments
- */
-static void usage(void)
-{
-	fprintf(stderr, "Usage: mdriver [-hvVal] [-f <file>] [-t <dir>]\n");
-	fprintf(stderr, "Options\n");
-	fprintf(stderr, "\t-a         Don't check the team structure.\n");
-	fprintf(stderr, "\t-f <file>  Use <file> as the trace file.\n");
-	fprintf(stderr, "\t-g         Generate summary info for autograder.\n");
-	fprintf(stderr, "\t-h         Print this message.\n");
-	fprintf(stderr, "\t-l         Run libc malloc as well.\n");
-	fprintf(stderr, "\t-t <dir>   Directory to find default traces.\n");
-	fprintf(stderr, "\t-v         Print per-trace performance breakdowns.\n");
-	fprintf(stderr, "\t-V         Print additional debug info.\n");
-}
+/*
+ * mdriver.c - CS:APP Malloc Lab Driver
+ *
+ * Uses a collection of trace files to tests a malloc/free/realloc
+ * implementation in mm.c.
+ *
+ * Copyright (c) 2002, R. Bryant and D. O'Hallaron, All rights reserved.
+ * May not be used, modified, or copied without permission.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <assert.h>
+#include <float.h>
+#include <time.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+extern char *optarg; // Added declaration for optarg
+
+#include "mm.h"
+#include "memlib.h"
+#include "fsecs.h"
+#include "clock.h"
+#include "hist.h"
+#include "trace.h"
+#include "stream.h"
+#include "workload.h"
+#include "bench.h"
+#include "perfctr.h"
+#include "backend.h"
+#include "region.h"
+#include "prof.h"
+#include "config.h"
+
+/**********************
+ * Constants and macros
+ **********************/
+
+/* Misc */
+#define MAXLINE 1024	   /* max string size */
+#define HDRLINES 4		   /* number of header lines in a trace file */
+#define LINENUM(i) (i + 5) /* cnvt trace request nums to linenums (origin 1) */
+
+/* Multi-threaded replay (-j) */
+#define MAXTHREADS 64	/* max number of replay threads */
+#define MT_REPS 3		/* each -j measurement is the best of MT_REPS runs */
+#define XFREE_BATCH 64	/* cross-thread frees are handed over in batches */
+#define XFREE_QUEUE 4	/* batches a thread may have waiting for its neighbour */
+#define TS_SECS(ts) ((ts).tv_sec + (ts).tv_nsec / 1e9) /* struct timespec -> secs */
+
+/* Range tree nodes are allocated from the system this many at a time */
+#define RANGE_CHUNK 4096
+
+/* Per-operation latency (-L) */
+#define NUM_OPTYPES 3	/* histograms per trace: one for each request type */
+
+/* Batched requests (-n) */
+#define BATCH_MAX 256	/* longest run of requests made as one batch call */
+
+/* Streaming replay (-S) */
+#define STREAM_DENSE_IDS (1 << 22) /* more ids than this: keep blocks in a hash map */
+
+/* Returns true if p is align-byte aligned */
+#define IS_ALIGNED(p, align) ((((uintptr_t)(p)) % (align)) == 0)
+
+/******************************
+ * The key compound data types
+ *****************************/
+
+/* Records the extent of each block's payload, as a node of the range tree */
+typedef struct range_t
+{
+	char *lo;			   /* low payload address */
+	char *hi;			   /* high payload address */
+	struct range_t *left;  /* payloads below lo ... */
+	struct range_t *right; /* ... and above hi (in the pool: next free node) */
+} range_t;
+
+/* A single trace operation (traceop_t) is defined in trace.h */
+
+/* A live block of a streamed trace, by trace id */
+typedef struct
+{
+	uint32_t id; /* trace id */
+	char *p;	 /* block returned by malloc/realloc (NULL: empty slot) */
+	size_t size; /* its payload size */
+} blockent_t;
+
+/* Open-addressing (linear probing) hash map of the live blocks */
+typedef struct
+{
+	blockent_t *tab; /* cap slots, cap a power of two */
+	size_t cap;
+	size_t count;	 /* slots in use */
+} blockmap_t;
+
+/* Holds the information for one trace file*/
+typedef struct
+{
+	int sugg_heapsize;	 /* suggested heap size (unused) */
+	int num_ids;		 /* number of alloc/realloc ids */
+	long num_ops;		 /* number of distinct requests */
+	int weight;			 /* weight for this trace (unused) */
+	traceop_t *ops;		 /* array of requests */
+	char **blocks;		 /* array of ptrs returned by malloc/realloc... */
+	size_t *block_sizes; /* ... and a corresponding array of payload sizes */
+	void *map;			 /* binary trace: the mapped file ops points into */
+	size_t map_len;		 /* (map is NULL for a parsed .rep trace) */
+	stream_t *stream;	 /* streamed trace (-S): read a chunk at a time */
+	blockmap_t *live;	 /* ... keeping its blocks here if it has many ids */
+	long pending;		 /* trace in memory: ops next_chunk has yet to hand out */
+} trace_t;
+
+/*
+ * Holds the params to the xxx_speed functions, which are timed by fcyc.
+ * This struct is necessary because fcyc accepts only a pointer array
+ * as input.
+ */
+typedef struct
+{
+	trace_t *trace;
+	range_t *ranges;
+	size_t align;	/* eval_mm_sized_speed: mm_aligned_alloc alignment (0: mm_malloc) */
+} speed_t;
+
+/* Summarizes the important stats for some malloc function on some trace */
+typedef struct
+{
+	/* defined for both libc malloc and student malloc package (mm.c) */
+	double ops;	 /* number of ops (malloc/free/realloc) in the trace */
+	int valid;	 /* was the trace processed correctly by the allocator? */
+	double secs; /* number of secs needed to run the trace */
+
+	/* defined only for the student malloc package */
+	double util; /* space utilization for this trace (always 0 for libc) */
+	size_t peak; /* largest heap + mapping size during the trace (bytes) */
+	size_t end;	 /* heap + mapping size once the trace has finished (bytes) */
+	size_t commit_peak; /* most memory memlib had committed (bytes) */
+	size_t commit_end;	/* memory still committed at the end (bytes) */
+	size_t huge;		/* heap bytes on huge pages near the commit peak */
+	perf_counts_t perf; /* hardware events of one throughput run (-p) */
+
+	/* Note: secs, util, peak and end are only defined if valid is true */
+} stats_t;
+
+/* Summarizes a multi-threaded (-j) replay of one trace */
+typedef struct
+{
+	int valid;		  /* did every thread finish without an allocator failure? */
+	int nthreads;	  /* number of replay threads */
+	double ops;		  /* total number of ops over all threads */
+	double secs;	  /* wall-clock secs for all threads to finish */
+	double base_secs; /* wall-clock secs for the same work on 1 thread */
+	double min_nsop;  /* fastest thread: average nsecs per op */
+	double avg_nsop;  /* mean over the threads */
+	double max_nsop;  /* slowest thread */
+} mt_stats_t;
+
+/* Per-operation latency of one trace, in cycles, by request type (-L) */
+typedef struct
+{
+	int valid;				   /* was the latency run made? */
+	hist_t ops[NUM_OPTYPES];   /* indexed by traceop_t type */
+} lat_stats_t;
+
+/* Replay of one trace with batch calls (-n) */
+typedef struct
+{
+	int valid;		/* did the batched replay check out? */
+	long batched;	/* requests made as part of a batch of two or more */
+	long batches;	/* number of those batch calls */
+	double secs;	/* secs needed for the batched replay */
+} batch_stats_t;
+
+/* Replay of one trace with sized frees and aligned mallocs (-z) */
+typedef struct
+{
+	int valid;			/* did the aligned replay check out? */
+	size_t peak;		/* largest heap of the aligned replay (bytes) */
+	double sized_secs;	/* secs with mm_malloc and mm_free_sized */
+	double aligned_secs; /* secs with mm_aligned_alloc and mm_free_sized */
+} align_stats_t;
+
+/* Request-scoped replay of one trace's request sizes (-r) */
+typedef struct
+{
+	int valid;			/* did the region run check out? */
+	long objs;			/* objects: one per malloc or realloc of the trace */
+	double free_secs;	/* secs with mm_malloc and an mm_free per object */
+	double region_secs;	/* secs with region_alloc and a region_reset per request */
+	size_t free_peak;	/* largest heap of each (bytes) */
+	size_t region_peak;
+} region_stats_t;
+
+/* Heap profile of one trace at its peak (-H) */
+typedef struct
+{
+	int valid;			/* did the profiled replay run? */
+	size_t samples;		/* allocations sampled up to the peak */
+	size_t live;		/* of those, blocks live at the peak */
+	size_t peak;		/* payload bytes live at the peak */
+	double est;			/* the live bytes estimated from the samples */
+} prof_stats_t;
+
+/* The params to the -r speed functions (see speed_t) */
+typedef struct
+{
+	size_t *sizes;		/* the trace's request sizes, in order */
+	long n;
+	void **objs;		/* the objects of one request */
+} region_speed_t;
+
+/* Results of one backend over all the traces (-A) */
+typedef struct
+{
+	const mm_backend_t *be;	/* NULL if it couldn't be loaded */
+	stats_t *traces;		/* valid, util, secs and peak of each trace */
+	hist_t lat;				/* latency of every request of the valid traces */
+} backend_stats_t;
+
+/* A batch of blocks freed by one thread on behalf of another (-x) */
+typedef struct xfree_batch_t
+{
+	int n;
+	char *blocks[XFREE_BATCH];
+	struct xfree_batch_t *next;
+} xfree_batch_t;
+
+/* Per-thread state for the multi-threaded replay */
+typedef struct
+{
+	trace_t *trace;			/* the shared (read-only) trace */
+	int id;					/* thread number, 0..nthreads-1 */
+	int nthreads;
+	int shard;				/* replay only ids with id % nthreads == this id */
+	char **blocks;			/* this thread's block pointers, by trace id */
+	double ops;				/* ops replayed by this thread */
+	double secs;			/* time this thread spent replaying */
+	struct timespec start;	/* when this thread started replaying ... */
+	struct timespec end;	/* ... and when it had performed all its frees */
+	int failed;				/* set if the allocator returned NULL */
+	xfree_batch_t *out;		/* frees being collected for the next thread */
+	pthread_mutex_t lock;	/* protects inbox (also read without it, atomically) */
+	xfree_batch_t *inbox;	/* frees handed to this thread by its neighbour */
+	int queued;				/* batches in the inbox (atomic) */
+} mt_thread_t;
+
+/********************
+ * Global variables
+ *******************/
+int verbose = 0;	   /* global flag for verbose output */
+static int errors = 0; /* number of errs found when running student malloc */
+char msg[MAXLINE];	   /* for whenever we need to compose an error message */
+
+/* Directory where default tracefiles are found */
+static char tracedir[MAXLINE] = TRACEDIR;
+
+/* Multi-threaded replay options (-j, -s, -x) */
+static int mt_threads = 0;		/* number of replay threads (0 = no -j run) */
+static int mt_shard = 0;		/* shard one trace across threads instead of copying it */
+static int mt_xfree = 0;		/* hand frees to the next thread */
+static pthread_barrier_t mt_barrier;	/* start line: the threads and run_mm_mt */
+static int mt_sending;				/* -x: threads that may still send frees */
+
+/* Per-operation latency options (-L, -c) */
+static int lat_run = 0;				/* time every request (set by -L) */
+static char *lat_csvfile = NULL;	/* also write the percentiles here (-c) */
+static char *optype_names[NUM_OPTYPES] = {"malloc", "free", "realloc"};
+
+/* Batched requests (-n) */
+static int batch_run = 0;		/* also replay with mm_malloc_batch/mm_free_batch */
+
+/* Sized frees and aligned mallocs (-z) */
+static size_t align_size = 0;	/* mm_aligned_alloc alignment (0 = no aligned run) */
+
+/* Request-scoped memory (-r) */
+static int region_objs = 0;		/* objects per request (0 = no region run) */
+
+/* Heap profiles (-H, -I) */
+static char *prof_file = NULL;	/* write the profile of trace n to <prof_file>.<n> */
+static size_t prof_rate = 0;	/* mean bytes between samples (0 = PROF_RATE) */
+
+/* Heap statistics time series (-m, -M) */
+static int stream_run = 0;					/* stream the traces from disk (-S) */
+static int stats_interval = 0;				/* sample mm_stats every this many ops */
+static char *stats_file = "mm_stats.csv";	/* where the samples go */
+
+/* Heap consistency checking options (-C, -K) */
+static int check_level = -1;				/* mm_check level (-1 = never call it) */
+static long check_every = 1;				/* call mm_check every this many ops */
+
+/* Benchmark mode (-b, -w, -P, -B, -R, -T) */
+static int bench_samples = 0;				/* timed runs per trace (0 = no benchmark) */
+static int bench_warmup = 2;				/* untimed runs before them */
+static int bench_cpu = -1;					/* CPU to pin to (-1: the one we start on) */
+static char *bench_save_file = NULL;		/* write the results here as a baseline */
+static char *bench_base_file = NULL;		/* check the results against this baseline */
+static double bench_threshold = 0.05;		/* regression threshold (fraction) */
+static int bench_opts = 0;					/* -w or -T given */
+
+/* Hardware event counters (-p) */
+static int perf_run = 0;		/* count events around one more throughput run */
+static perf_ctrs_t perf_ctrs;
+
+/* The allocator the eval_mm_* routines call, and the ones to compare (-A) */
+static const mm_backend_t *be = NULL;
+static char *backend_names = NULL;
+
+/* Huge page coverage seen by the last eval_mm_util run */
+static size_t util_huge = 0;
+
+/* The filenames of the default tracefiles */
+static char *default_tracefiles[] = {
+	DEFAULT_TRACEFILES, NULL};
+
+/*********************
+ * Function prototypes
+ *********************/
+
+/* these functions manipulate the range tree */
+static int add_range(range_t **ranges, char *lo, size_t size, size_t align,
+					 int tracenum, long opnum);
+static void remove_range(range_t **ranges, char *lo);
+static void clear_ranges(range_t **ranges);
+
+/* Remember the block for each trace id */
+static char *get_block(trace_t *trace, unsigned index, size_t *size);
+static void set_block(trace_t *trace, unsigned index, char *p, size_t size);
+static void drop_block(trace_t *trace, unsigned index);
+
+/* These functions read, allocate, and free storage for traces */
+static trace_t *read_trace(char *tracedir, char *filename);
+static int map_trace(trace_t *trace, char *path);
+static void stream_trace(trace_t *trace, char *path);
+static void gen_trace(trace_t *trace, char *spec);
+static void free_trace(trace_t *trace);
+static void rewind_trace(trace_t *trace);
+static size_t next_chunk(trace_t *trace, traceop_t **ops);
+
+/* Routines for evaluating the correctness and speed of libc malloc */
+static int eval_libc_valid(trace_t *trace, int tracenum);
+static void eval_libc_speed(void *ptr);
+
+/* Routines for evaluating correctnes, space utilization, and speed
+   of the student's malloc package in mm.c */
+static int eval_mm_valid(trace_t *trace, int tracenum, range_t **ranges);
+static double eval_mm_util(trace_t *trace, int tracenum, range_t **ranges);
+static void eval_mm_speed(void *ptr);
+
+/* Run a trace concurrently on several threads */
+static int eval_mm_mt(trace_t *trace, int nthreads, mt_stats_t *stats);
+static double run_mm_mt(trace_t *trace, int nthreads, mt_thread_t *threads);
+static void *mt_worker(void *arg);
+static void mt_drain_inbox(mt_thread_t *self);
+static void mt_send_free(mt_thread_t *self, mt_thread_t *dst, char *block);
+
+/* Time every request of a trace */
+static void eval_mm_latency(trace_t *trace, lat_stats_t *stats);
+
+/* Batched replay (-n) */
+static inline size_t batch_len(traceop_t *ops, size_t k, size_t n);
+static int eval_mm_batch(trace_t *trace, int tracenum, range_t **ranges, batch_stats_t *stats);
+static void eval_mm_batch_speed(void *ptr);
+
+/* Sized and aligned replay (-z) */
+static int eval_mm_aligned(trace_t *trace, int tracenum, range_t **ranges, align_stats_t *stats);
+static void eval_mm_sized_speed(void *ptr);
+
+/* Request-scoped replay (-r) */
+static int eval_region(trace_t *trace, int tracenum, range_t **ranges, region_stats_t *stats);
+static void eval_region_free_speed(void *ptr);
+static void eval_region_speed(void *ptr);
+
+/* Heap profile at the peak (-H) */
+static int eval_mm_prof(trace_t *trace, int tracenum, prof_stats_t *stats);
+
+/* Compare several allocator backends on the same traces */
+static int eval_backends(char **tracefiles, int n);
+
+/* Sample the allocator's heap statistics while replaying a trace */
+static void eval_mm_stats(trace_t *trace, int tracenum, FILE *fp);
+static void write_mm_stats(FILE *fp, int tracenum, int opnum, unsigned long *fit_calls,
+						   unsigned long *fit_examined);
+
+/* Various helper routines */
+static void printresults(int n, stats_t *stats);
+static void printresults_perf(perf_counts_t *c, double ops);
+static void printresults_mt(int n, mt_stats_t *stats);
+static void printresults_lat(int n, lat_stats_t *stats);
+static void printresults_batch(int n, stats_t *stats, batch_stats_t *batch);
+static void printresults_region(int n, region_stats_t *stats);
+static void printresults_align(int n, stats_t *stats, align_stats_t *align);
+static void printresults_prof(int n, prof_stats_t *stats);
+static void printresults_bench(int n, bench_result_t *r);
+static void printresults_backends(int nb, backend_stats_t *bs, int n);
+static void bench_config(char *buf, size_t len);
+#if MEM_BACKEND == MEM_MMAP
+static void printresults_mem(int n, stats_t *stats);
+#endif
+static void write_lat_csv(char *filename, int n, char **tracefiles, lat_stats_t *stats);
+static void usage(void);
+static void unix_error(char *msg);
+static void malloc_error(int tracenum, long opnum, char *msg);
+static void app_error(char *msg);
+
+/**************
+ * Main routine
+ **************/
+int main(int argc, char **argv)
+{
+	int i;
+	int c;
+	char **tracefiles = NULL;	/* null-terminated array of trace file names */
+	int num_tracefiles = 0;		/* the number of traces in that array */
+	trace_t *trace = NULL;		/* stores a single trace file in memory */
+	range_t *ranges = NULL;		/* keeps track of block extents for one trace */
+	stats_t *libc_stats = NULL; /* libc stats for each trace */
+	stats_t *mm_stats = NULL;	/* mm (i.e. student) stats for each trace */
+	mt_stats_t *mt_stats = NULL; /* multi-threaded stats for each trace (-j) */
+	lat_stats_t *lat_stats = NULL; /* latency histograms for each trace (-L) */
+	batch_stats_t *batch_stats = NULL; /* batched replay of each trace (-n) */
+	region_stats_t *region_stats = NULL; /* request-scoped replay of each trace (-r) */
+	align_stats_t *align_stats = NULL; /* sized and aligned replay of each trace (-z) */
+	prof_stats_t *prof_stats = NULL; /* heap profile of each trace (-H) */
+	FILE *stats_fp = NULL;		/* heap statistics time series (-m) */
+	bench_result_t *bench = NULL; /* benchmark results of the valid traces (-b) */
+	int num_bench = 0;
+	int regressions = 0;		/* traces slower or bigger than the baseline (-R) */
+	speed_t speed_params;		/* input parameters to the xx_speed routines */
+
+	int team_check = 1; /* If set, check team structure (reset by -a) */
+	int run_libc = 0;	/* If set, run libc malloc (set by -l) */
+	int autograder = 0; /* If set, emit summary info for autograder (-g) */
+
+	/* temporaries used to compute the performance index */
+	double secs, ops, util, avg_mm_util, avg_mm_throughput, p1, p2, perfindex;
+	int numcorrect;
+
+	/* The eval_mm_* routines call mm.c unless -A says otherwise */
+	be = backend_find("mm", msg, sizeof(msg));
+
+	/*
+	 * Read and interpret the command line arguments
+	 */
+	while ((c = getopt(argc, argv, "f:t:A:G:j:c:m:M:C:K:b:w:P:B:r:R:T:z:H:I:hvVgalnpsxLS")) != EOF)
+	{
+		printf("getopt returned: %d\n", c); // 디버깅용 출력 추가
+
+		switch (c)
+		{
+		case 'g': /* Generate summary info for the autograder */
+			autograder = 1;
+			break;
+		case 'f': /* Use one specific trace file only (relative to curr dir) */
+			num_tracefiles = 1;
+			if ((tracefiles = realloc(tracefiles, 2 * sizeof(char *))) == NULL)
+				unix_error("ERROR: realloc failed in main");
+			strcpy(tracedir, "./");
+			tracefiles[0] = strdup(optarg);
+			tracefiles[1] = NULL;
+			break;
+		case 'G': /* Add a trace generated from a workload spec (workload.h) */
+			if ((tracefiles = realloc(tracefiles, (num_tracefiles + 2) * sizeof(char *))) == NULL)
+				unix_error("ERROR: realloc failed in main");
+			if ((tracefiles[num_tracefiles] = malloc(strlen(WL_PREFIX) + strlen(optarg) + 1)) == NULL)
+				unix_error("ERROR: malloc failed in main");
+			strcpy(tracefiles[num_tracefiles], WL_PREFIX);
+			strcat(tracefiles[num_tracefiles], optarg);
+			tracefiles[++num_tracefiles] = NULL;
+			break;
+		case 't':					 /* Directory where the traces are located */
+			if (num_tracefiles == 1) /* ignore if -f already encountered */
+				break;
+			strcpy(tracedir, optarg);
+			if (tracedir[strlen(tracedir) - 1] != '/')
+				strcat(tracedir, "/"); /* path always ends with "/" */
+			break;
+		case 'A': /* Compare these allocator backends (backend.h) */
+			backend_names = strdup(optarg);
+			break;
+		case 'a': /* Don't check team structure */
+			team_check = 0;
+			break;
+		case 'l': /* Run libc malloc */
+			run_libc = 1;
+			break;
+		case 'j': /* Also replay each trace on this many threads */
+			mt_threads = atoi(optarg);
+			if (mt_threads < 1 || mt_threads > MAXTHREADS)
+			{
+				printf("ERROR: -j needs a number of threads from 1 to %d\n", MAXTHREADS);
+				exit(1);
+			}
+			break;
+		case 's': /* -j: shard the trace across the threads */
+			mt_shard = 1;
+			break;
+		case 'x': /* -j: free blocks on a different thread */
+			mt_xfree = 1;
+			break;
+		case 'n': /* Also replay with batch calls and compare the throughput */
+			batch_run = 1;
+			break;
+		case 'p': /* Count hardware events around the throughput run */
+			perf_run = 1;
+			break;
+		case 'S': /* Stream the traces instead of reading them into memory */
+			stream_run = 1;
+			break;
+		case 'L': /* Time each request and print latency percentiles */
+			lat_run = 1;
+			break;
+		case 'c': /* Write the latency percentiles to a CSV file (implies -L) */
+			lat_run = 1;
+			lat_csvfile = strdup(optarg);
+			break;
+		case 'm': /* Sample mm_stats every <n> ops */
+			if ((stats_interval = atoi(optarg)) <= 0)
+			{
+				printf("ERROR: -m needs a positive sampling interval\n");
+				exit(1);
+			}
+			break;
+		case 'M': /* File for the -m samples */
+			stats_file = strdup(optarg);
+			break;
+		case 'C': /* Set the mm_check level */
+			check_level = atoi(optarg);
+			if (check_level < 0 || check_level > 2)
+			{
+				printf("ERROR: -C needs a check level of 0, 1 or 2\n");
+				exit(1);
+			}
+			break;
+		case 'K': /* With -C, call mm_check every <n> ops */
+			if ((check_every = atol(optarg)) <= 0)
+			{
+				printf("ERROR: -K needs a positive check interval\n");
+				exit(1);
+			}
+			break;
+		case 'b': /* Benchmark: time each trace <n> times */
+			if ((bench_samples = atoi(optarg)) <= 0)
+			{
+				printf("ERROR: -b needs a positive number of runs\n");
+				exit(1);
+			}
+			break;
+		case 'w': /* -b: untimed warmup runs */
+			if ((bench_warmup = atoi(optarg)) < 0)
+			{
+				printf("ERROR: -w needs a number of warmup runs of 0 or more\n");
+				exit(1);
+			}
+			bench_opts |= 1;
+			break;
+		case 'P': /* -b: pin to this CPU */
+			bench_cpu = atoi(optarg);
+			break;
+		case 'B': /* -b: save the results as a baseline */
+			bench_save_file = strdup(optarg);
+			break;
+		case 'r': /* Request-scoped replay: <n> objects per request */
+			region_objs = atoi(optarg);
+			if (region_objs < 1)
+			{
+				printf("ERROR: -r needs a positive number of objects\n");
+				exit(1);
+			}
+			break;
+		case 'R': /* -b: compare with a baseline, failing on a regression */
+			bench_base_file = strdup(optarg);
+			break;
+		case 'T': /* -R: regression threshold in percent */
+			if ((bench_threshold = atof(optarg) / 100) <= 0)
+			{
+				printf("ERROR: -T needs a positive threshold\n");
+				exit(1);
+			}
+			bench_opts |= 2;
+			break;
+		case 'z': /* Also replay with mm_aligned_alloc(<align>) and mm_free_sized */
+			align_size = strtoul(optarg, NULL, 0);
+			if (align_size == 0 || (align_size & (align_size - 1)) != 0)
+			{
+				printf("ERROR: -z needs a power of two alignment\n");
+				exit(1);
+			}
+			break;
+		case 'H': /* Write a heap profile of each trace at its peak */
+			prof_file = strdup(optarg);
+			break;
+		case 'I': /* -H: mean bytes between samples */
+			if ((prof_rate = strtoul(optarg, NULL, 0)) == 0)
+			{
+				printf("ERROR: -I needs a positive number of bytes\n");
+				exit(1);
+			}
+			break;
+		case 'v': /* Print per-trace performance breakdown */
+			verbose = 1;
+			break;
+		case 'V': /* Be more verbose than -v */
+			verbose = 2;
+			break;
+		case 'h': /* Print this message */
+			usage();
+			exit(0);
+		default:
+			usage();
+			exit(1);
+		}
+	}
+
+	if (mt_threads > 1 && !MM_THREADS)
+	{
+		printf("ERROR: -j %d needs an allocator built with MM_THREADS=1 "
+			   "(make MMFLAGS=-DMM_THREADS=1)\n", mt_threads);
+		exit(1);
+	}
+	if (prof_file && !MM_PROFILE)
+	{
+		printf("ERROR: -H needs an allocator built with MM_PROFILE=1 "
+			   "(make MMFLAGS=-DMM_PROFILE=1)\n");
+		exit(1);
+	}
+	if ((mt_shard || mt_xfree) && mt_threads == 0)
+	{
+		printf("ERROR: -s and -x only apply to a multi-threaded run (-j)\n");
+		exit(1);
+	}
+	if (check_every != 1 && check_level < 0)
+	{
+		printf("ERROR: -K only applies with a check level (-C)\n");
+		exit(1);
+	}
+	if (bench_samples && mt_threads)
+	{
+		printf("ERROR: -b pins the driver to one CPU, so it can't be combined with -j\n");
+		exit(1);
+	}
+	if (!bench_samples && (bench_save_file || bench_base_file || bench_cpu >= 0 || (bench_opts & 1)))
+	{
+		printf("ERROR: -w, -P, -B and -R only apply to a benchmark run (-b)\n");
+		exit(1);
+	}
+	if (!bench_base_file && (bench_opts & 2))
+	{
+		printf("ERROR: -T only applies to a comparison with a baseline (-R)\n");
+		exit(1);
+	}
+	if (stream_run && (run_libc || mt_threads || lat_run || stats_interval || batch_run))
+	{
+		printf("ERROR: -S streams only the correctness, utilization and "
+			   "throughput runs; it can't be combined with -l, -j, -L, -m or -n\n");
+		exit(1);
+	}
+	if (backend_names && (run_libc || mt_threads || lat_run || stats_interval || stream_run ||
+						  perf_run || bench_save_file || bench_base_file || batch_run || region_objs ||
+						  align_size || prof_file))
+	{
+		printf("ERROR: -A prints its own comparison; it can't be combined with "
+			   "-l, -j, -L, -m, -S, -p, -B, -R, -n, -r, -z or -H\n");
+		exit(1);
+	}
+	if (prof_rate && !prof_file)
+	{
+		printf("ERROR: -I only applies to a heap profile (-H)\n");
+		exit(1);
+	}
+
+	/*
+	 * Check and print team info
+	 */
+	if (team_check)
+	{
+		/* Students must fill in their team information */
+		if (!strcmp(team.teamname, ""))
+		{
+			printf("ERROR: Please provide the information about your team in mm.c.\n");
+			exit(1);
+		}
+		else
+			printf("Team Name:%s\n", team.teamname);
+		if ((*team.name1 == '\0') || (*team.id1 == '\0'))
+		{
+			printf("ERROR.  You must fill in all team member 1 fields!\n");
+			exit(1);
+		}
+		else
+			printf("Member 1 :%s:%s\n", team.name1, team.id1);
+
+		if (((*team.name2 != '\0') && (*team.id2 == '\0')) ||
+			((*team.name2 == '\0') && (*team.id2 != '\0')))
+		{
+			printf("ERROR.  You must fill in all or none of the team member 2 ID fields!\n");
+			exit(1);
+		}
+		else if (*team.name2 != '\0')
+			printf("Member 2 :%s:%s\n", team.name2, team.id2);
+	}
+
+	/*
+	 * If no -f command line arg, then use the entire set of tracefiles
+	 * defined in default_traces[]
+	 */
+	if (tracefiles == NULL)
+	{
+		tracefiles = default_tracefiles;
+		num_tracefiles = sizeof(default_tracefiles) / sizeof(char *) - 1;
+		printf("Using default tracefiles in %s\n", tracedir);
+	}
+
+	/* Initialize the timing package */
+	init_fsecs();
+
+	/* Compare the backends instead of grading mm.c */
+	if (backend_names)
+	{
+		mem_init();
+		exit(eval_backends(tracefiles, num_tracefiles) ? 0 : 1);
+	}
+
+	/*
+	 * Optionally run and evaluate the libc malloc package
+	 */
+	if (run_libc)
+	{
+		if (verbose > 1)
+			printf("\nTesting libc malloc\n");
+
+		/* Allocate libc stats array, with one stats_t struct per tracefile */
+		libc_stats = (stats_t *)calloc(num_tracefiles, sizeof(stats_t));
+		if (libc_stats == NULL)
+			unix_error("libc_stats calloc in main failed");
+
+		/* Evaluate the libc malloc package using the K-best scheme */
+		for (i = 0; i < num_tracefiles; i++)
+		{
+			trace = read_trace(tracedir, tracefiles[i]);
+			libc_stats[i].ops = trace->num_ops;
+			if (verbose > 1)
+				printf("Checking libc malloc for correctness, ");
+			libc_stats[i].valid = eval_libc_valid(trace, i);
+			if (libc_stats[i].valid)
+			{
+				speed_params.trace = trace;
+				if (verbose > 1)
+					printf("and performance.\n");
+				libc_stats[i].secs = fsecs(eval_libc_speed, &speed_params);
+			}
+			free_trace(trace);
+		}
+
+		/* Display the libc results in a compact table */
+		if (verbose)
+		{
+			printf("\nResults for libc malloc:\n");
+			printresults(num_tracefiles, libc_stats);
+		}
+	}
+
+	/*
+	 * Always run and evaluate the student's mm package
+	 */
+	if (verbose > 1)
+		printf("\nTesting mm malloc\n");
+
+	/* Allocate the mm stats array, with one stats_t struct per tracefile */
+	mm_stats = (stats_t *)calloc(num_tracefiles, sizeof(stats_t));
+	if (mm_stats == NULL)
+		unix_error("mm_stats calloc in main failed");
+	if (mt_threads)
+	{
+		mt_stats = (mt_stats_t *)calloc(num_tracefiles, sizeof(mt_stats_t));
+		if (mt_stats == NULL)
+			unix_error("mt_stats calloc in main failed");
+	}
+	if (stats_interval)
+	{
+		if ((stats_fp = fopen(stats_file, "w")) == NULL)
+			unix_error("Could not open mm_stats file");
+		fprintf(stats_fp, "trace,op,heap_size,committed,huge_bytes,live_blocks,live_bytes,free_blocks,"
+						  "free_bytes,largest_free,frag,slab_runs,slab_free_bytes,mapped_blocks,mapped_bytes,quick_blocks,"
+						  "fit_calls,avg_examined");
+		for (i = 0; i < MM_NUM_CLASSES; i++)
+			fprintf(stats_fp, ",class%d", i);
+		fprintf(stats_fp, "\n");
+	}
+	if (lat_run)
+	{
+		lat_stats = (lat_stats_t *)calloc(num_tracefiles, sizeof(lat_stats_t));
+		if (lat_stats == NULL)
+			unix_error("lat_stats calloc in main failed");
+	}
+	if (batch_run)
+	{
+		batch_stats = (batch_stats_t *)calloc(num_tracefiles, sizeof(batch_stats_t));
+		if (batch_stats == NULL)
+			unix_error("batch_stats calloc in main failed");
+	}
+	if (region_objs)
+	{
+		region_stats = (region_stats_t *)calloc(num_tracefiles, sizeof(region_stats_t));
+		if (region_stats == NULL)
+			unix_error("region_stats calloc in main failed");
+	}
+	if (align_size)
+	{
+		align_stats = (align_stats_t *)calloc(num_tracefiles, sizeof(align_stats_t));
+		if (align_stats == NULL)
+			unix_error("align_stats calloc in main failed");
+	}
+	if (prof_file)
+	{
+		prof_stats = (prof_stats_t *)calloc(num_tracefiles, sizeof(prof_stats_t));
+		if (prof_stats == NULL)
+			unix_error("prof_stats calloc in main failed");
+	}
+
+	if (bench_samples)
+	{
+		bench = (bench_result_t *)calloc(num_tracefiles, sizeof(bench_result_t));
+		if (bench == NULL)
+			unix_error("bench calloc in main failed");
+		if ((bench_cpu = bench_pin(bench_cpu)) < 0)
+			printf("Warning: could not pin to a CPU; benchmark samples may migrate\n");
+		else if (verbose)
+			printf("Benchmarking on CPU %d: %d warmup and %d timed runs per trace\n",
+				   bench_cpu, bench_warmup, bench_samples);
+	}
+
+	if (perf_run && perf_open(&perf_ctrs) < PERF_NUM_EVENTS && verbose)
+	{
+		printf("Hardware events not available (no PMU, or see perf_event_paranoid):");
+		for (i = 0; i < PERF_NUM_EVENTS; i++)
+			if (perf_ctrs.fd[i] < 0)
+				printf(" %s", perf_event_name(i));
+		printf("\n");
+	}
+
+	/* Initialize the simulated memory system in memlib.c */
+	mem_init();
+
+	/* Evaluate student's mm malloc package using the K-best scheme */
+	for (i = 0; i < num_tracefiles; i++)
+	{
+		trace = read_trace(tracedir, tracefiles[i]);
+		mm_stats[i].ops = trace->num_ops;
+		if (verbose > 1)
+			printf("Checking mm_malloc for correctness, ");
+		mm_stats[i].valid = eval_mm_valid(trace, i, &ranges);
+		if (mm_stats[i].valid)
+		{
+			if (verbose > 1)
+				printf("efficiency, ");
+			mm_stats[i].util = eval_mm_util(trace, i, &ranges);
+			mm_stats[i].peak = mem_heap_peak();
+			mm_stats[i].end = mem_heapsize() + mem_mapped();
+			mm_stats[i].commit_peak = mem_commit_peak();
+			mm_stats[i].commit_end = mem_committed();
+			mm_stats[i].huge = util_huge;
+			speed_params.trace = trace;
+			speed_params.ranges = ranges;
+			if (verbose > 1)
+				printf("and performance.\n");
+			if (bench_samples)
+			{
+				/* Median of the samples instead of fsecs's mean */
+				bench_result_t *r = &bench[num_bench++];
+
+				snprintf(r->name, sizeof(r->name), "%s", tracefiles[i]);
+				r->ops = mm_stats[i].ops;
+				r->util = mm_stats[i].util;
+				bench_run(eval_mm_speed, &speed_params, bench_warmup, bench_samples, r);
+				mm_stats[i].secs = r->secs;
+			}
+			else
+				mm_stats[i].secs = fsecs(eval_mm_speed, &speed_params);
+			if (perf_run)
+			{
+				if (verbose > 1)
+					printf("Counting hardware events.\n");
+				perf_measure(&perf_ctrs, eval_mm_speed, &speed_params, &mm_stats[i].perf);
+			}
+			if (mt_threads)
+			{
+				if (verbose > 1)
+					printf("Replaying on %d threads.\n", mt_threads);
+				mt_stats[i].valid = eval_mm_mt(trace, mt_threads, &mt_stats[i]);
+			}
+			if (lat_run)
+			{
+				if (verbose > 1)
+					printf("Timing each request.\n");
+				eval_mm_latency(trace, &lat_stats[i]);
+			}
+			if (batch_run)
+			{
+				if (verbose > 1)
+					printf("Replaying with batch calls.\n");
+				if (eval_mm_batch(trace, i, &ranges, &batch_stats[i]))
+					batch_stats[i].secs = fsecs(eval_mm_batch_speed, &speed_params);
+			}
+			if (region_objs)
+			{
+				if (verbose > 1)
+					printf("Replaying the sizes in requests of %d objects.\n", region_objs);
+				eval_region(trace, i, &ranges, &region_stats[i]);
+			}
+			if (align_size)
+			{
+				if (verbose > 1)
+					printf("Replaying with sized frees and %zu-byte aligned mallocs.\n", align_size);
+				eval_mm_aligned(trace, i, &ranges, &align_stats[i]);
+			}
+			if (prof_file)
+			{
+				if (verbose > 1)
+					printf("Profiling the heap.\n");
+				eval_mm_prof(trace, i, &prof_stats[i]);
+			}
+			if (stats_fp != NULL)
+			{
+				if (verbose > 1)
+					printf("Sampling heap statistics.\n");
+				eval_mm_stats(trace, i, stats_fp);
+			}
+		}
+		free_trace(trace);
+	}
+	if (perf_run)
+		perf_close(&perf_ctrs);
+
+	/* Display the mm results in a compact table */
+	if (verbose)
+	{
+		printf("\nResults for mm malloc:\n");
+		printresults(num_tracefiles, mm_stats);
+		printf("\n");
+#if MEM_BACKEND == MEM_MMAP
+		printf("Memory committed by memlib (%s, %zu KB pages):\n",
+			   mem_backend(), mem_commit_unit() / 1024);
+		printresults_mem(num_tracefiles, mm_stats);
+		printf("\n");
+#endif
+	}
+
+	/* The multi-threaded results are the point of -j, so always show them */
+	if (mt_threads)
+	{
+		printf("Results for mm malloc on %d threads (%s%s):\n", mt_threads,
+			   mt_shard ? "sharded trace" : "one trace copy per thread",
+			   mt_xfree ? ", cross-thread frees" : "");
+		printresults_mt(num_tracefiles, mt_stats);
+		printf("\n");
+	}
+
+	if (stats_fp != NULL)
+	{
+		fclose(stats_fp);
+		printf("Heap statistics every %d ops written to %s\n\n", stats_interval, stats_file);
+	}
+
+	if (lat_run)
+	{
+		printf("Per-request latency for mm malloc (cycles):\n");
+		printresults_lat(num_tracefiles, lat_stats);
+		printf("\n");
+		if (lat_csvfile != NULL)
+			write_lat_csv(lat_csvfile, num_tracefiles, tracefiles, lat_stats);
+	}
+
+	if (batch_run)
+	{
+		printf("Batch calls for mm malloc (runs of up to %d same-size mallocs or frees):\n",
+			   BATCH_MAX);
+		printresults_batch(num_tracefiles, mm_stats, batch_stats);
+		printf("\n");
+	}
+
+	if (region_objs)
+	{
+		printf("Request-scoped memory for mm malloc (%d objects per request, "
+			   "each freed vs a region reset):\n", region_objs);
+		printresults_region(num_tracefiles, region_stats);
+		printf("\n");
+	}
+
+	if (align_size)
+	{
+		printf("Sized frees and %zu-byte aligned mallocs for mm malloc:\n", align_size);
+		printresults_align(num_tracefiles, mm_stats, align_stats);
+		printf("\n");
+	}
+
+	if (prof_file)
+	{
+		printf("Heap profiles at each trace's peak (one sample per %zu bytes on average), "
+			   "written to %s.<trace>:\n", prof_rate ? prof_rate : (size_t)PROF_RATE, prof_file);
+		printresults_prof(num_tracefiles, prof_stats);
+		printf("\n");
+	}
+
+	if (bench_samples)
+	{
+		char config[MAXLINE];
+		bench_result_t *base;
+		int nbase;
+
+		printf("Benchmark of mm malloc (median of %d runs, 95%% confidence interval):\n",
+			   bench_samples);
+		printresults_bench(num_bench, bench);
+		printf("\n");
+		if (bench_save_file != NULL)
+		{
+			bench_config(config, sizeof(config));
+			if (!bench_save(bench_save_file, bench, num_bench, config))
+				unix_error("Could not write the benchmark baseline");
+			printf("Baseline written to %s\n\n", bench_save_file);
+		}
+		if (bench_base_file != NULL)
+		{
+			if ((nbase = bench_load(bench_base_file, &base)) < 0)
+				unix_error("Could not read the benchmark baseline");
+			printf("Against the baseline in %s (threshold %.1f%%):\n",
+				   bench_base_file, bench_threshold * 100);
+			regressions = bench_compare(bench, num_bench, base, nbase, bench_threshold);
+			printf("\n");
+			free(base);
+		}
+	}
+
+	/*
+	 * Accumulate the aggregate statistics for the student's mm package
+	 */
+	secs = 0;
+	ops = 0;
+	util = 0;
+	numcorrect = 0;
+	for (i = 0; i < num_tracefiles; i++)
+	{
+		secs += mm_stats[i].secs;
+		ops += mm_stats[i].ops;
+		util += mm_stats[i].util;
+		if (mm_stats[i].valid)
+			numcorrect++;
+	}
+	avg_mm_util = util / num_tracefiles;
+
+	/*
+	 * Compute and print the performance index
+	 */
+	if (errors == 0)
+	{
+		avg_mm_throughput = ops / secs;
+
+		p1 = UTIL_WEIGHT * avg_mm_util;
+		if (avg_mm_throughput > AVG_LIBC_THRUPUT)
+		{
+			p2 = (double)(1.0 - UTIL_WEIGHT);
+		}
+		else
+		{
+			p2 = ((double)(1.0 - UTIL_WEIGHT)) *
+				 (avg_mm_throughput / AVG_LIBC_THRUPUT);
+		}
+
+		perfindex = (p1 + p2) * 100.0;
+		printf("Perf index = %.0f (util) + %.0f (thru) = %.0f/100\n",
+			   p1 * 100,
+			   p2 * 100,
+			   perfindex);
+	}
+	else
+	{ /* There were errors */
+		perfindex = 0.0;
+		printf("Terminated with %d errors\n", errors);
+	}
+
+	if (autograder)
+	{
+		printf("correct:%d\n", numcorrect);
+		printf("perfidx:%.0f\n", perfindex);
+	}
+
+	/* A regression against the baseline fails the run (for CI gates) */
+	if (regressions)
+	{
+		printf("%d trace%s regressed against %s\n", regressions,
+			   regressions > 1 ? "s" : "", bench_base_file);
+		exit(1);
+	}
+	exit(0);
+}
+
+/*****************************************************************
+ * The following routines manipulate the range tree, which keeps
+ * track of the extent of every allocated block payload. We use the
+ * range tree to detect any overlapping allocated blocks.
+ *
+ * The tree is a treap: a binary search tree on lo, and a heap on a
+ * hash of lo, which keeps its expected height O(log n) whatever order
+ * the payloads come in. Payloads never overlap, so ordering by lo
+ * orders them by hi too, and a new payload can only overlap the one
+ * with the highest lo at or below its hi. Nodes come from a pool and
+ * go back to it, so a trace costs no malloc per block.
+ ****************************************************************/
+
+static range_t *range_pool = NULL; /* free nodes, linked through right */
+
+/* range_prio - heap priority of the node for payload lo */
+static inline unsigned int range_prio(char *lo)
+{
+	return (unsigned int)(((uint64_t)(uintptr_t)lo * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+/* range_alloc - take a node from the pool, refilling it if it is empty */
+static range_t *range_alloc(void)
+{
+	range_t *p;
+	int i;
+
+	if (range_pool == NULL)
+	{
+		if ((p = (range_t *)malloc(RANGE_CHUNK * sizeof(range_t))) == NULL)
+			unix_error("malloc error in range_alloc");
+		for (i = 0; i < RANGE_CHUNK; i++)
+		{
+			p[i].right = range_pool;
+			range_pool = &p[i];
+		}
+	}
+	p = range_pool;
+	range_pool = p->right;
+	return p;
+}
+
+/* range_release - put a node back in the pool */
+static inline void range_release(range_t *p)
+{
+	p->right = range_pool;
+	range_pool = p;
+}
+
+/*
+ * add_range - As directed by request opnum in trace tracenum,
+ *     we've just called the student's mm_malloc to allocate a block of
+ *     size bytes at addr lo, which must be align-byte aligned (ALIGNMENT,
+ *     or what was asked of mm_aligned_alloc). After checking the block
+ *     for correctness, we create a range struct for this block and add
+ *     it to the range tree.
+ */
+static int add_range(range_t **ranges, char *lo, size_t size, size_t align,
+					 int tracenum, long opnum)
+{
+	char *hi = lo + size - 1;
+	range_t *p, *below, **link, **l, **r;
+	unsigned int prio;
+	char msg[MAXLINE];
+
+	assert(size > 0);
+
+	/* Payload addresses must be align-byte aligned */
+	if (!IS_ALIGNED(lo, align))
+	{
+		sprintf(msg, "Payload address (%p) not aligned to %zu bytes",
+				lo, align);
+		malloc_error(tracenum, opnum, msg);
+		return 0;
+	}
+
+	/* The payload must lie within the extent of the heap, or within
+	 * one of the mappings memlib handed out for big blocks (unless the
+	 * backend manages its own memory) */
+	if (be->heap && !mem_contains(lo, hi))
+	{
+		sprintf(msg, "Payload (%p:%p) lies outside heap (%p:%p) and its mappings",
+				lo, hi, mem_heap_lo(), mem_heap_hi());
+		malloc_error(tracenum, opnum, msg);
+		return 0;
+	}
+
+	/* The payload must not overlap any other payloads: check the one
+	 * with the highest lo at or below hi */
+	below = NULL;
+	for (p = *ranges; p != NULL;)
+	{
+		if (p->lo <= hi)
+		{
+			below = p;
+			p = p->right;
+		}
+		else
+			p = p->left;
+	}
+	if (below != NULL && below->hi >= lo)
+	{
+		sprintf(msg, "Payload (%p:%p) overlaps another payload (%p:%p)\n",
+				lo, hi, below->lo, below->hi);
+		malloc_error(tracenum, opnum, msg);
+		return 0;
+	}
+
+	/*
+	 * Everything looks OK, so remember the extent of this block by
+	 * putting a range struct for it in the tree: at the first node of
+	 * lower priority, whose subtree is split around lo.
+	 */
+	p = range_alloc();
+	p->lo = lo;
+	p->hi = hi;
+	prio = range_prio(lo);
+	for (link = ranges; *link != NULL && range_prio((*link)->lo) >= prio;)
+		link = (lo < (*link)->lo) ? &(*link)->left : &(*link)->right;
+	l = &p->left;
+	r = &p->right;
+	for (below = *link; below != NULL;)
+	{
+		if (below->lo < lo)
+		{
+			*l = below;
+			l = &below->right;
+			below = below->right;
+		}
+		else
+		{
+			*r = below;
+			r = &below->left;
+			below = below->left;
+		}
+	}
+	*l = *r = NULL;
+	*link = p;
+	return 1;
+}
+
+/*
+ * remove_range - Free the range record of block whose payload starts at lo,
+ *     replacing it by the merge of its two subtrees
+ */
+static void remove_range(range_t **ranges, char *lo)
+{
+	range_t **link = ranges;
+	range_t *p, *l, *r;
+
+	while (*link != NULL && (*link)->lo != lo)
+		link = (lo < (*link)->lo) ? &(*link)->left : &(*link)->right;
+	if ((p = *link) == NULL)
+		return;
+
+	l = p->left; /* every payload in l is below every payload in r */
+	r = p->right;
+	while (l != NULL && r != NULL)
+	{
+		if (range_prio(l->lo) > range_prio(r->lo))
+		{
+			*link = l;
+			link = &l->right;
+			l = l->right;
+		}
+		else
+		{
+			*link = r;
+			link = &r->left;
+			r = r->left;
+		}
+	}
+	*link = (l != NULL) ? l : r;
+	range_release(p);
+}
+
+/*
+ * clear_ranges - free all of the range records for a trace, rotating
+ *     left children up so that the tree is taken apart without a stack
+ */
+static void clear_ranges(range_t **ranges)
+{
+	range_t *p, *l;
+
+	while ((p = *ranges) != NULL)
+	{
+		if ((l = p->left) != NULL)
+		{
+			p->left = l->right;
+			l->right = p;
+			*ranges = l;
+		}
+		else
+		{
+			*ranges = p->right;
+			range_release(p);
+		}
+	}
+}
+
+/*****************************************************************
+ * The following routines remember the block the allocator returned
+ * for each trace id, and its payload size. Traces use the dense
+ * blocks/block_sizes arrays, except for streamed traces with more
+ * than STREAM_DENSE_IDS ids: most of those are dead at any one time,
+ * so only the live blocks are kept, in a hash map.
+ ****************************************************************/
+
+/* blockmap_home - the slot where id's probe sequence starts */
+static inline size_t blockmap_home(blockmap_t *m, uint32_t id)
+{
+	return (size_t)(((uint64_t)id * 0x9E3779B97F4A7C15ULL) >> 32) & (m->cap - 1);
+}
+
+/* blockmap_find - the slot holding id, or the empty slot where it goes */
+static inline blockent_t *blockmap_find(blockmap_t *m, uint32_t id)
+{
+	size_t i;
+
+	for (i = blockmap_home(m, id); m->tab[i].p != NULL; i = (i + 1) & (m->cap - 1))
+		if (m->tab[i].id == id)
+			break;
+	return &m->tab[i];
+}
+
+/* blockmap_grow - double the table (it is kept at most half full) */
+static void blockmap_grow(blockmap_t *m)
+{
+	blockent_t *old = m->tab;
+	size_t i, oldcap = m->cap;
+
+	m->cap = oldcap ? 2 * oldcap : 1024;
+	if ((m->tab = (blockent_t *)calloc(m->cap, sizeof(blockent_t))) == NULL)
+		unix_error("calloc failed in blockmap_grow");
+	for (i = 0; i < oldcap; i++)
+		if (old[i].p != NULL)
+			*blockmap_find(m, old[i].id) = old[i];
+	free(old);
+}
+
+/*
+ * blockmap_remove - delete id, moving later entries of its probe run
+ *     back so that no lookup stops early at the hole
+ */
+static void blockmap_remove(blockmap_t *m, uint32_t id)
+{
+	size_t mask = m->cap - 1;
+	size_t i = blockmap_find(m, id) - m->tab, j = i, k;
+
+	if (m->tab[i].p == NULL)
+		return;
+	m->count--;
+	for (;;)
+	{
+		m->tab[i].p = NULL;
+		for (;;)
+		{
+			j = (j + 1) & mask;
+			if (m->tab[j].p == NULL)
+				return;
+			/* Entry j may fill the hole unless its home lies in (i, j] */
+			k = blockmap_home(m, m->tab[j].id);
+			if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+				continue;
+			break;
+		}
+		m->tab[i] = m->tab[j];
+		i = j;
+	}
+}
+
+/* get_block - the block of id index (NULL if none) and, if size isn't NULL, its size */
+static inline char *get_block(trace_t *trace, unsigned index, size_t *size)
+{
+	blockent_t *e;
+
+	if (trace->live == NULL)
+	{
+		if (size != NULL)
+			*size = trace->block_sizes[index];
+		return trace->blocks[index];
+	}
+	e = blockmap_find(trace->live, index);
+	if (size != NULL)
+		*size = e->size;
+	return e->p;
+}
+
+/* set_block - remember that id index is now block p of size bytes */
+static inline void set_block(trace_t *trace, unsigned index, char *p, size_t size)
+{
+	blockent_t *e;
+
+	if (trace->live == NULL)
+	{
+		trace->blocks[index] = p;
+		trace->block_sizes[index] = size;
+		return;
+	}
+	e = blockmap_find(trace->live, index);
+	if (e->p == NULL)
+	{
+		if (2 * (trace->live->count + 1) > trace->live->cap)
+		{
+			blockmap_grow(trace->live);
+			e = blockmap_find(trace->live, index);
+		}
+		trace->live->count++;
+	}
+	e->id = index;
+	e->p = p;
+	e->size = size;
+}
+
+/* drop_block - forget the block of id index once it has been freed */
+static inline void drop_block(trace_t *trace, unsigned index)
+{
+	if (trace->live != NULL)
+		blockmap_remove(trace->live, index);
+}
+
+/**********************************************
+ * The following routines manipulate tracefiles
+ *********************************************/
+
+/*
+ * read_trace - read a trace file and store it in memory. Binary traces
+ *     (see trace.h) are recognized by their magic number and mapped
+ *     rather than read. A filename of the form gen:<spec> names a
+ *     trace that is generated from a workload model (see workload.h).
+ */
+static trace_t *read_trace(char *tracedir, char *filename)
+{
+	FILE *tracefile;
+	trace_t *trace;
+	char type[MAXLINE];
+	char path[MAXLINE];
+	unsigned index;
+	size_t size;
+	unsigned max_index = 0;
+	unsigned op_index;
+
+	if (verbose > 1)
+		printf("Reading tracefile: %s\n", filename);
+
+	/* Allocate the trace record */
+	if ((trace = (trace_t *)malloc(sizeof(trace_t))) == NULL)
+		unix_error("malloc 1 failed in read_trance");
+	trace->stream = NULL;
+	trace->live = NULL;
+
+	if (strncmp(filename, WL_PREFIX, strlen(WL_PREFIX)) == 0)
+	{
+		gen_trace(trace, filename + strlen(WL_PREFIX));
+		return trace;
+	}
+
+	/* Read the trace file header */
+	strcpy(path, tracedir);
+	strcat(path, filename);
+	if (stream_run)
+	{
+		stream_trace(trace, path);
+		return trace;
+	}
+	if ((tracefile = fopen(path, "r")) == NULL)
+	{
+		sprintf(msg, "Could not open %s in read_trace", path);
+		unix_error(msg);
+	}
+	if (fread(type, 1, TRACE_MAGIC_LEN, tracefile) == TRACE_MAGIC_LEN &&
+		memcmp(type, TRACE_MAGIC, TRACE_MAGIC_LEN) == 0)
+	{
+		fclose(tracefile);
+		if (!map_trace(trace, path))
+		{
+			sprintf(msg, "Bad binary trace %s in read_trace", path);
+			app_error(msg);
+		}
+		return trace;
+	}
+	rewind(tracefile);
+	trace->map = NULL;
+	fscanf(tracefile, "%d", &(trace->sugg_heapsize)); /* not used */
+	fscanf(tracefile, "%d", &(trace->num_ids));
+	fscanf(tracefile, "%ld", &(trace->num_ops));
+	fscanf(tracefile, "%d", &(trace->weight)); /* not used */
+
+	/* We'll store each request line in the trace in this array */
+	if ((trace->ops =
+			 (traceop_t *)malloc(trace->num_ops * sizeof(traceop_t))) == NULL)
+		unix_error("malloc 2 failed in read_trace");
+
+	/* We'll keep an array of pointers to the allocated blocks here... */
+	if ((trace->blocks =
+			 (char **)malloc(trace->num_ids * sizeof(char *))) == NULL)
+		unix_error("malloc 3 failed in read_trace");
+
+	/* ... along with the corresponding byte sizes of each block */
+	if ((trace->block_sizes =
+			 (size_t *)malloc(trace->num_ids * sizeof(size_t))) == NULL)
+		unix_error("malloc 4 failed in read_trace");
+
+	/* read every request line in the trace file */
+	index = 0;
+	op_index = 0;
+	while (fscanf(tracefile, "%s", type) != EOF)
+	{
+		switch (type[0])
+		{
+		case 'a':
+			fscanf(tracefile, "%u %zu", &index, &size);
+			trace->ops[op_index].type = ALLOC;
+			trace->ops[op_index].index = index;
+			trace->ops[op_index].size = size;
+			max_index = (index > max_index) ? index : max_index;
+			break;
+		case 'r':
+			fscanf(tracefile, "%u %zu", &index, &size);
+			trace->ops[op_index].type = REALLOC;
+			trace->ops[op_index].index = index;
+			trace->ops[op_index].size = size;
+			max_index = (index > max_index) ? index : max_index;
+			break;
+		case 'f':
+			fscanf(tracefile, "%ud", &index);
+			trace->ops[op_index].type = FREE;
+			trace->ops[op_index].index = index;
+			break;
+		default:
+			printf("Bogus type character (%c) in tracefile %s\n",
+				   type[0], path);
+			exit(1);
+		}
+		op_index++;
+	}
+	fclose(tracefile);
+	assert(max_index == trace->num_ids - 1);
+	assert(trace->num_ops == op_index);
+
+	return trace;
+}
+
+/*
+ * map_trace - map the binary trace at path and point trace->ops at its
+ *     records. Only the block arrays are allocated; the records are
+ *     replayed straight from the page cache. Returns 0 if the file is
+ *     malformed or was written on a machine of the other byte order.
+ */
+static int map_trace(trace_t *trace, char *path)
+{
+	int fd;
+	struct stat st;
+	char *map;
+	trace_hdr_t *hdr;
+	traceop_t *ops;
+	size_t i;
+
+	if ((fd = open(path, O_RDONLY)) < 0 || fstat(fd, &st) < 0)
+		unix_error("Could not open binary trace in map_trace");
+	if ((size_t)st.st_size < sizeof(trace_hdr_t))
+		return 0;
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		unix_error("mmap failed in map_trace");
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+
+	hdr = (trace_hdr_t *)map;
+	if (hdr->version != TRACE_VERSION || hdr->byte_order != TRACE_BYTE_ORDER ||
+		hdr->op_size != sizeof(traceop_t) || hdr->ops_offset % 8 != 0 ||
+		hdr->num_ids > INT32_MAX || hdr->num_ops > INT32_MAX ||
+		hdr->ops_offset + hdr->num_ops * sizeof(traceop_t) > (uint64_t)st.st_size)
+	{
+		munmap(map, st.st_size);
+		return 0;
+	}
+	/* The replay indexes the block arrays with the ids unchecked */
+	ops = (traceop_t *)(map + hdr->ops_offset);
+	for (i = 0; i < hdr->num_ops; i++)
+		if (ops[i].index >= hdr->num_ids || ops[i].type > REALLOC)
+		{
+			munmap(map, st.st_size);
+			return 0;
+		}
+
+	trace->map = map;
+	trace->map_len = st.st_size;
+	trace->sugg_heapsize = (int)hdr->sugg_heapsize;
+	trace->num_ids = (int)hdr->num_ids;
+	trace->num_ops = (int)hdr->num_ops;
+	trace->weight = (int)hdr->weight;
+	trace->ops = ops;
+
+	if ((trace->blocks = (char **)malloc(trace->num_ids * sizeof(char *))) == NULL)
+		unix_error("malloc 3 failed in map_trace");
+	if ((trace->block_sizes = (size_t *)malloc(trace->num_ids * sizeof(size_t))) == NULL)
+		unix_error("malloc 4 failed in map_trace");
+	return 1;
+}
+
+/*
+ * stream_trace - set trace up to be read from path a chunk at a time
+ *     (-S) by next_chunk. Only the block arrays are allocated, and not
+ *     even those if the trace has too many ids for them to be dense.
+ */
+static void stream_trace(trace_t *trace, char *path)
+{
+	if ((trace->stream = stream_open(path)) == NULL)
+	{
+		sprintf(msg, "Could not open %s in read_trace", path);
+		unix_error(msg);
+	}
+	if (trace->stream->num_ids > INT32_MAX)
+	{
+		sprintf(msg, "Too many ids in %s in read_trace", path);
+		app_error(msg);
+	}
+	trace->sugg_heapsize = (int)trace->stream->sugg_heapsize;
+	trace->num_ids = (int)trace->stream->num_ids;
+	trace->num_ops = trace->stream->num_ops;
+	trace->weight = trace->stream->weight;
+	trace->ops = NULL;
+	trace->map = NULL;
+	trace->blocks = NULL;
+	trace->block_sizes = NULL;
+
+	if (trace->stream->num_ids > STREAM_DENSE_IDS)
+	{
+		if ((trace->live = (blockmap_t *)calloc(1, sizeof(blockmap_t))) == NULL)
+			unix_error("calloc failed in stream_trace");
+		blockmap_grow(trace->live);
+		return;
+	}
+	if ((trace->blocks = (char **)malloc(trace->num_ids * sizeof(char *))) == NULL)
+		unix_error("malloc 3 failed in stream_trace");
+	if ((trace->block_sizes = (size_t *)malloc(trace->num_ids * sizeof(size_t))) == NULL)
+		unix_error("malloc 4 failed in stream_trace");
+}
+
+/*
+ * gen_trace - generate the trace of the workload model in spec into
+ *     memory, a chunk at a time, doubling the ops array as it fills
+ */
+static void gen_trace(trace_t *trace, char *spec)
+{
+	wl_model_t model;
+	wl_gen_t gen;
+	size_t n, cap = 1 << 16;
+
+	if (!wl_parse(spec, &model, msg, MAXLINE))
+	{
+		printf("ERROR: bad workload spec %s: %s\n", spec, msg);
+		exit(1);
+	}
+	if ((trace->ops = (traceop_t *)malloc(cap * sizeof(traceop_t))) == NULL)
+		unix_error("malloc 2 failed in gen_trace");
+	trace->num_ops = 0;
+	wl_start(&gen, &model);
+	while ((n = wl_next(&gen, trace->ops + trace->num_ops, cap - trace->num_ops)) > 0)
+		if ((trace->num_ops += n) == (long)cap &&
+			(trace->ops = (traceop_t *)realloc(trace->ops, (cap *= 2) * sizeof(traceop_t))) == NULL)
+			unix_error("realloc failed in gen_trace");
+	wl_stop(&gen);
+	wl_free(&model);
+
+	trace->sugg_heapsize = 0;
+	trace->num_ids = (int)gen.num_ids;
+	trace->weight = 1;
+	trace->map = NULL;
+	if ((trace->blocks = (char **)malloc((trace->num_ids + 1) * sizeof(char *))) == NULL)
+		unix_error("malloc 3 failed in gen_trace");
+	if ((trace->block_sizes = (size_t *)malloc((trace->num_ids + 1) * sizeof(size_t))) == NULL)
+		unix_error("malloc 4 failed in gen_trace");
+}
+
+/*
+ * free_trace - Free the trace record and the three arrays it points
+ *              to, all of which were allocated in read_trace()
+ *              (for a binary trace, ops is unmapped instead).
+ */
+void free_trace(trace_t *trace)
+{
+	if (trace->stream != NULL)
+		stream_close(trace->stream);
+	else if (trace->map != NULL)
+		munmap(trace->map, trace->map_len);
+	else
+		free(trace->ops); /* free the three arrays... */
+	if (trace->live != NULL)
+	{
+		free(trace->live->tab);
+		free(trace->live);
+	}
+	free(trace->blocks);
+	free(trace->block_sizes);
+	free(trace); /* and the trace record itself... */
+}
+
+/*
+ * rewind_trace - Start a pass over the requests of the trace, which
+ *     next_chunk then hands out: all at once for a trace in memory, a
+ *     chunk at a time for a streamed one, whose reader thread works a
+ *     chunk ahead of the replay. Also forgets the previous pass's
+ *     blocks (the heap they were in has been reset).
+ */
+static void rewind_trace(trace_t *trace)
+{
+	if (trace->live != NULL)
+	{
+		memset(trace->live->tab, 0, trace->live->cap * sizeof(blockent_t));
+		trace->live->count = 0;
+	}
+	if (trace->stream != NULL)
+		stream_rewind(trace->stream);
+	else
+		trace->pending = trace->num_ops;
+}
+
+/*
+ * next_chunk - Point *ops at the next requests of the pass and return
+ *     how many there are (0 once the trace is done)
+ */
+static size_t next_chunk(trace_t *trace, traceop_t **ops)
+{
+	size_t n;
+
+	if (trace->stream != NULL)
+		return stream_next(trace->stream, ops);
+	n = (size_t)trace->pending;
+	trace->pending = 0;
+	*ops = trace->ops;
+	return n;
+}
+
+/**********************************************************************
+ * The following functions evaluate the correctness, space utilization,
+ * and throughput of the libc and mm malloc packages.
+ **********************************************************************/
+
+/*
+ * eval_mm_valid - Check the mm malloc package for correctness
+ */
+static int eval_mm_valid(trace_t *trace, int tracenum, range_t **ranges)
+{
+	long i, base;
+	size_t j, k, n;
+	traceop_t *ops;
+	int index;
+	size_t size;
+	size_t oldsize;
+	char *newp;
+	char *oldp;
+	char *p;
+
+	/* Reset the heap and free any records in the range tree */
+	mem_reset_brk();
+	clear_ranges(ranges);
+
+	/* Call the mm package's init function */
+	if (be->init() < 0)
+	{
+		malloc_error(tracenum, 0, "mm_init failed.");
+		return 0;
+	}
+
+	/*
+	 * With -C, set the allocator's check level. It stays set for the
+	 * later passes, so the utilization and throughput runs are also
+	 * measured with the per-request checks on.
+	 */
+	if (check_level >= 0 && be->check != NULL && !be->check(check_level))
+	{
+		malloc_error(tracenum, 0, "mm_check failed after mm_init.");
+		return 0;
+	}
+
+	/* Interpret each operation in the trace in order */
+	rewind_trace(trace);
+	for (base = 0; (n = next_chunk(trace, &ops)) > 0; base += n)
+		for (k = 0; k < n; k++)
+		{
+			i = base + k;
+			index = ops[k].index;
+			size = ops[k].size;
+
+			switch (ops[k].type)
+			{
+
+			case ALLOC: /* mm_malloc */
+
+				/* Call the student's malloc */
+				if ((p = be->malloc(size)) == NULL)
+				{
+					malloc_error(tracenum, i, "mm_malloc failed.");
+					return 0;
+				}
+
+				/*
+				 * Test the range of the new block for correctness and add it
+				 * to the range tree if OK. The block must be  be aligned properly,
+				 * and must not overlap any currently allocated block.
+				 */
+				if (add_range(ranges, p, size, ALIGNMENT, tracenum, i) == 0)
+					return 0;
+
+				/* ADDED: cgw
+				 * fill range with low byte of index.  This will be used later
+				 * if we realloc the block and wish to make sure that the old
+				 * data was copied to the new block
+				 */
+				memset(p, index & 0xFF, size);
+
+				/* Remember region */
+				set_block(trace, index, p, size);
+				break;
+
+			case REALLOC: /* mm_realloc */
+
+				/* Call the student's realloc */
+				oldp = get_block(trace, index, &oldsize);
+				if ((newp = be->realloc(oldp, size)) == NULL)
+				{
+					malloc_error(tracenum, i, "mm_realloc failed.");
+					return 0;
+				}
+
+				/* Remove the old region from the range tree */
+				remove_range(ranges, oldp);
+
+				/* Check new block for correctness and add it to range tree */
+				if (add_range(ranges, newp, size, ALIGNMENT, tracenum, i) == 0)
+					return 0;
+
+				/* ADDED: cgw
+				 * Make sure that the new block contains the data from the old
+				 * block and then fill in the new block with the low order byte
+				 * of the new index
+				 */
+				if (size < oldsize)
+					oldsize = size;
+				for (j = 0; j < oldsize; j++)
+				{
+					if ((unsigned char)newp[j] != (index & 0xFF))
+					{
+						malloc_error(tracenum, i, "mm_realloc did not preserve the "
+												  "data from old block");
+						return 0;
+					}
+				}
+				memset(newp, index & 0xFF, size);
+
+				/* Remember region */
+				set_block(trace, index, newp, size);
+				break;
+
+			case FREE: /* mm_free */
+
+				/* Remove region from list and call student's free function */
+				p = get_block(trace, index, NULL);
+				remove_range(ranges, p);
+				be->free(p);
+				drop_block(trace, index);
+				break;
+
+			default:
+				app_error("Nonexistent request type in eval_mm_valid");
+			}
+
+			/* Check the heap every check_every ops (-C, -K) */
+			if (check_level >= 0 && be->check != NULL && (i + 1) % check_every == 0 &&
+				!be->check(check_level))
+			{
+				malloc_error(tracenum, i, "mm_check found the heap inconsistent.");
+				return 0;
+			}
+		}
+
+	/* As far as we know, this is a valid malloc package */
+	return 1;
+}
+
+/*
+ * eval_mm_util - Evaluate the space utilization of the student's package
+ *   The idea is to remember the high water mark "hwm" of the heap for
+ *   an optimal allocator, i.e., no gaps and no internal fragmentation.
+ *   Utilization is the ratio hwm/heapsize, where heapsize is the
+ *   largest size of the heap in bytes while running the student's
+ *   malloc package on the trace. The heap can shrink (mem_trim), so
+ *   memlib keeps that high water mark for us.
+ *
+ *   Also samples the heap's huge page coverage into util_huge each
+ *   time memlib's committed memory grows by another MB or commit unit.
+ */
+static double eval_mm_util(trace_t *trace, int tracenum, range_t **ranges)
+{
+	size_t k, n;
+	traceop_t *ops;
+	int index;
+	size_t size, newsize, oldsize;
+	size_t max_total_size = 0;
+	size_t total_size = 0;
+#if MEM_BACKEND == MEM_MMAP
+	size_t huge_step, huge_mark;
+#endif
+	char *p;
+	char *newp, *oldp;
+
+	/* initialize the heap and the mm malloc package */
+	mem_reset_brk();
+	if (be->init() < 0)
+		app_error("mm_init failed in eval_mm_util");
+
+	util_huge = 0;
+#if MEM_BACKEND == MEM_MMAP
+	huge_step = (mem_commit_unit() > (1 << 20)) ? mem_commit_unit() : (1 << 20);
+	huge_mark = huge_step;
+#endif
+	rewind_trace(trace);
+	while ((n = next_chunk(trace, &ops)) > 0)
+		for (k = 0; k < n; k++)
+		{
+#if MEM_BACKEND == MEM_MMAP
+			if (mem_committed() >= huge_mark)
+			{
+				size_t huge = mem_huge_bytes();
+
+				util_huge = (huge > util_huge) ? huge : util_huge;
+				huge_mark = mem_committed() + huge_step;
+			}
+#endif
+			switch (ops[k].type)
+			{
+
+			case ALLOC: /* mm_alloc */
+				index = ops[k].index;
+				size = ops[k].size;
+
+				if ((p = be->malloc(size)) == NULL)
+					app_error("mm_malloc failed in eval_mm_util");
+
+				/* Remember region and size */
+				set_block(trace, index, p, size);
+
+				/* Keep track of current total size
+				 * of all allocated blocks */
+				total_size += size;
+
+				/* Update statistics */
+				max_total_size = (total_size > max_total_size) ? total_size : max_total_size;
+				break;
+
+			case REALLOC: /* mm_realloc */
+				index = ops[k].index;
+				newsize = ops[k].size;
+
+				oldp = get_block(trace, index, &oldsize);
+				if ((newp = be->realloc(oldp, newsize)) == NULL)
+					app_error("mm_realloc failed in eval_mm_util");
+
+				/* Remember region and size */
+				set_block(trace, index, newp, newsize);
+
+				/* Keep track of current total size
+				 * of all allocated blocks */
+				total_size += (newsize - oldsize);
+
+				/* Update statistics */
+				max_total_size = (total_size > max_total_size) ? total_size : max_total_size;
+				break;
+
+			case FREE: /* mm_free */
+				index = ops[k].index;
+				p = get_block(trace, index, &size);
+
+				be->free(p);
+				drop_block(trace, index);
+
+				/* Keep track of current total size
+				 * of all allocated blocks */
+				total_size -= size;
+
+				break;
+
+			default:
+				app_error("Nonexistent request type in eval_mm_util");
+			}
+		}
+
+	/* Measure against the high-water mark: the heap may have been
+	 * trimmed since the peak */
+	return ((double)max_total_size / (double)mem_heap_peak());
+}
+
+/*
+ * eval_mm_speed - This is the function that is used by fcyc()
+ *    to measure the running time of the mm malloc package.
+ */
+static void eval_mm_speed(void *ptr)
+{
+	size_t k, n;
+	traceop_t *ops;
+	int index;
+	size_t size, newsize;
+	char *p, *newp, *oldp, *block;
+	trace_t *trace = ((speed_t *)ptr)->trace;
+
+	/* Reset the heap and initialize the mm package */
+	mem_reset_brk();
+	if (be->init() < 0)
+		app_error("mm_init failed in eval_mm_speed");
+
+	/* Interpret each trace request */
+	rewind_trace(trace);
+	while ((n = next_chunk(trace, &ops)) > 0)
+		for (k = 0; k < n; k++)
+			switch (ops[k].type)
+			{
+
+			case ALLOC: /* mm_malloc */
+				index = ops[k].index;
+				size = ops[k].size;
+				if ((p = be->malloc(size)) == NULL)
+					app_error("mm_malloc error in eval_mm_speed");
+				set_block(trace, index, p, size);
+				break;
+
+			case REALLOC: /* mm_realloc */
+				index = ops[k].index;
+				newsize = ops[k].size;
+				oldp = get_block(trace, index, NULL);
+				if ((newp = be->realloc(oldp, newsize)) == NULL)
+					app_error("mm_realloc error in eval_mm_speed");
+				set_block(trace, index, newp, newsize);
+				break;
+
+			case FREE: /* mm_free */
+				index = ops[k].index;
+				block = get_block(trace, index, NULL);
+				be->free(block);
+				drop_block(trace, index);
+				break;
+
+			default:
+				app_error("Nonexistent request type in eval_mm_valid");
+			}
+}
+
+/* read_counter - The full 64-bit cycle counter */
+static inline unsigned long long read_counter(void)
+{
+	unsigned hi, lo;
+
+	access_counter(&hi, &lo);
+	return ((unsigned long long)hi << 32) | lo;
+}
+
+/*
+ * eval_mm_latency - Replay a trace once on a fresh heap, reading the
+ *    cycle counter around every request and recording its latency in
+ *    the histogram for its request type. The cost of reading the
+ *    counter itself is measured first and subtracted.
+ */
+static void eval_mm_latency(trace_t *trace, lat_stats_t *stats)
+{
+	int i, index;
+	unsigned long long t0, t1, overhead = ~0ULL;
+	char *p;
+
+	for (i = 0; i < NUM_OPTYPES; i++)
+		hist_reset(&stats->ops[i]);
+
+	/* The counter's own cost: the fastest of a few back-to-back reads */
+	for (i = 0; i < 100; i++)
+	{
+		t0 = read_counter();
+		t1 = read_counter();
+		if (t1 - t0 < overhead)
+			overhead = t1 - t0;
+	}
+
+	/* Reset the heap and initialize the mm package */
+	mem_reset_brk();
+	if (be->init() < 0)
+		app_error("mm_init failed in eval_mm_latency");
+
+	for (i = 0; i < trace->num_ops; i++)
+	{
+		index = trace->ops[i].index;
+		switch (trace->ops[i].type)
+		{
+		case ALLOC: /* mm_malloc */
+			t0 = read_counter();
+			p = be->malloc(trace->ops[i].size);
+			t1 = read_counter();
+			if (p == NULL)
+				app_error("mm_malloc error in eval_mm_latency");
+			trace->blocks[index] = p;
+			break;
+
+		case REALLOC: /* mm_realloc */
+			t0 = read_counter();
+			p = be->realloc(trace->blocks[index], trace->ops[i].size);
+			t1 = read_counter();
+			if (p == NULL)
+				app_error("mm_realloc error in eval_mm_latency");
+			trace->blocks[index] = p;
+			break;
+
+		case FREE: /* mm_free */
+			t0 = read_counter();
+			be->free(trace->blocks[index]);
+			t1 = read_counter();
+			break;
+
+		default:
+			app_error("Nonexistent request type in eval_mm_latency");
+		}
+		t1 -= t0;
+		hist_record(&stats->ops[trace->ops[i].type], t1 > overhead ? t1 - overhead : 0);
+	}
+	stats->valid = 1;
+}
+
+/*
+ * batch_len - The number of requests from ops[k] on (at most BATCH_MAX,
+ *    and within the chunk of n ops) that the batched replay makes in one
+ *    call: mallocs of the same size, or frees. 1 for a realloc.
+ */
+static inline size_t batch_len(traceop_t *ops, size_t k, size_t n)
+{
+	size_t j = k + 1;
+
+	if (ops[k].type == ALLOC)
+		while (j < n && j - k < BATCH_MAX && ops[j].type == ALLOC && ops[j].size == ops[k].size)
+			j++;
+	else if (ops[k].type == FREE)
+		while (j < n && j - k < BATCH_MAX && ops[j].type == FREE)
+			j++;
+	return j - k;
+}
+
+/*
+ * eval_mm_batch - Check the batched replay of a trace: each run of
+ *    requests batch_len finds is one mm_malloc_batch or mm_free_batch
+ *    call, and the rest are single calls. Every block must be aligned,
+ *    in the heap and clear of the others (add_range), and still hold
+ *    the bytes written into it when it is freed. Also counts the
+ *    batched requests for printresults_batch.
+ */
+static int eval_mm_batch(trace_t *trace, int tracenum, range_t **ranges, batch_stats_t *stats)
+{
+	long i, base;
+	size_t j, k, m, n, size;
+	traceop_t *ops;
+	void *ptrs[BATCH_MAX];
+	char *p, *newp;
+	int index;
+
+	stats->valid = 0;
+	stats->batched = 0;
+	stats->batches = 0;
+
+	/* Reset the heap and free any records in the range tree */
+	mem_reset_brk();
+	clear_ranges(ranges);
+	if (mm_init() < 0)
+	{
+		malloc_error(tracenum, 0, "mm_init failed.");
+		return 0;
+	}
+
+	rewind_trace(trace);
+	for (base = 0; (n = next_chunk(trace, &ops)) > 0; base += n)
+		for (k = 0; k < n; k += m)
+		{
+			i = base + k;
+			m = batch_len(ops, k, n);
+			if (m > 1)
+			{
+				stats->batched += m;
+				stats->batches++;
+			}
+
+			switch (ops[k].type)
+			{
+
+			case ALLOC: /* mm_malloc_batch, or mm_malloc for a run of one */
+				size = ops[k].size;
+				if (m > 1 ? mm_malloc_batch(size, ptrs, m) < m : (ptrs[0] = mm_malloc(size)) == NULL)
+				{
+					malloc_error(tracenum, i, m > 1 ? "mm_malloc_batch failed." : "mm_malloc failed.");
+					return 0;
+				}
+				for (j = 0; j < m; j++)
+				{
+					index = ops[k + j].index;
+					if (add_range(ranges, ptrs[j], size, ALIGNMENT, tracenum, i + j) == 0)
+						return 0;
+					memset(ptrs[j], index & 0xFF, size);
+					set_block(trace, index, ptrs[j], size);
+				}
+				break;
+
+			case REALLOC: /* mm_realloc */
+				index = ops[k].index;
+				p = get_block(trace, index, NULL);
+				if ((newp = mm_realloc(p, ops[k].size)) == NULL)
+				{
+					malloc_error(tracenum, i, "mm_realloc failed.");
+					return 0;
+				}
+				remove_range(ranges, p);
+				if (add_range(ranges, newp, ops[k].size, ALIGNMENT, tracenum, i) == 0)
+					return 0;
+				memset(newp, index & 0xFF, ops[k].size);
+				set_block(trace, index, newp, ops[k].size);
+				break;
+
+			case FREE: /* mm_free_batch, or mm_free for a run of one */
+				for (j = 0; j < m; j++)
+				{
+					index = ops[k + j].index;
+					p = ptrs[j] = get_block(trace, index, &size);
+					while (size > 0)
+						if ((unsigned char)p[--size] != (index & 0xFF))
+						{
+							malloc_error(tracenum, i + j, "block was overwritten before "
+														  "it was freed");
+							return 0;
+						}
+					remove_range(ranges, p);
+					drop_block(trace, index);
+				}
+				if (m > 1)
+					mm_free_batch(ptrs, m);
+				else
+					mm_free(ptrs[0]);
+				break;
+
+			default:
+				app_error("Nonexistent request type in eval_mm_batch");
+			}
+		}
+
+	return stats->valid = 1;
+}
+
+/*
+ * eval_mm_batch_speed - The batched replay of eval_mm_batch, without
+ *    the checks, timed by fsecs like eval_mm_speed
+ */
+static void eval_mm_batch_speed(void *ptr)
+{
+	size_t j, k, m, n;
+	traceop_t *ops;
+	void *ptrs[BATCH_MAX];
+	char *p;
+	trace_t *trace = ((speed_t *)ptr)->trace;
+
+	/* Reset the heap and initialize the mm package */
+	mem_reset_brk();
+	if (mm_init() < 0)
+		app_error("mm_init failed in eval_mm_batch_speed");
+
+	rewind_trace(trace);
+	while ((n = next_chunk(trace, &ops)) > 0)
+		for (k = 0; k < n; k += m)
+		{
+			if ((m = batch_len(ops, k, n)) > 1)
+			{
+				if (ops[k].type == ALLOC)
+				{
+					if (mm_malloc_batch(ops[k].size, ptrs, m) < m)
+						app_error("mm_malloc_batch error in eval_mm_batch_speed");
+					for (j = 0; j < m; j++)
+						set_block(trace, ops[k + j].index, ptrs[j], ops[k].size);
+				}
+				else
+				{
+					for (j = 0; j < m; j++)
+					{
+						ptrs[j] = get_block(trace, ops[k + j].index, NULL);
+						drop_block(trace, ops[k + j].index);
+					}
+					mm_free_batch(ptrs, m);
+				}
+				continue;
+			}
+
+			/* A run of one: the single calls of eval_mm_speed */
+			switch (ops[k].type)
+			{
+
+			case ALLOC: /* mm_malloc */
+				if ((p = mm_malloc(ops[k].size)) == NULL)
+					app_error("mm_malloc error in eval_mm_batch_speed");
+				set_block(trace, ops[k].index, p, ops[k].size);
+				break;
+
+			case REALLOC: /* mm_realloc */
+				p = get_block(trace, ops[k].index, NULL);
+				if ((p = mm_realloc(p, ops[k].size)) == NULL)
+					app_error("mm_realloc error in eval_mm_batch_speed");
+				set_block(trace, ops[k].index, p, ops[k].size);
+				break;
+
+			case FREE: /* mm_free */
+				mm_free(get_block(trace, ops[k].index, NULL));
+				drop_block(trace, ops[k].index);
+				break;
+
+			default:
+				app_error("Nonexistent request type in eval_mm_batch_speed");
+			}
+		}
+}
+
+/*
+ * eval_mm_aligned - Check a replay of the trace in which every malloc
+ *    is an mm_aligned_alloc(align_size) and every free an mm_free_sized:
+ *    each block must be aligned as asked (reallocs: to ALIGNMENT), in
+ *    the heap and clear of the others (add_range), and still hold its
+ *    bytes when it is freed. Then time the sized frees with plain and
+ *    with aligned mallocs (eval_mm_sized_speed).
+ */
+static int eval_mm_aligned(trace_t *trace, int tracenum, range_t **ranges, align_stats_t *stats)
+{
+	long i, base;
+	size_t j, k, n, size, oldsize;
+	traceop_t *ops;
+	speed_t params;
+	char *p, *newp;
+	int index;
+
+	stats->valid = 0;
+
+	/* Reset the heap and free any records in the range tree */
+	mem_reset_brk();
+	clear_ranges(ranges);
+	if (mm_init() < 0)
+	{
+		malloc_error(tracenum, 0, "mm_init failed.");
+		return 0;
+	}
+
+	rewind_trace(trace);
+	for (base = 0; (n = next_chunk(trace, &ops)) > 0; base += n)
+		for (k = 0; k < n; k++)
+		{
+			i = base + k;
+			index = ops[k].index;
+			size = ops[k].size;
+
+			switch (ops[k].type)
+			{
+
+			case ALLOC: /* mm_aligned_alloc */
+				if ((p = mm_aligned_alloc(align_size, size)) == NULL)
+				{
+					malloc_error(tracenum, i, "mm_aligned_alloc failed.");
+					return 0;
+				}
+				if (add_range(ranges, p, size, align_size, tracenum, i) == 0)
+					return 0;
+				memset(p, index & 0xFF, size);
+				set_block(trace, index, p, size);
+				break;
+
+			case REALLOC: /* mm_realloc */
+				p = get_block(trace, index, &oldsize);
+				if ((newp = mm_realloc(p, size)) == NULL)
+				{
+					malloc_error(tracenum, i, "mm_realloc failed.");
+					return 0;
+				}
+				remove_range(ranges, p);
+				if (add_range(ranges, newp, size, ALIGNMENT, tracenum, i) == 0)
+					return 0;
+				if (size < oldsize)
+					oldsize = size;
+				for (j = 0; j < oldsize; j++)
+					if ((unsigned char)newp[j] != (index & 0xFF))
+					{
+						malloc_error(tracenum, i, "mm_realloc did not preserve the "
+												  "data from old block");
+						return 0;
+					}
+				memset(newp, index & 0xFF, size);
+				set_block(trace, index, newp, size);
+				break;
+
+			case FREE: /* mm_free_sized */
+				p = get_block(trace, index, &size);
+				for (j = 0; j < size; j++)
+					if ((unsigned char)p[j] != (index & 0xFF))
+					{
+						malloc_error(tracenum, i, "block was overwritten before "
+												  "it was freed");
+						return 0;
+					}
+				remove_range(ranges, p);
+				mm_free_sized(p, size);
+				drop_block(trace, index);
+				break;
+
+			default:
+				app_error("Nonexistent request type in eval_mm_aligned");
+			}
+		}
+	stats->peak = mem_heap_peak();
+	if (check_level >= 0 && !mm_check(check_level))
+	{
+		malloc_error(tracenum, trace->num_ops, "mm_check found the heap inconsistent.");
+		return 0;
+	}
+
+	params.trace = trace;
+	params.align = 0;
+	stats->sized_secs = fsecs(eval_mm_sized_speed, &params);
+	params.align = align_size;
+	stats->aligned_secs = fsecs(eval_mm_sized_speed, &params);
+	return stats->valid = 1;
+}
+
+/*
+ * eval_mm_sized_speed - eval_mm_speed with mm_free_sized for the frees,
+ *    and mm_aligned_alloc for the mallocs if the params give an alignment
+ */
+static void eval_mm_sized_speed(void *ptr)
+{
+	size_t k, n, size;
+	traceop_t *ops;
+	char *p;
+	speed_t *params = (speed_t *)ptr;
+	trace_t *trace = params->trace;
+
+	/* Reset the heap and initialize the mm package */
+	mem_reset_brk();
+	if (mm_init() < 0)
+		app_error("mm_init failed in eval_mm_sized_speed");
+
+	rewind_trace(trace);
+	while ((n = next_chunk(trace, &ops)) > 0)
+		for (k = 0; k < n; k++)
+			switch (ops[k].type)
+			{
+
+			case ALLOC: /* mm_aligned_alloc or mm_malloc */
+				size = ops[k].size;
+				p = params->align ? mm_aligned_alloc(params->align, size) : mm_malloc(size);
+				if (p == NULL)
+					app_error("mm_malloc error in eval_mm_sized_speed");
+				set_block(trace, ops[k].index, p, size);
+				break;
+
+			case REALLOC: /* mm_realloc */
+				p = get_block(trace, ops[k].index, NULL);
+				if ((p = mm_realloc(p, ops[k].size)) == NULL)
+					app_error("mm_realloc error in eval_mm_sized_speed");
+				set_block(trace, ops[k].index, p, ops[k].size);
+				break;
+
+			case FREE: /* mm_free_sized */
+				p = get_block(trace, ops[k].index, &size);
+				mm_free_sized(p, size);
+				drop_block(trace, ops[k].index);
+				break;
+
+			default:
+				app_error("Nonexistent request type in eval_mm_sized_speed");
+			}
+}
+
+/*
+ * eval_mm_prof - Profile the heap of a replay of the trace (prof.h):
+ *    a first pass finds the request after which the most payload bytes
+ *    are live, and a second, with the profiler sampling about once per
+ *    prof_rate bytes, writes the profile right after that request to
+ *    <prof_file>.<tracenum>. The live bytes the samples stand for are
+ *    kept next to the real count, as a check of the sampling. A trace
+ *    that never has bytes live has no peak, and is reported, not dumped.
+ */
+static int eval_mm_prof(trace_t *trace, int tracenum, prof_stats_t *stats)
+{
+	long i, base, peak_op = -1;
+	size_t k, n, size, oldsize, live, peak = 0;
+	traceop_t *ops;
+	char path[MAXLINE];
+	char *p;
+	int pass;
+
+	stats->valid = 0;
+	snprintf(path, sizeof(path), "%s.%d", prof_file, tracenum);
+	for (pass = 0; pass < 2; pass++)
+	{
+		if (pass == 1 && peak_op < 0)
+		{
+			printf("ERROR: trace %d never has bytes live, so no profile was written\n", tracenum);
+			return 0;
+		}
+		mem_reset_brk();
+		if (mm_init() < 0)
+		{
+			malloc_error(tracenum, 0, "mm_init failed.");
+			return 0;
+		}
+		if (pass == 1)
+			mm_prof_start(prof_rate);
+
+		live = 0;
+		rewind_trace(trace);
+		for (base = 0; (n = next_chunk(trace, &ops)) > 0; base += n)
+			for (k = 0; k < n; k++)
+			{
+				i = base + k;
+				size = ops[k].size;
+
+				switch (ops[k].type)
+				{
+
+				case ALLOC: /* mm_malloc */
+					if ((p = mm_malloc(size)) == NULL)
+					{
+						malloc_error(tracenum, i, "mm_malloc failed.");
+						mm_prof_stop();
+						return 0;
+					}
+					set_block(trace, ops[k].index, p, size);
+					live += size;
+					break;
+
+				case REALLOC: /* mm_realloc */
+					p = get_block(trace, ops[k].index, &oldsize);
+					if ((p = mm_realloc(p, size)) == NULL)
+					{
+						malloc_error(tracenum, i, "mm_realloc failed.");
+						mm_prof_stop();
+						return 0;
+					}
+					set_block(trace, ops[k].index, p, size);
+					live += size - oldsize;
+					break;
+
+				case FREE: /* mm_free */
+					p = get_block(trace, ops[k].index, &size);
+					mm_free(p);
+					drop_block(trace, ops[k].index);
+					live -= size;
+					break;
+
+				default:
+					app_error("Nonexistent request type in eval_mm_prof");
+				}
+
+				if (pass == 0 && live > peak)
+				{
+					peak = live;
+					peak_op = i;
+				}
+				else if (pass == 1 && i == peak_op)
+				{
+					mm_prof_counts(&stats->samples, &stats->live, &stats->est);
+					if (mm_prof_dump(path) < 0)
+					{
+						printf("ERROR: can't write %s: %s\n", path, strerror(errno));
+						mm_prof_stop();
+						return 0;
+					}
+				}
+			}
+	}
+	mm_prof_stop();
+	stats->peak = peak;
+	return stats->valid = 1;
+}
+
+/*
+ * eval_region - Replay the sizes of a trace's mallocs and reallocs as
+ *    requests of region_objs objects that die together: once with an
+ *    mm_malloc per object and an mm_free per object at the end of the
+ *    request, and once from a region, reset at the end of each request.
+ *    A checked region run comes first, in which each request also
+ *    keeps an mm_malloc block until the next one: the objects must be
+ *    aligned, in the heap and clear of each other and of those blocks
+ *    (add_range), and still hold their bytes at the reset. Each way is
+ *    then run once for its heap peak and timed with fsecs.
+ */
+static int eval_region(trace_t *trace, int tracenum, range_t **ranges, region_stats_t *stats)
+{
+	region_speed_t params;
+	traceop_t *ops;
+	region_t *r;
+	char *keep, *next, *p;
+	size_t k, n, j;
+	long i, end, m;
+
+	stats->valid = 0;
+
+	/* The request sizes, in trace order */
+	if ((params.sizes = malloc(trace->num_ops * sizeof(size_t))) == NULL ||
+		(params.objs = malloc(region_objs * sizeof(void *))) == NULL)
+		unix_error("malloc in eval_region failed");
+	params.n = 0;
+	rewind_trace(trace);
+	while ((n = next_chunk(trace, &ops)) > 0)
+		for (k = 0; k < n; k++)
+			if (ops[k].type != FREE)
+				params.sizes[params.n++] = ops[k].size;
+	stats->objs = params.n;
+
+	/* The checked run */
+	mem_reset_brk();
+	clear_ranges(ranges);
+	if (mm_init() < 0 || (r = region_create()) == NULL)
+	{
+		malloc_error(tracenum, 0, "mm_init or region_create failed.");
+		goto out;
+	}
+	keep = NULL;
+	for (i = 0; i < params.n; i = end)
+	{
+		end = i + region_objs < params.n ? i + region_objs : params.n;
+		for (m = i; m < end; m++)
+		{
+			if ((p = region_alloc(r, params.sizes[m])) == NULL)
+			{
+				malloc_error(tracenum, m, "region_alloc failed.");
+				goto out;
+			}
+			if (add_range(ranges, p, params.sizes[m], ALIGNMENT, tracenum, m) == 0)
+				goto out;
+			memset(p, m & 0xFF, params.sizes[m]);
+			params.objs[m - i] = p;
+
+			/* Halfway through, swap the request's mm_malloc block */
+			if (m == i + (end - i) / 2)
+			{
+				if ((next = mm_malloc(params.sizes[m])) == NULL)
+				{
+					malloc_error(tracenum, m, "mm_malloc failed.");
+					goto out;
+				}
+				if (add_range(ranges, next, params.sizes[m], ALIGNMENT, tracenum, m) == 0)
+					goto out;
+				if (keep != NULL)
+				{
+					remove_range(ranges, keep);
+					mm_free(keep);
+				}
+				keep = next;
+			}
+		}
+		for (m = i; m < end; m++)
+		{
+			p = params.objs[m - i];
+			for (j = 0; j < params.sizes[m]; j++)
+				if ((unsigned char)p[j] != (m & 0xFF))
+				{
+					malloc_error(tracenum, m, "region object was overwritten before "
+											  "its region was reset");
+					goto out;
+				}
+			remove_range(ranges, p);
+		}
+		region_reset(r);
+	}
+	region_destroy(r);
+	if (keep != NULL)
+	{
+		remove_range(ranges, keep);
+		mm_free(keep);
+	}
+	if (check_level >= 0 && !mm_check(check_level))
+	{
+		malloc_error(tracenum, params.n, "mm_check found the heap inconsistent.");
+		goto out;
+	}
+
+	/* The heap peaks, then the timed runs */
+	eval_region_free_speed(&params);
+	stats->free_peak = mem_heap_peak();
+	eval_region_speed(&params);
+	stats->region_peak = mem_heap_peak();
+	stats->free_secs = fsecs(eval_region_free_speed, &params);
+	stats->region_secs = fsecs(eval_region_speed, &params);
+	stats->valid = 1;
+
+out:
+	free(params.sizes);
+	free(params.objs);
+	return stats->valid;
+}
+
+/*
+ * eval_region_free_speed - The requests of eval_region, with an
+ *    mm_malloc and an mm_free per object
+ */
+static void eval_region_free_speed(void *ptr)
+{
+	region_speed_t *params = (region_speed_t *)ptr;
+	long i, end, m;
+
+	mem_reset_brk();
+	if (mm_init() < 0)
+		app_error("mm_init failed in eval_region_free_speed");
+	for (i = 0; i < params->n; i = end)
+	{
+		end = i + region_objs < params->n ? i + region_objs : params->n;
+		for (m = i; m < end; m++)
+			if ((params->objs[m - i] = mm_malloc(params->sizes[m])) == NULL)
+				app_error("mm_malloc error in eval_region_free_speed");
+		for (m = i; m < end; m++)
+			mm_free(params->objs[m - i]);
+	}
+}
+
+/*
+ * eval_region_speed - The requests of eval_region, from a region that
+ *    is reset at the end of each request
+ */
+static void eval_region_speed(void *ptr)
+{
+	region_speed_t *params = (region_speed_t *)ptr;
+	region_t *r;
+	long i, end, m;
+
+	mem_reset_brk();
+	if (mm_init() < 0 || (r = region_create()) == NULL)
+		app_error("mm_init or region_create failed in eval_region_speed");
+	for (i = 0; i < params->n; i = end)
+	{
+		end = i + region_objs < params->n ? i + region_objs : params->n;
+		for (m = i; m < end; m++)
+			if (region_alloc(r, params->sizes[m]) == NULL)
+				app_error("region_alloc error in eval_region_speed");
+		region_reset(r);
+	}
+	region_destroy(r);
+}
+
+/*
+ * eval_backends - Run each backend named in backend_names on every
+ *    trace: the correctness run, then (if it allocates from memlib's
+ *    heap) the utilization run, the throughput run (fsecs, or the
+ *    median of -b samples) and the latency run, and print one table
+ *    comparing them. Returns 0 if a backend couldn't be loaded or
+ *    failed a trace.
+ */
+static int eval_backends(char **tracefiles, int n)
+{
+	backend_stats_t *bs = NULL;
+	lat_stats_t lat;
+	stats_t *s;
+	range_t *ranges = NULL;
+	trace_t *trace;
+	speed_t speed_params;
+	bench_result_t r;
+	char *name, *names, err[MAXLINE];
+	int nb = 0, ok = 1, i, j, t;
+
+	/* Look up the backends */
+	names = strdup(backend_names);
+	for (name = strtok(names, ","); name != NULL; name = strtok(NULL, ","))
+	{
+		if ((bs = realloc(bs, (nb + 1) * sizeof(backend_stats_t))) == NULL)
+			unix_error("bs realloc in eval_backends failed");
+		if ((bs[nb].be = backend_find(name, err, sizeof(err))) == NULL)
+		{
+			printf("ERROR: backend %s: %s\n", name, err);
+			ok = 0;
+			continue;
+		}
+		if ((bs[nb].traces = (stats_t *)calloc(n, sizeof(stats_t))) == NULL)
+			unix_error("stats calloc in eval_backends failed");
+		hist_reset(&bs[nb].lat);
+		nb++;
+	}
+	free(names);
+	if (nb == 0)
+		return 0;
+
+	if (bench_samples && (bench_cpu = bench_pin(bench_cpu)) < 0)
+		printf("Warning: could not pin to a CPU; benchmark samples may migrate\n");
+
+	/* Every backend runs a trace before the next one is read */
+	for (i = 0; i < n; i++)
+	{
+		trace = read_trace(tracedir, tracefiles[i]);
+		for (j = 0; j < nb; j++)
+		{
+			be = bs[j].be;
+			s = &bs[j].traces[i];
+			s->ops = trace->num_ops;
+			if (verbose > 1)
+				printf("Running %s on %s.\n", be->name, tracefiles[i]);
+			if (!(s->valid = eval_mm_valid(trace, i, &ranges)))
+			{
+				ok = 0;
+				continue;
+			}
+			if (be->heap)
+			{
+				s->util = eval_mm_util(trace, i, &ranges);
+				s->peak = mem_heap_peak();
+			}
+			speed_params.trace = trace;
+			speed_params.ranges = ranges;
+			if (bench_samples)
+			{
+				memset(&r, 0, sizeof(r));
+				r.ops = s->ops;
+				bench_run(eval_mm_speed, &speed_params, bench_warmup, bench_samples, &r);
+				s->secs = r.secs;
+			}
+			else
+				s->secs = fsecs(eval_mm_speed, &speed_params);
+			eval_mm_latency(trace, &lat);
+			for (t = 0; t < NUM_OPTYPES; t++)
+				hist_merge(&bs[j].lat, &lat.ops[t]);
+		}
+		free_trace(trace);
+	}
+	be = backend_find("mm", err, sizeof(err));
+
+	printf("\nComparison of %d backends on %d traces%s:\n", nb, n,
+		   bench_samples ? " (median throughput of the -b runs)" : "");
+	printresults_backends(nb, bs, n);
+
+	for (j = 0; j < nb; j++)
+		free(bs[j].traces);
+	free(bs);
+	return ok;
+}
+
+/*
+ * eval_mm_stats - Replay a trace on a fresh heap and write a row of
+ *    mm_stats() to fp every stats_interval ops and after the last one.
+ *    avg_examined is the mean number of free blocks examined per
+ *    find_fit call since the previous row.
+ */
+static void eval_mm_stats(trace_t *trace, int tracenum, FILE *fp)
+{
+	int i, index;
+	unsigned long fit_calls = 0, fit_examined = 0;
+	char *p;
+
+	mem_reset_brk();
+	if (mm_init() < 0)
+		app_error("mm_init failed in eval_mm_stats");
+
+	for (i = 0; i < trace->num_ops; i++)
+	{
+		index = trace->ops[i].index;
+		switch (trace->ops[i].type)
+		{
+		case ALLOC: /* mm_malloc */
+			if ((p = mm_malloc(trace->ops[i].size)) == NULL)
+				app_error("mm_malloc error in eval_mm_stats");
+			trace->blocks[index] = p;
+			break;
+
+		case REALLOC: /* mm_realloc */
+			if ((p = mm_realloc(trace->blocks[index], trace->ops[i].size)) == NULL)
+				app_error("mm_realloc error in eval_mm_stats");
+			trace->blocks[index] = p;
+			break;
+
+		case FREE: /* mm_free */
+			mm_free(trace->blocks[index]);
+			break;
+
+		default:
+			app_error("Nonexistent request type in eval_mm_stats");
+		}
+		if ((i + 1) % stats_interval == 0 || i + 1 == trace->num_ops)
+			write_mm_stats(fp, tracenum, i + 1, &fit_calls, &fit_examined);
+	}
+}
+
+/*
+ * write_mm_stats - Write one mm_stats() sample as a CSV row. The
+ *    find_fit counters are cumulative, so the previous values are
+ *    kept in *fit_calls and *fit_examined to report the interval.
+ */
+static void write_mm_stats(FILE *fp, int tracenum, int opnum, unsigned long *fit_calls,
+						   unsigned long *fit_examined)
+{
+	mm_stats_t st;
+	unsigned long calls;
+	int c;
+
+	mm_stats(&st);
+	calls = st.fit_calls - *fit_calls;
+	fprintf(fp, "%d,%d,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%zu,%.4f,%zu,%zu,%zu,%zu,%zu,%lu,%.2f",
+			tracenum, opnum, st.heap_size, mem_committed(), mem_huge_bytes(),
+			st.live_blocks, st.live_bytes,
+			st.free_blocks, st.free_bytes, st.largest_free, st.frag,
+			st.slab_runs, st.slab_free_bytes, st.mapped_blocks, st.mapped_bytes,
+			st.quick_blocks,
+			calls, calls ? (double)(st.fit_examined - *fit_examined) / calls : 0);
+	for (c = 0; c < MM_NUM_CLASSES; c++)
+		fprintf(fp, ",%zu", st.free_by_class[c]);
+	fprintf(fp, "\n");
+	*fit_calls = st.fit_calls;
+	*fit_examined = st.fit_examined;
+}
+
+/*
+ * eval_mm_mt - Replay a trace concurrently on nthreads threads, sharing
+ *    one heap, and compare against the same work done by one thread.
+ *    Each thread replays its own copy of the trace, or with -s every
+ *    thread replays only its shard of the ids. With -x each free is
+ *    handed to the next thread, which performs it, so every free crosses
+ *    threads. The driver does not check payloads here: eval_mm_valid
+ *    has already done that single-threaded. Returns 0 if the allocator
+ *    failed a request.
+ */
+static int eval_mm_mt(trace_t *trace, int nthreads, mt_stats_t *stats)
+{
+	mt_thread_t *threads;
+	double secs, best;
+	int i, rep;
+
+	if ((threads = calloc(nthreads, sizeof(mt_thread_t))) == NULL)
+		unix_error("calloc failed in eval_mm_mt");
+
+	stats->nthreads = nthreads;
+
+	/*
+	 * Baseline: one thread does all the work that the nthreads threads
+	 * will share, so both runs move the same number of ops.
+	 */
+	best = DBL_MAX;
+	for (rep = 0; rep < MT_REPS; rep++)
+	{
+		secs = 0;
+		if (mt_shard)
+			secs = run_mm_mt(trace, 1, threads);
+		else
+			for (i = 0; i < nthreads && secs >= 0; i++)
+			{
+				double s = run_mm_mt(trace, 1, threads);
+				secs = (s < 0) ? s : secs + s;
+			}
+		if (secs < 0)
+		{
+			free(threads);
+			return 0;
+		}
+		if (secs < best)
+			best = secs;
+	}
+	stats->base_secs = best;
+
+	/* The concurrent run */
+	best = DBL_MAX;
+	for (rep = 0; rep < MT_REPS; rep++)
+	{
+		if ((secs = run_mm_mt(trace, nthreads, threads)) < 0)
+		{
+			free(threads);
+			return 0;
+		}
+		if (secs < best)
+		{
+			best = secs;
+			stats->ops = 0;
+			stats->min_nsop = DBL_MAX;
+			stats->max_nsop = stats->avg_nsop = 0;
+			for (i = 0; i < nthreads; i++)
+			{
+				double nsop = threads[i].ops ? threads[i].secs * 1e9 / threads[i].ops : 0;
+
+				stats->ops += threads[i].ops;
+				stats->avg_nsop += nsop / nthreads;
+				if (nsop < stats->min_nsop)
+					stats->min_nsop = nsop;
+				if (nsop > stats->max_nsop)
+					stats->max_nsop = nsop;
+			}
+		}
+	}
+	stats->secs = best;
+
+	free(threads);
+	return 1;
+}
+
+/*
+ * run_mm_mt - One replay of the trace on a freshly initialized heap.
+ *    Returns the wall-clock time for all threads to finish, or -1 if
+ *    the allocator failed a request.
+ */
+static double run_mm_mt(trace_t *trace, int nthreads, mt_thread_t *threads)
+{
+	pthread_t tid[MAXTHREADS];
+	double first_start = DBL_MAX, last_end = 0, t;
+	int i, failed = 0;
+
+	mem_reset_brk();
+	if (mm_init() < 0)
+		app_error("mm_init failed in run_mm_mt");
+
+	memset(threads, 0, nthreads * sizeof(mt_thread_t));
+	pthread_barrier_init(&mt_barrier, NULL, nthreads + 1);
+	mt_sending = nthreads;
+	for (i = 0; i < nthreads; i++)
+	{
+		threads[i].trace = trace;
+		threads[i].id = i;
+		threads[i].nthreads = nthreads;
+		threads[i].shard = mt_shard;
+		pthread_mutex_init(&threads[i].lock, NULL);
+		if ((threads[i].blocks = calloc(trace->num_ids, sizeof(char *))) == NULL)
+			unix_error("calloc failed in run_mm_mt");
+		if (pthread_create(&tid[i], NULL, mt_worker, &threads[i]) != 0)
+			unix_error("pthread_create failed in run_mm_mt");
+	}
+
+	/*
+	 * Release all threads at once. The run lasts from the first thread
+	 * starting to the last one finishing (the threads' own clocks, since
+	 * this thread may be scheduled late after the barrier).
+	 */
+	pthread_barrier_wait(&mt_barrier);
+	for (i = 0; i < nthreads; i++)
+		pthread_join(tid[i], NULL);
+
+	for (i = 0; i < nthreads; i++)
+	{
+		failed |= threads[i].failed;
+		if ((t = TS_SECS(threads[i].start)) < first_start)
+			first_start = t;
+		if ((t = TS_SECS(threads[i].end)) > last_end)
+			last_end = t;
+		free(threads[i].blocks);
+		pthread_mutex_destroy(&threads[i].lock);
+	}
+	pthread_barrier_destroy(&mt_barrier);
+
+	if (failed)
+	{
+		printf("ERROR: allocator failed a request during the %d-thread replay "
+			   "(a larger MAX_HEAP may be needed)\n", nthreads);
+		return -1;
+	}
+	return last_end - first_start;
+}
+
+/*
+ * mt_worker - Thread body for run_mm_mt
+ */
+static void *mt_worker(void *arg)
+{
+	mt_thread_t *self = (mt_thread_t *)arg;
+	mt_thread_t *next = self - self->id + (self->id + 1) % self->nthreads;
+	trace_t *trace = self->trace;
+	struct timespec end;
+	int i, index, xfree = mt_xfree && self->nthreads > 1;
+	char *p;
+
+	pthread_barrier_wait(&mt_barrier);
+	clock_gettime(CLOCK_MONOTONIC, &self->start);
+
+	for (i = 0; i < trace->num_ops && !self->failed; i++)
+	{
+		index = trace->ops[i].index;
+		if (self->shard && index % self->nthreads != self->id)
+			continue;
+		self->ops++;
+
+		switch (trace->ops[i].type)
+		{
+		case ALLOC: /* mm_malloc */
+			if ((p = mm_malloc(trace->ops[i].size)) == NULL)
+				self->failed = 1;
+			self->blocks[index] = p;
+			break;
+
+		case REALLOC: /* mm_realloc */
+			if ((p = mm_realloc(self->blocks[index], trace->ops[i].size)) == NULL)
+				self->failed = 1;
+			self->blocks[index] = p;
+			break;
+
+		case FREE: /* mm_free, possibly by the next thread */
+			if (xfree)
+				mt_send_free(self, next, self->blocks[index]);
+			else
+				mm_free(self->blocks[index]);
+			self->blocks[index] = NULL;
+			break;
+
+		default:
+			app_error("Nonexistent request type in mt_worker");
+		}
+
+		if (xfree && (i & (XFREE_BATCH - 1)) == 0)
+			mt_drain_inbox(self);
+	}
+
+	if (xfree && self->out != NULL)
+	{ /* hand over the last partial batch */
+		pthread_mutex_lock(&next->lock);
+		self->out->next = next->inbox;
+		__atomic_store_n(&next->inbox, self->out, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&next->queued, 1, __ATOMIC_RELAXED);
+		pthread_mutex_unlock(&next->lock);
+		self->out = NULL;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	self->secs = TS_SECS(end) - TS_SECS(self->start);
+
+	/*
+	 * Keep performing the frees sent to us until nobody can send more,
+	 * then perform the rest. Waiting idle instead would hold back every
+	 * block the previous thread frees until it finishes. A failed
+	 * thread still has to get here so the others are not left waiting.
+	 */
+	if (xfree)
+	{
+		__atomic_sub_fetch(&mt_sending, 1, __ATOMIC_RELEASE);
+		while (__atomic_load_n(&mt_sending, __ATOMIC_ACQUIRE) > 0)
+		{
+			mt_drain_inbox(self);
+			sched_yield();
+		}
+		mt_drain_inbox(self);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+	}
+	self->end = end;
+	return NULL;
+}
+
+/*
+ * mt_send_free - Collect a block for the next thread to free, handing
+ *    the collected blocks over once a batch is full. If the next thread
+ *    falls XFREE_QUEUE batches behind (e.g. it has not been scheduled
+ *    yet), wait for it, so a late thread doesn't make the heap hold every
+ *    block freed in the meantime.
+ */
+static void mt_send_free(mt_thread_t *self, mt_thread_t *dst, char *block)
+{
+	xfree_batch_t *b = self->out;
+
+	if (b == NULL)
+	{
+		if ((b = malloc(sizeof(xfree_batch_t))) == NULL)
+			unix_error("malloc failed in mt_send_free");
+		b->n = 0;
+		self->out = b;
+	}
+	b->blocks[b->n++] = block;
+	if (b->n == XFREE_BATCH)
+	{
+		pthread_mutex_lock(&dst->lock);
+		b->next = dst->inbox;
+		__atomic_store_n(&dst->inbox, b, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&dst->queued, 1, __ATOMIC_RELAXED);
+		pthread_mutex_unlock(&dst->lock);
+		self->out = NULL;
+		while (__atomic_load_n(&dst->queued, __ATOMIC_RELAXED) > XFREE_QUEUE)
+		{ /* keep freeing for our own sender meanwhile */
+			mt_drain_inbox(self);
+			sched_yield();
+		}
+	}
+}
+
+/*
+ * mt_drain_inbox - Free the blocks other threads have handed to us
+ */
+static void mt_drain_inbox(mt_thread_t *self)
+{
+	xfree_batch_t *b, *next;
+	int i;
+
+	if (__atomic_load_n(&self->inbox, __ATOMIC_RELAXED) == NULL)
+		return;
+	pthread_mutex_lock(&self->lock);
+	b = self->inbox;
+	__atomic_store_n(&self->inbox, NULL, __ATOMIC_RELAXED);
+	__atomic_store_n(&self->queued, 0, __ATOMIC_RELAXED);
+	pthread_mutex_unlock(&self->lock);
+
+	for (; b != NULL; b = next)
+	{
+		next = b->next;
+		for (i = 0; i < b->n; i++)
+			mm_free(b->blocks[i]);
+		free(b);
+	}
+}
+
+/*
+ * eval_libc_valid - We run this function to make sure that the
+ *    libc malloc can run to completion on the set of traces.
+ *    We'll be conservative and terminate if any libc malloc call fails.
+ *
+ */
+static int eval_libc_valid(trace_t *trace, int tracenum)
+{
+	int i;
+	size_t newsize;
+	char *p, *newp, *oldp;
+
+	for (i = 0; i < trace->num_ops; i++)
+	{
+		switch (trace->ops[i].type)
+		{
+
+		case ALLOC: /* malloc */
+			if ((p = malloc(trace->ops[i].size)) == NULL)
+			{
+				malloc_error(tracenum, i, "libc malloc failed");
+				unix_error("System message");
+			}
+			trace->blocks[trace->ops[i].index] = p;
+			break;
+
+		case REALLOC: /* realloc */
+			newsize = trace->ops[i].size;
+			oldp = trace->blocks[trace->ops[i].index];
+			if ((newp = realloc(oldp, newsize)) == NULL)
+			{
+				malloc_error(tracenum, i, "libc realloc failed");
+				unix_error("System message");
+			}
+			trace->blocks[trace->ops[i].index] = newp;
+			break;
+
+		case FREE: /* free */
+			free(trace->blocks[trace->ops[i].index]);
+			break;
+
+		default:
+			app_error("invalid operation type  in eval_libc_valid");
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * eval_libc_speed - This is the function that is used by fcyc() to
+ *    measure the running time of the libc malloc package on the set
+ *    of traces.
+ */
+static void eval_libc_speed(void *ptr)
+{
+	int i;
+	int index;
+	size_t size, newsize;
+	char *p, *newp, *oldp, *block;
+	trace_t *trace = ((speed_t *)ptr)->trace;
+
+	for (i = 0; i < trace->num_ops; i++)
+	{
+		switch (trace->ops[i].type)
+		{
+		case ALLOC: /* malloc */
+			index = trace->ops[i].index;
+			size = trace->ops[i].size;
+			if ((p = malloc(size)) == NULL)
+				unix_error("malloc failed in eval_libc_speed");
+			trace->blocks[index] = p;
+			break;
+
+		case REALLOC: /* realloc */
+			index = trace->ops[i].index;
+			newsize = trace->ops[i].size;
+			oldp = trace->blocks[index];
+			if ((newp = realloc(oldp, newsize)) == NULL)
+				unix_error("realloc failed in eval_libc_speed\n");
+
+			trace->blocks[index] = newp;
+			break;
+
+		case FREE: /* free */
+			index = trace->ops[i].index;
+			block = trace->blocks[index];
+			free(block);
+			break;
+		}
+	}
+}
+
+/*************************************
+ * Some miscellaneous helper routines
+ ************************************/
+
+/*
+ * printresults - prints a performance summary for some malloc package
+ */
+static void printresults(int n, stats_t *stats)
+{
+	int i, c;
+	double secs = 0;
+	double ops = 0;
+	double util = 0;
+
+	perf_counts_t perf_total;
+
+	/* Print the individual results for each trace */
+	printf("%5s%7s %5s%8s%10s%6s%8s%8s",
+		   "trace", " valid", "util", "ops", "secs", "Kops", "peakKB", "endKB");
+	if (perf_run)
+	{
+		/* Events per request, after the IPC */
+		printf("%8s%6s", "instr", "IPC");
+		for (i = PERF_L1D_MISSES; i < PERF_NUM_EVENTS; i++)
+			printf("%8s", perf_event_name(i));
+		memset(&perf_total, 0, sizeof(perf_total));
+		perf_total.valid = 1;
+		for (c = 0; c < PERF_NUM_EVENTS; c++)
+			perf_total.have[c] = 1;
+	}
+	printf("\n");
+	for (i = 0; i < n; i++)
+	{
+		if (stats[i].valid)
+		{
+			printf("%2d%10s%5.0f%%%8.0f%10.6f%6.0f",
+				   i,
+				   "yes",
+				   stats[i].util * 100.0,
+				   stats[i].ops,
+				   stats[i].secs,
+				   (stats[i].ops / 1e3) / stats[i].secs);
+			if (stats[i].peak > 0) /* heap sizes are only known for mm.c */
+				printf("%8zu%8zu", stats[i].peak / 1024, stats[i].end / 1024);
+			else
+				printf("%8s%8s", "-", "-");
+			if (perf_run)
+			{
+				printresults_perf(&stats[i].perf, stats[i].ops);
+				for (c = 0; c < PERF_NUM_EVENTS; c++)
+				{
+					perf_total.have[c] &= stats[i].perf.valid && stats[i].perf.have[c];
+					perf_total.count[c] += stats[i].perf.count[c];
+				}
+			}
+			printf("\n");
+			secs += stats[i].secs;
+			ops += stats[i].ops;
+			util += stats[i].util;
+		}
+		else
+		{
+			printf("%2d%10s%6s%8s%10s%6s\n",
+				   i,
+				   "no",
+				   "-",
+				   "-",
+				   "-",
+				   "-");
+		}
+	}
+
+	/* Print the aggregate results for the set of traces */
+	if (errors == 0)
+	{
+		printf("%12s%5.0f%%%8.0f%10.6f%6.0f",
+			   "Total       ",
+			   (util / n) * 100.0,
+			   ops,
+			   secs,
+			   (ops / 1e3) / secs);
+		if (perf_run)
+		{
+			printf("%16s", "");
+			printresults_perf(&perf_total, ops);
+		}
+		printf("\n");
+	}
+	else
+	{
+		printf("%12s%6s%8s%10s%6s\n",
+			   "Total       ",
+			   "-",
+			   "-",
+			   "-",
+			   "-");
+	}
+}
+
+/*
+ * printresults_perf - prints the -p columns of a printresults row: the
+ *     instructions per request, the IPC, and the misses and faults per
+ *     request ("-" for an event that wasn't counted)
+ */
+static void printresults_perf(perf_counts_t *c, double ops)
+{
+	int e;
+
+	if (c->valid && c->have[PERF_INSTRUCTIONS])
+		printf("%8.0f", c->count[PERF_INSTRUCTIONS] / ops);
+	else
+		printf("%8s", "-");
+	if (c->valid && c->have[PERF_INSTRUCTIONS] && c->have[PERF_CYCLES] && c->count[PERF_CYCLES] > 0)
+		printf("%6.2f", c->count[PERF_INSTRUCTIONS] / c->count[PERF_CYCLES]);
+	else
+		printf("%6s", "-");
+	for (e = PERF_L1D_MISSES; e < PERF_NUM_EVENTS; e++)
+		if (c->valid && c->have[e])
+			printf("%8.3f", c->count[e] / ops);
+		else
+			printf("%8s", "-");
+}
+
+/*
+ * printresults_mem - prints how much memory the mmap backend of memlib
+ *    committed for each trace, in commit units (pages): at the heap's
+ *    peak and once the trace finished, plus how much of the heap was
+ *    mapped with huge pages around the peak. Fewer, larger pages mean
+ *    fewer TLB entries to cover the same heap.
+ */
+#if MEM_BACKEND == MEM_MMAP
+static void printresults_mem(int n, stats_t *stats)
+{
+	int i;
+	size_t unit = mem_commit_unit();
+
+	printf("%5s%12s%12s%10s%10s\n",
+		   "trace", "peak pages", "end pages", "peakKB", "hugeKB");
+	for (i = 0; i < n; i++)
+	{
+		if (stats[i].valid)
+			printf("%2d%15zu%12zu%10zu%10zu\n",
+				   i,
+				   stats[i].commit_peak / unit,
+				   stats[i].commit_end / unit,
+				   stats[i].commit_peak / 1024,
+				   stats[i].huge / 1024);
+		else
+			printf("%2d%15s%12s%10s%10s\n", i, "-", "-", "-", "-");
+	}
+}
+#endif
+
+/*
+ * printresults_mt - prints the multi-threaded (-j) summary: aggregate
+ *     throughput, the 1-thread throughput for the same work, scaling
+ *     efficiency (speedup / threads) and per-thread nsecs per op.
+ */
+static void printresults_mt(int n, mt_stats_t *stats)
+{
+	int i;
+
+	printf("%5s%7s%9s%10s%8s%8s%6s%22s\n",
+		   "trace", " valid", "ops", "secs", "Kops", "Kops@1", "eff", "ns/op min/avg/max");
+	for (i = 0; i < n; i++)
+	{
+		if (stats[i].valid)
+			printf("%2d%10s%9.0f%10.6f%8.0f%8.0f%5.0f%%%8.0f/%6.0f/%6.0f\n",
+				   i,
+				   "yes",
+				   stats[i].ops,
+				   stats[i].secs,
+				   (stats[i].ops / 1e3) / stats[i].secs,
+				   (stats[i].ops / 1e3) / stats[i].base_secs,
+				   100.0 * stats[i].base_secs / (stats[i].secs * stats[i].nthreads),
+				   stats[i].min_nsop, stats[i].avg_nsop, stats[i].max_nsop);
+		else
+			printf("%2d%10s%9s%10s%8s%8s%6s%22s\n",
+				   i, "no", "-", "-", "-", "-", "-", "-");
+	}
+}
+
+/*
+ * printresults_batch - prints the batched replay (-n) next to the single
+ *     calls of the throughput run: the share of requests made in batches,
+ *     the mean batch, both throughputs and the speedup
+ */
+static void printresults_batch(int n, stats_t *stats, batch_stats_t *batch)
+{
+	double ops = 0, secs = 0, bsecs = 0;
+	long batched = 0, batches = 0;
+	int i, valid = 0;
+
+	printf("%5s%7s%9s%9s%8s%10s%10s%9s\n",
+		   "trace", " valid", "ops", "batched", "batch", "Kops", "Kops(-n)", "speedup");
+	for (i = 0; i < n; i++)
+	{
+		if (stats[i].valid && batch[i].valid)
+		{
+			printf("%2d%10s%9.0f%8.0f%%%8.1f%10.0f%10.0f%8.2fx\n",
+				   i,
+				   "yes",
+				   stats[i].ops,
+				   100.0 * batch[i].batched / stats[i].ops,
+				   batch[i].batches ? (double)batch[i].batched / batch[i].batches : 0,
+				   (stats[i].ops / 1e3) / stats[i].secs,
+				   (stats[i].ops / 1e3) / batch[i].secs,
+				   stats[i].secs / batch[i].secs);
+			ops += stats[i].ops;
+			secs += stats[i].secs;
+			bsecs += batch[i].secs;
+			batched += batch[i].batched;
+			batches += batch[i].batches;
+			valid++;
+		}
+		else
+			printf("%2d%10s%9s%9s%8s%10s%10s%9s\n",
+				   i, "no", "-", "-", "-", "-", "-", "-");
+	}
+	if (valid > 0)
+		printf("%5s%7s%9.0f%8.0f%%%8.1f%10.0f%10.0f%8.2fx\n",
+			   "Total", "",
+			   ops,
+			   100.0 * batched / ops,
+			   batches ? (double)batched / batches : 0,
+			   (ops / 1e3) / secs,
+			   (ops / 1e3) / bsecs,
+			   secs / bsecs);
+}
+
+/*
+ * printresults_region - prints the request-scoped replay (-r): objects
+ *     per second and the largest heap with an mm_free per object and
+ *     with a region reset per request, and the speedup of the region
+ */
+static void printresults_region(int n, region_stats_t *stats)
+{
+	double objs = 0, free_secs = 0, region_secs = 0;
+	int i, valid = 0;
+
+	printf("%5s%7s%9s%10s%10s%9s%9s%9s\n",
+		   "trace", " valid", "objects", "Kobj/s", "(region)", "speedup", "peakKB", "(region)");
+	for (i = 0; i < n; i++)
+	{
+		if (stats[i].valid)
+		{
+			printf("%2d%10s%9ld%10.0f%10.0f%8.2fx%9zu%9zu\n",
+				   i,
+				   "yes",
+				   stats[i].objs,
+				   (stats[i].objs / 1e3) / stats[i].free_secs,
+				   (stats[i].objs / 1e3) / stats[i].region_secs,
+				   stats[i].free_secs / stats[i].region_secs,
+				   stats[i].free_peak / 1024,
+				   stats[i].region_peak / 1024);
+			objs += stats[i].objs;
+			free_secs += stats[i].free_secs;
+			region_secs += stats[i].region_secs;
+			valid++;
+		}
+		else
+			printf("%2d%10s%9s%10s%10s%9s%9s%9s\n",
+				   i, "no", "-", "-", "-", "-", "-", "-");
+	}
+	if (valid > 0)
+		printf("%5s%7s%9.0f%10.0f%10.0f%8.2fx\n",
+			   "Total", "", objs, (objs / 1e3) / free_secs, (objs / 1e3) / region_secs, free_secs / region_secs);
+}
+
+/*
+ * printresults_align - prints the -z replays next to the throughput run:
+ *     the throughput with mm_free, with mm_free_sized, and with aligned
+ *     mallocs and sized frees, and the largest heap without and with
+ *     the alignment
+ */
+static void printresults_align(int n, stats_t *stats, align_stats_t *align)
+{
+	double ops = 0, secs = 0, sized_secs = 0, aligned_secs = 0;
+	int i, valid = 0;
+
+	printf("%5s%7s%9s%10s%10s%10s%9s%10s\n",
+		   "trace", " valid", "ops", "Kops", "(sized)", "(aligned)", "peakKB", "(aligned)");
+	for (i = 0; i < n; i++)
+	{
+		if (stats[i].valid && align[i].valid)
+		{
+			printf("%2d%10s%9.0f%10.0f%10.0f%10.0f%9zu%10zu\n",
+				   i,
+				   "yes",
+				   stats[i].ops,
+				   (stats[i].ops / 1e3) / stats[i].secs,
+				   (stats[i].ops / 1e3) / align[i].sized_secs,
+				   (stats[i].ops / 1e3) / align[i].aligned_secs,
+				   stats[i].peak / 1024,
+				   align[i].peak / 1024);
+			ops += stats[i].ops;
+			secs += stats[i].secs;
+			sized_secs += align[i].sized_secs;
+			aligned_secs += align[i].aligned_secs;
+			valid++;
+		}
+		else
+			printf("%2d%10s%9s%10s%10s%10s%9s%10s\n",
+				   i, "no", "-", "-", "-", "-", "-", "-");
+	}
+	if (valid > 0)
+		printf("%5s%7s%9.0f%10.0f%10.0f%10.0f\n",
+			   "Total", "", ops, (ops / 1e3) / secs, (ops / 1e3) / sized_secs,
+			   (ops / 1e3) / aligned_secs);
+}
+
+/*
+ * printresults_prof - prints the -H profiles: the allocations sampled
+ *     up to each trace's peak, the sampled blocks live at the peak,
+ *     and the live bytes they stand for next to the real count
+ */
+static void printresults_prof(int n, prof_stats_t *stats)
+{
+	int i;
+
+	printf("%5s%7s%9s%7s%9s%9s%8s\n",
+		   "trace", " valid", "samples", "live", "peakKB", "estKB", "error");
+	for (i = 0; i < n; i++)
+	{
+		if (stats[i].valid)
+			printf("%2d%10s%9zu%7zu%9zu%9.0f%7.1f%%\n",
+				   i,
+				   "yes",
+				   stats[i].samples,
+				   stats[i].live,
+				   stats[i].peak / 1024,
+				   stats[i].est / 1024,
+				   stats[i].peak ? 100 * (stats[i].est - stats[i].peak) / stats[i].peak : 0);
+		else
+			printf("%2d%10s%9s%7s%9s%9s%8s\n",
+				   i, "no", "-", "-", "-", "-", "-");
+	}
+}
+
+/*
+ * printresults_bench - prints the median throughput of each trace
+ *     with its 95% confidence interval, and the median cycle counter
+ *     ticks per request
+ */
+static void printresults_bench(int n, bench_result_t *r)
+{
+	int i;
+
+	printf("%5s %7s %10s %23s %8s %9s\n",
+		   "trace", "runs", "Kops", "95% CI", "+/-", "cyc/op");
+	for (i = 0; i < n; i++)
+		printf("%5d %7d %10.0f [%10.0f,%10.0f] %7.1f%% %9.1f\n",
+			   i, r[i].samples, r[i].kops, r[i].kops_lo, r[i].kops_hi,
+			   50 * (r[i].kops_hi - r[i].kops_lo) / r[i].kops, r[i].cycles_per_op);
+}
+
+/*
+ * printresults_backends - prints the -A comparison: for each backend,
+ *     the traces it ran correctly, its mean utilization and largest
+ *     heap (for backends on memlib's heap), its throughput over those
+ *     traces and the percentiles of its request latency in cycles.
+ *     With -v, also the throughput and utilization of each trace.
+ */
+static void printresults_backends(int nb, backend_stats_t *bs, int n)
+{
+	double ops, secs, util;
+	size_t peak;
+	int i, j, valid;
+	stats_t *s;
+
+	printf("%-10s%7s%6s%9s%9s%8s%8s%8s%8s%10s\n",
+		   "backend", "valid", "util", "Kops", "peakKB", "p50", "p90", "p99", "p99.9", "max");
+	for (j = 0; j < nb; j++)
+	{
+		ops = secs = util = 0;
+		peak = 0;
+		for (i = valid = 0; i < n; i++)
+		{
+			s = &bs[j].traces[i];
+			if (!s->valid)
+				continue;
+			valid++;
+			ops += s->ops;
+			secs += s->secs;
+			util += s->util;
+			peak = (s->peak > peak) ? s->peak : peak;
+		}
+		printf("%-10s%4d/%-2d", bs[j].be->name, valid, n);
+		if (valid && bs[j].be->heap)
+			printf("%5.0f%%", util / valid * 100.0);
+		else
+			printf("%6s", "-");
+		if (valid)
+			printf("%9.0f", (ops / 1e3) / secs);
+		else
+			printf("%9s", "-");
+		if (valid && bs[j].be->heap)
+			printf("%9zu", peak / 1024);
+		else
+			printf("%9s", "-");
+		if (bs[j].lat.count > 0)
+			printf("%8llu%8llu%8llu%8llu%10llu\n",
+				   hist_percentile(&bs[j].lat, 0.50),
+				   hist_percentile(&bs[j].lat, 0.90),
+				   hist_percentile(&bs[j].lat, 0.99),
+				   hist_percentile(&bs[j].lat, 0.999),
+				   bs[j].lat.max);
+		else
+			printf("%8s%8s%8s%8s%10s\n", "-", "-", "-", "-", "-");
+	}
+
+	if (!verbose)
+		return;
+	printf("\nKops (util) of each trace:\n%5s", "trace");
+	for (j = 0; j < nb; j++)
+		printf("%14s", bs[j].be->name);
+	printf("\n");
+	for (i = 0; i < n; i++)
+	{
+		printf("%5d", i);
+		for (j = 0; j < nb; j++)
+		{
+			s = &bs[j].traces[i];
+			if (!s->valid)
+				printf("%14s", "-");
+			else if (bs[j].be->heap)
+				printf("%8.0f (%2.0f%%)", (s->ops / 1e3) / s->secs, s->util * 100.0);
+			else
+				printf("%8.0f      ", (s->ops / 1e3) / s->secs);
+		}
+		printf("\n");
+	}
+}
+
+/*
+ * bench_config - describes the allocator build options in buf, to
+ *     record in a baseline what the numbers were measured with
+ */
+static void bench_config(char *buf, size_t len)
+{
+	snprintf(buf, len, "FIT_POLICY=%d TREE_MIN_SIZE=%d SLAB_MAX_SIZE=%d "
+			 "MMAP_THRESHOLD=%ld DEFER_COALESCE=%d FOOTERLESS_ALLOC=%d "
+			 "MM_THREADS=%d MM_ARENAS=%d MM_CHECK=%d MEM_BACKEND=%d MAX_HEAP=%zu",
+			 FIT_POLICY, TREE_MIN_SIZE, SLAB_MAX_SIZE, (long)MMAP_THRESHOLD,
+			 DEFER_COALESCE, FOOTERLESS_ALLOC, MM_THREADS, MM_ARENAS, MM_CHECK,
+			 MEM_BACKEND, (size_t)MAX_HEAP);
+}
+
+/*
+ * printresults_lat - prints per-request latency percentiles (in
+ *     cycles) for each trace and request type, followed by the totals
+ *     over all traces
+ */
+static void printresults_lat(int n, lat_stats_t *stats)
+{
+	hist_t total[NUM_OPTYPES];
+	hist_t *h;
+	int i, t;
+
+	for (t = 0; t < NUM_OPTYPES; t++)
+		hist_reset(&total[t]);
+
+	printf("%5s %-8s%8s%8s%8s%8s%8s%10s\n",
+		   "trace", "op", "count", "mean", "p50", "p99", "p99.9", "max");
+	for (i = 0; i <= n; i++)
+	{
+		if (i < n && !stats[i].valid)
+		{
+			printf("%2d%10s%8s%8s%8s%8s%8s%10s\n",
+				   i, "-", "-", "-", "-", "-", "-", "-");
+			continue;
+		}
+		for (t = 0; t < NUM_OPTYPES; t++)
+		{
+			h = (i < n) ? &stats[i].ops[t] : &total[t];
+			if (h->count == 0)
+				continue;
+			if (i < n)
+			{
+				hist_merge(&total[t], h);
+				printf("%2d    ", i);
+			}
+			else
+				printf("Total ");
+			printf("%-8s%8llu%8.0f%8llu%8llu%8llu%10llu\n",
+				   optype_names[t],
+				   h->count,
+				   hist_mean(h),
+				   hist_percentile(h, 0.50),
+				   hist_percentile(h, 0.99),
+				   hist_percentile(h, 0.999),
+				   h->max);
+		}
+	}
+}
+
+/*
+ * write_lat_csv - writes the per-request latency percentiles (cycles)
+ *     as CSV, one row per trace and request type, so that runs of
+ *     different allocator versions can be compared
+ */
+static void write_lat_csv(char *filename, int n, char **tracefiles, lat_stats_t *stats)
+{
+	FILE *fp;
+	hist_t *h;
+	int i, t;
+
+	if ((fp = fopen(filename, "w")) == NULL)
+		unix_error("Could not open latency CSV file");
+	fprintf(fp, "trace,file,op,count,min,mean,p50,p90,p99,p99.9,max\n");
+	for (i = 0; i < n; i++)
+	{
+		if (!stats[i].valid)
+			continue;
+		for (t = 0; t < NUM_OPTYPES; t++)
+		{
+			h = &stats[i].ops[t];
+			if (h->count == 0)
+				continue;
+			fprintf(fp, "%d,\"%s\",%s,%llu,%llu,%.1f,%llu,%llu,%llu,%llu,%llu\n",
+					i, tracefiles[i], optype_names[t],
+					h->count, h->min, hist_mean(h),
+					hist_percentile(h, 0.50),
+					hist_percentile(h, 0.90),
+					hist_percentile(h, 0.99),
+					hist_percentile(h, 0.999),
+					h->max);
+		}
+	}
+	fclose(fp);
+}
+
+/*
+ * app_error - Report an arbitrary application error
+ */
+void app_error(char *msg)
+{
+	printf("%s\n", msg);
+	exit(1);
+}
+
+/*
+ * unix_error - Report a Unix-style error
+ */
+void unix_error(char *msg)
+{
+	printf("%s: %s\n", msg, strerror(errno));
+	exit(1);
+}
+
+/*
+ * malloc_error - Report an error returned by the mm_malloc package
+ */
+void malloc_error(int tracenum, long opnum, char *msg)
+{
+	errors++;
+	printf("ERROR [trace %d, line %ld]: %s\n", tracenum, LINENUM(opnum), msg);
+}
+
+/*
+ * usage - Explain the command line arguments
+ */
+static void usage(void)
+{
+	fprintf(stderr, "Usage: mdriver [-hvValLnpS] [-f <file>] [-t <dir>] [-c <csv>] [-j <n> [-sx]]\n"
+					"               [-m <n> [-M <csv>]] [-C <level> [-K <n>]] [-G <spec>]... [-A <list>]\n"
+					"               [-b <n> [-w <n>] [-P <cpu>] [-B <json>] [-R <json> [-T <pct>]]] [-r <n>] [-z <align>]\n"
+					"               [-H <file> [-I <bytes>]]\n");
+	fprintf(stderr, "Options\n");
+	fprintf(stderr, "\t-a         Don't check the team structure.\n");
+	fprintf(stderr, "\t-A <list>  Compare the comma-separated backends below instead.\n");
+	fprintf(stderr, "\t-b <n>     Benchmark: time each trace <n> times, pinned to one CPU.\n");
+	fprintf(stderr, "\t-B <json>  With -b, save the results as a baseline.\n");
+	fprintf(stderr, "\t-C <level> Call mm_check(<level>) during the correctness run.\n");
+	fprintf(stderr, "\t-c <csv>   Write the -L latency percentiles to <csv> (implies -L).\n");
+	fprintf(stderr, "\t-f <file>  Use <file> as the trace file.\n");
+	fprintf(stderr, "\t-g         Generate summary info for autograder.\n");
+	fprintf(stderr, "\t-G <spec>  Add a trace generated from workload <spec> (see workload.h).\n");
+	fprintf(stderr, "\t-h         Print this message.\n");
+	fprintf(stderr, "\t-H <file>  Write a heap profile of each trace at its peak to <file>.<n>.\n");
+	fprintf(stderr, "\t-I <bytes> With -H, sample once per <bytes> allocated on average.\n");
+	fprintf(stderr, "\t-j <n>     Also replay each trace on <n> threads (needs MM_THREADS).\n");
+	fprintf(stderr, "\t-K <n>     With -C, call mm_check every <n> ops (default 1).\n");
+	fprintf(stderr, "\t-l         Run libc malloc as well.\n");
+	fprintf(stderr, "\t-L         Time each request and print latency percentiles.\n");
+	fprintf(stderr, "\t-m <n>     Sample heap statistics (mm_stats) every <n> ops.\n");
+	fprintf(stderr, "\t-M <csv>   Write the -m samples to <csv> (default mm_stats.csv).\n");
+	fprintf(stderr, "\t-n         Also replay with mm_malloc_batch/mm_free_batch and compare.\n");
+	fprintf(stderr, "\t-p         Count hardware events per request (perf_event_open).\n");
+	fprintf(stderr, "\t-P <cpu>   With -b, pin to <cpu> (default: the one mdriver starts on).\n");
+	fprintf(stderr, "\t-r <n>     Also replay the sizes in requests of <n> objects, freed together.\n");
+	fprintf(stderr, "\t-R <json>  With -b, compare with a baseline; exit 1 on a regression.\n");
+	fprintf(stderr, "\t-s         With -j, shard one trace across the threads.\n");
+	fprintf(stderr, "\t-S         Stream the traces from disk instead of loading them.\n");
+	fprintf(stderr, "\t-t <dir>   Directory to find default traces.\n");
+	fprintf(stderr, "\t-T <pct>   With -R, the regression threshold (default 5%%).\n");
+	fprintf(stderr, "\t-v         Print per-trace performance breakdowns.\n");
+	fprintf(stderr, "\t-V         Print additional debug info.\n");
+	fprintf(stderr, "\t-w <n>     With -b, untimed warmup runs per trace (default 2).\n");
+	fprintf(stderr, "\t-x         With -j, free each block on another thread.\n");
+	fprintf(stderr, "\t-z <align> Also replay with mm_free_sized and mm_aligned_alloc(<align>).\n");
+	fprintf(stderr, "Backends (-A)\n");
+	backend_list(stderr);
+}
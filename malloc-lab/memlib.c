@@ -1,101 +1,510 @@
-/*
- * memlib.c - a module that simulates the memory system.  Needed because it 
- *            allows us to interleave calls from the student's malloc package 
- *            with the system's malloc package in libc.
- */
-#include <stdio.h>
-#include <stdlib.h>
-#include <assert.h>
-#include <unistd.h>
-#include <sys/mman.h>
-#include <string.h>
-#include <errno.h>
-
-#include "memlib.h"
-#include "config.h"
-
-/* private variables */
-static char *mem_start_brk;  /* points to first byte of heap */
-static char *mem_brk;        /* points to last byte of heap */
-static char *mem_max_addr;   /* largest legal heap address */ 
-
-/* 
- * mem_init - initialize the memory system model
- */
-void mem_init(void)
-{
-    /* allocate the storage we will use to model the available VM */
-    if ((mem_start_brk = (char *)malloc(MAX_HEAP)) == NULL) {
-	fprintf(stderr, "mem_init_vm: malloc error\n");
-	exit(1);
-    }
-
-    mem_max_addr = mem_start_brk + MAX_HEAP;  /* max legal heap address */
-    mem_brk = mem_start_brk;                  /* heap is empty initially */
-}
-
-/* 
- * mem_deinit - free the storage used by the memory system model
- */
-void mem_deinit(void)
-{
-    free(mem_start_brk);
-}
-
-/*
- * mem_reset_brk - reset the simulated brk pointer to make an empty heap
- */
-void mem_reset_brk()
-{
-    mem_brk = mem_start_brk;
-}
-
-/* 
- * mem_sbrk - simple model of the sbrk function. Extends the heap 
- *    by incr bytes and returns the start address of the new area. In
- *    this model, the heap cannot be shrunk.
- */
-void *mem_sbrk(int incr) 
-{
-    char *old_brk = mem_brk;
-
-    if ( (incr < 0) || ((mem_brk + incr) > mem_max_addr)) {
-	errno = ENOMEM;
-	fprintf(stderr, "ERROR: mem_sbrk failed. Ran out of memory...\n");
-	return (void *)-1;
-    }
-    mem_brk += incr;
-    return (void *)old_brk;
-}
-
-/*
- * mem_heap_lo - return address of the first heap byte
- */
-void *mem_heap_lo()
-{
-    return (void *)mem_start_brk;
-}
-
-/* 
- * mem_heap_hi - return address of last heap byte
- */
-void *mem_heap_hi()
-{
-    return (void *)(mem_brk - 1);
-}
-
-/*
- * mem_heapsize() - returns the heap size in bytes
- */
-size_t mem_heapsize() 
-{
-    return (size_t)(mem_brk - mem_start_brk);
-}
-
-/*
- * mem_pagesize() - returns the page size of the system
- */
-size_t mem_pagesize()
-{
-    return (size_t)getpagesize();
-}
+/*
+ * memlib.c - a module that simulates the memory system.  Needed because it 
+ *            allows us to interleave calls from the student's malloc package 
+ *            with the system's malloc package in libc.
+ */
+#define _GNU_SOURCE          /* mremap */
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "memlib.h"
+#include "config.h"
+
+/* private variables */
+static char *mem_start_brk;  /* points to first byte of heap */
+static char *mem_brk;        /* points to last byte of heap */
+static char *mem_max_addr;   /* largest legal heap address */ 
+static size_t mem_peak;      /* largest footprint since the last reset */
+
+/* Mappings handed out by mem_map, outside the heap */
+typedef struct mem_mapping {
+    char *base;
+    size_t len;
+    struct mem_mapping *next;
+} mem_mapping_t;
+
+static mem_mapping_t *mem_maps;  /* live mappings */
+static size_t mem_map_bytes;     /* their total length */
+static pthread_mutex_t mem_map_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * mem_raise_peak - record a footprint (heap plus mappings) of n bytes
+ */
+static void mem_raise_peak(size_t n)
+{
+    size_t peak = __atomic_load_n(&mem_peak, __ATOMIC_RELAXED);
+
+    while (n > peak &&
+	   !__atomic_compare_exchange_n(&mem_peak, &peak, n,
+					1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+	;
+}
+
+#if MEM_BACKEND == MEM_MMAP
+#define HUGE_UNIT ((size_t)2 << 20)  /* x86-64 huge page size */
+
+static char *mem_commit_brk;   /* [mem_start_brk, mem_commit_brk) is committed */
+static char *mem_commit_max;   /* highest mem_commit_brk since the last reset */
+static size_t mem_unit;        /* commit granularity, a power of two */
+static char *mem_map_base;     /* the whole reservation, for munmap */
+static size_t mem_map_len;
+static int mem_hugetlb;        /* heap came from the hugetlbfs pool */
+
+/* Commits and releases are serialized so that mem_trim's madvise can
+ * never zero pages a concurrent mem_sbrk has just handed out */
+static pthread_mutex_t mem_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#define UNIT_UP(p) ((char *)(((size_t)(p) + mem_unit - 1) & ~(mem_unit - 1)))
+
+/*
+ * mem_decommit - give the committed pages above p back to the kernel
+ *    and make them inaccessible again. Called with mem_lock held.
+ */
+static void mem_decommit(char *p)
+{
+    char *lo = UNIT_UP(p);
+
+    if (lo >= mem_commit_brk)
+	return;
+    madvise(lo, mem_commit_brk - lo, MADV_DONTNEED);
+    mprotect(lo, mem_commit_brk - lo, PROT_NONE);
+    mem_commit_brk = lo;
+}
+#endif
+
+/* 
+ * mem_init - initialize the memory system model
+ */
+void mem_init(void)
+{
+#if MEM_BACKEND == MEM_MMAP
+    /* reserve address space only; mem_sbrk commits it as the heap grows */
+    char *p = MAP_FAILED;
+
+    mem_unit = MEM_HUGEPAGE ? HUGE_UNIT : mem_pagesize();
+    mem_map_len = ((MAX_HEAP + mem_unit - 1) & ~(mem_unit - 1)) + mem_unit;
+#if MEM_HUGEPAGE == 2 && defined(MAP_HUGETLB)
+    /* a private hugetlb mapping reserves its pool pages up front, so
+     * an undersized pool fails here rather than faulting later */
+    p = mmap(NULL, mem_map_len, PROT_NONE,
+	     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    mem_hugetlb = (p != MAP_FAILED);
+#endif
+    if (p == MAP_FAILED)
+	p = mmap(NULL, mem_map_len, PROT_NONE,
+		 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) {
+	fprintf(stderr, "mem_init_vm: mmap error\n");
+	exit(1);
+    }
+    mem_map_base = p;
+    mem_start_brk = UNIT_UP(p);  /* huge pages need an aligned heap */
+#if MEM_HUGEPAGE && defined(MADV_HUGEPAGE)
+    if (!mem_hugetlb)
+	madvise(mem_start_brk, mem_map_len - mem_unit, MADV_HUGEPAGE);
+#endif
+    mem_commit_brk = mem_commit_max = mem_start_brk;
+#else
+    /* allocate the storage we will use to model the available VM */
+    if ((mem_start_brk = (char *)malloc(MAX_HEAP)) == NULL) {
+	fprintf(stderr, "mem_init_vm: malloc error\n");
+	exit(1);
+    }
+#endif
+
+    mem_max_addr = mem_start_brk + MAX_HEAP;  /* max legal heap address */
+    mem_brk = mem_start_brk;                  /* heap is empty initially */
+    mem_peak = 0;
+}
+
+/* 
+ * mem_deinit - free the storage used by the memory system model
+ */
+void mem_deinit(void)
+{
+#if MEM_BACKEND == MEM_MMAP
+    munmap(mem_map_base, mem_map_len);
+#else
+    free(mem_start_brk);
+#endif
+}
+
+/*
+ * mem_reset_brk - reset the simulated brk pointer to make an empty heap,
+ *    and unmap every mapping left by mem_map
+ */
+void mem_reset_brk()
+{
+    mem_mapping_t *m, *next;
+
+    pthread_mutex_lock(&mem_map_lock);
+    for (m = mem_maps; m != NULL; m = next) {
+	next = m->next;
+	munmap(m->base, m->len);
+	free(m);
+    }
+    mem_maps = NULL;
+    mem_map_bytes = 0;
+    pthread_mutex_unlock(&mem_map_lock);
+
+#if MEM_BACKEND == MEM_MMAP
+    pthread_mutex_lock(&mem_lock);
+    mem_decommit(mem_start_brk);
+    mem_commit_max = mem_start_brk;
+    pthread_mutex_unlock(&mem_lock);
+#endif
+    mem_brk = mem_start_brk;
+    mem_peak = 0;
+}
+
+/* 
+ * mem_sbrk - simple model of the sbrk function. Extends the heap 
+ *    by incr bytes and returns the start address of the new area.
+ *    The heap is shrunk with mem_trim. The brk pointer is bumped
+ *    with a compare-and-swap, so concurrent callers each get their own
+ *    disjoint area.
+ */
+void *mem_sbrk(size_t incr) 
+{
+    char *old_brk = __atomic_load_n(&mem_brk, __ATOMIC_RELAXED);
+
+    do {
+	if (incr > (size_t)(mem_max_addr - old_brk)) {
+	    errno = ENOMEM;
+	    fprintf(stderr, "ERROR: mem_sbrk failed. Ran out of memory...\n");
+	    return (void *)-1;
+	}
+    } while (!__atomic_compare_exchange_n(&mem_brk, &old_brk, old_brk + incr,
+					  1, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    /* Raise the high-water mark */
+    mem_raise_peak((size_t)(old_brk + incr - mem_start_brk) +
+		   __atomic_load_n(&mem_map_bytes, __ATOMIC_RELAXED));
+
+#if MEM_BACKEND == MEM_MMAP
+    /* Commit the pages under the new area that are not committed yet */
+    pthread_mutex_lock(&mem_lock);
+    if (old_brk + incr > mem_commit_brk) {
+	char *hi = UNIT_UP(old_brk + incr);
+
+	if (mprotect(mem_commit_brk, hi - mem_commit_brk, PROT_READ | PROT_WRITE) < 0) {
+	    char *new_brk = old_brk + incr;
+
+	    /* give the area back unless another area was handed out after it */
+	    __atomic_compare_exchange_n(&mem_brk, &new_brk, old_brk,
+					0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+	    pthread_mutex_unlock(&mem_lock);
+	    errno = ENOMEM;
+	    fprintf(stderr, "ERROR: mem_sbrk failed. Could not commit pages...\n");
+	    return (void *)-1;
+	}
+	mem_commit_brk = hi;
+	if (hi > mem_commit_max)
+	    mem_commit_max = hi;
+    }
+    pthread_mutex_unlock(&mem_lock);
+#endif
+    return (void *)old_brk;
+}
+
+/*
+ * mem_trim - the negative counterpart of mem_sbrk: gives the last decr
+ *    bytes of the heap back. The caller names the current end of the
+ *    heap, and the trim fails if the heap no longer ends there, so an
+ *    area handed out by a concurrent mem_sbrk is never taken back.
+ *    Returns 0 on success and -1 on failure.
+ */
+int mem_trim(void *end, size_t decr)
+{
+    char *expected = (char *)end;
+
+    if (decr > (size_t)(expected - mem_start_brk)) {
+	errno = EINVAL;
+	return -1;
+    }
+#if MEM_BACKEND == MEM_MMAP
+    pthread_mutex_lock(&mem_lock);
+#endif
+    if (!__atomic_compare_exchange_n(&mem_brk, &expected, expected - decr,
+				     0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+#if MEM_BACKEND == MEM_MMAP
+	pthread_mutex_unlock(&mem_lock);
+#endif
+	return -1;
+    }
+#if MEM_BACKEND == MEM_MMAP
+    mem_decommit(expected - decr);  /* whole commit units above the new brk */
+    pthread_mutex_unlock(&mem_lock);
+#endif
+    return 0;
+}
+
+/*
+ * mem_map - hand out a fresh zero-filled mapping of len bytes (a
+ *    multiple of the page size) outside the heap, for blocks too big
+ *    to keep in it. Returns NULL if the system is out of memory.
+ */
+void *mem_map(size_t len)
+{
+    mem_mapping_t *m;
+    char *p;
+
+    if ((m = malloc(sizeof(mem_mapping_t))) == NULL)
+	return NULL;
+    p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+	free(m);
+	return NULL;
+    }
+#if MEM_BACKEND == MEM_MMAP && MEM_HUGEPAGE && defined(MADV_HUGEPAGE)
+    if (len >= HUGE_UNIT)
+	madvise(p, len, MADV_HUGEPAGE);
+#endif
+    m->base = p;
+    m->len = len;
+    pthread_mutex_lock(&mem_map_lock);
+    m->next = mem_maps;
+    mem_maps = m;
+    __atomic_store_n(&mem_map_bytes, mem_map_bytes + len, __ATOMIC_RELAXED);
+    mem_raise_peak(mem_heapsize() + mem_map_bytes);
+    pthread_mutex_unlock(&mem_map_lock);
+    return p;
+}
+
+/*
+ * mem_find_map - the link that points at the mapping starting at p.
+ *    Called with mem_map_lock held.
+ */
+static mem_mapping_t **mem_find_map(void *p)
+{
+    mem_mapping_t **mp;
+
+    for (mp = &mem_maps; *mp != NULL; mp = &(*mp)->next)
+	if ((*mp)->base == p)
+	    return mp;
+    return NULL;
+}
+
+/*
+ * mem_unmap - give back a mapping from mem_map. Returns 0 on success,
+ *    -1 if p does not start one.
+ */
+int mem_unmap(void *p)
+{
+    mem_mapping_t **mp, *m;
+
+    pthread_mutex_lock(&mem_map_lock);
+    if ((mp = mem_find_map(p)) == NULL) {
+	pthread_mutex_unlock(&mem_map_lock);
+	errno = EINVAL;
+	return -1;
+    }
+    m = *mp;
+    *mp = m->next;
+    __atomic_store_n(&mem_map_bytes, mem_map_bytes - m->len, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&mem_map_lock);
+    munmap(m->base, m->len);
+    free(m);
+    return 0;
+}
+
+/*
+ * mem_remap - resize a mapping from mem_map to len bytes, moving it if
+ *    it cannot grow in place. The kernel moves the pages, so nothing is
+ *    copied. Returns the (possibly new) start, or NULL on failure, in
+ *    which case the old mapping is left alone.
+ */
+void *mem_remap(void *p, size_t len)
+{
+    mem_mapping_t **mp, *m;
+    char *q;
+
+    pthread_mutex_lock(&mem_map_lock);
+    if ((mp = mem_find_map(p)) == NULL) {
+	pthread_mutex_unlock(&mem_map_lock);
+	errno = EINVAL;
+	return NULL;
+    }
+    m = *mp;
+#ifdef MREMAP_MAYMOVE
+    q = mremap(m->base, m->len, len, MREMAP_MAYMOVE);
+#else
+    q = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (q != MAP_FAILED) {
+	memcpy(q, m->base, len < m->len ? len : m->len);
+	munmap(m->base, m->len);
+    }
+#endif
+    if (q == MAP_FAILED) {
+	pthread_mutex_unlock(&mem_map_lock);
+	return NULL;
+    }
+    __atomic_store_n(&mem_map_bytes, mem_map_bytes - m->len + len, __ATOMIC_RELAXED);
+    m->base = q;
+    m->len = len;
+    mem_raise_peak(mem_heapsize() + mem_map_bytes);
+    pthread_mutex_unlock(&mem_map_lock);
+    return q;
+}
+
+/*
+ * mem_mapped - returns the total length of the live mem_map mappings
+ */
+size_t mem_mapped()
+{
+    return __atomic_load_n(&mem_map_bytes, __ATOMIC_RELAXED);
+}
+
+/*
+ * mem_contains - returns 1 if the bytes lo..hi (inclusive) lie inside
+ *    the heap or inside a single mem_map mapping, 0 otherwise
+ */
+int mem_contains(void *lo, void *hi)
+{
+    mem_mapping_t *m;
+    char *l = lo, *h = hi;
+    int found = 0;
+
+    if (l >= mem_start_brk && h < mem_start_brk + mem_heapsize())
+	return 1;
+    pthread_mutex_lock(&mem_map_lock);
+    for (m = mem_maps; m != NULL && !found; m = m->next)
+	found = l >= m->base && h < m->base + m->len;
+    pthread_mutex_unlock(&mem_map_lock);
+    return found;
+}
+
+/*
+ * mem_heap_lo - return address of the first heap byte
+ */
+void *mem_heap_lo()
+{
+    return (void *)mem_start_brk;
+}
+
+/* 
+ * mem_heap_hi - return address of last heap byte
+ */
+void *mem_heap_hi()
+{
+    return (void *)(__atomic_load_n(&mem_brk, __ATOMIC_ACQUIRE) - 1);
+}
+
+/*
+ * mem_heapsize() - returns the heap size in bytes
+ */
+size_t mem_heapsize() 
+{
+    return (size_t)(__atomic_load_n(&mem_brk, __ATOMIC_ACQUIRE) - mem_start_brk);
+}
+
+/*
+ * mem_heap_peak() - returns the largest footprint in bytes (the heap
+ *    plus the mem_map mappings) since the heap was last reset
+ */
+size_t mem_heap_peak()
+{
+    return __atomic_load_n(&mem_peak, __ATOMIC_RELAXED);
+}
+
+/*
+ * mem_committed() - returns the number of heap bytes currently backed
+ *    by committed memory (all of MAX_HEAP for the malloc backend)
+ */
+size_t mem_committed()
+{
+#if MEM_BACKEND == MEM_MMAP
+    pthread_mutex_lock(&mem_lock);
+    size_t n = mem_commit_brk - mem_start_brk;
+    pthread_mutex_unlock(&mem_lock);
+    return n;
+#else
+    return MAX_HEAP;
+#endif
+}
+
+/*
+ * mem_commit_peak() - returns the largest mem_committed() since the
+ *    heap was last reset
+ */
+size_t mem_commit_peak()
+{
+#if MEM_BACKEND == MEM_MMAP
+    pthread_mutex_lock(&mem_lock);
+    size_t n = mem_commit_max - mem_start_brk;
+    pthread_mutex_unlock(&mem_lock);
+    return n;
+#else
+    return MAX_HEAP;
+#endif
+}
+
+/*
+ * mem_commit_unit() - returns the granularity in which heap pages are
+ *    committed and released
+ */
+size_t mem_commit_unit()
+{
+#if MEM_BACKEND == MEM_MMAP
+    return mem_unit;
+#else
+    return mem_pagesize();
+#endif
+}
+
+/*
+ * mem_backend() - returns a short description of where the heap's
+ *    memory comes from, e.g. "mmap, THP"
+ */
+const char *mem_backend()
+{
+#if MEM_BACKEND == MEM_MMAP
+    if (mem_hugetlb)
+	return "mmap, hugetlbfs";
+    return MEM_HUGEPAGE ? "mmap, THP" : "mmap";
+#else
+    return "malloc";
+#endif
+}
+
+/*
+ * mem_huge_bytes() - returns how many bytes of the heap are currently
+ *    mapped with huge pages, as the kernel reports in /proc/self/smaps,
+ *    or 0 if that cannot be read
+ */
+size_t mem_huge_bytes()
+{
+#if MEM_BACKEND == MEM_MMAP
+    if (mem_hugetlb)
+	return mem_committed();
+#endif
+    FILE *fp;
+    char line[256];
+    size_t lo, hi, kb, total = 0;
+    int inside = 0;
+
+    if ((fp = fopen("/proc/self/smaps", "r")) == NULL)
+	return 0;
+    while (fgets(line, sizeof(line), fp) != NULL) {
+	if (sscanf(line, "%zx-%zx ", &lo, &hi) == 2)  /* a new mapping */
+	    inside = lo < (size_t)mem_max_addr && hi > (size_t)mem_start_brk;
+	else if (inside && sscanf(line, "AnonHugePages: %zu kB", &kb) == 1)
+	    total += kb * 1024;
+    }
+    fclose(fp);
+    return total;
+}
+
+/*
+ * mem_pagesize() - returns the page size of the system
+ */
+size_t mem_pagesize()
+{
+    return (size_t)getpagesize();
+}
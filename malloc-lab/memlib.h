@@ -1,11 +1,23 @@
-#include <unistd.h>
-
-void mem_init(void);               
-void mem_deinit(void);
-void *mem_sbrk(int incr);
-void mem_reset_brk(void); 
-void *mem_heap_lo(void);
-void *mem_heap_hi(void);
-size_t mem_heapsize(void);
-size_t mem_pagesize(void);
-
+#include <unistd.h>
+
+void mem_init(void);               
+void mem_deinit(void);
+void *mem_sbrk(size_t incr);
+int mem_trim(void *end, size_t decr);
+void *mem_map(size_t len);
+int mem_unmap(void *p);
+void *mem_remap(void *p, size_t len);
+size_t mem_mapped(void);
+int mem_contains(void *lo, void *hi);
+void mem_reset_brk(void); 
+void *mem_heap_lo(void);
+void *mem_heap_hi(void);
+size_t mem_heapsize(void);
+size_t mem_heap_peak(void);
+size_t mem_pagesize(void);
+size_t mem_committed(void);
+size_t mem_commit_peak(void);
+size_t mem_commit_unit(void);
+size_t mem_huge_bytes(void);
+const char *mem_backend(void);
+
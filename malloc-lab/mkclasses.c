@@ -0,0 +1,58 @@
+/*
+ * mkclasses.c - Generate the size class table of mm.c (sizeclass.h)
+ *
+ * usage: mkclasses > sizeclass.h
+ *
+ * Built with the same MMFLAGS as the allocator, it reads CLASS_BOUNDS
+ * and CLASS_TABLE_MAX (config.h) and writes the class of every block
+ * size below CLASS_TABLE_MAX, one byte per ALIGNMENT bytes, so that
+ * size_class is a load for small blocks. Larger blocks get a class
+ * per power of two, computed with clz from CLASS_SMALL and
+ * CLASS_TABLE_SHIFT.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "config.h"
+#include "mm.h"
+
+static const size_t bounds[] = {CLASS_BOUNDS};
+
+#define NUM_BOUNDS (sizeof(bounds) / sizeof(bounds[0]))
+
+static void die(const char *msg)
+{
+	fprintf(stderr, "mkclasses: %s\n", msg);
+	exit(1);
+}
+
+int main(void)
+{
+	size_t i, size;
+	int shift, c;
+
+	if (CLASS_TABLE_MAX < ALIGNMENT || (CLASS_TABLE_MAX & (CLASS_TABLE_MAX - 1)) != 0)
+		die("CLASS_TABLE_MAX must be a power of two of at least ALIGNMENT");
+	if (bounds[0] != 0)
+		die("CLASS_BOUNDS must start at 0");
+	for (i = 1; i < NUM_BOUNDS; i++)
+		if (bounds[i] <= bounds[i - 1] || bounds[i] >= CLASS_TABLE_MAX)
+			die("CLASS_BOUNDS must increase and stay below CLASS_TABLE_MAX");
+	if (NUM_BOUNDS >= MM_NUM_CLASSES)
+		die("CLASS_BOUNDS has more classes than MM_NUM_CLASSES (mm.h)");
+	for (shift = 0; ((size_t)1 << shift) < CLASS_TABLE_MAX; shift++)
+		;
+
+	printf("/* Generated by mkclasses from CLASS_BOUNDS and CLASS_TABLE_MAX (config.h); do not edit */\n");
+	printf("#define CLASS_SMALL %-10d/* classes in class_table */\n", (int)NUM_BOUNDS);
+	printf("#define CLASS_TABLE_SHIFT %-4d/* log2(CLASS_TABLE_MAX) */\n\n", shift);
+	printf("static const unsigned char class_table[CLASS_TABLE_MAX / ALIGNMENT] = {");
+	for (size = 0, c = 0; size < CLASS_TABLE_MAX; size += ALIGNMENT)
+	{
+		while (c + 1 < (int)NUM_BOUNDS && bounds[c + 1] <= size)
+			c++;
+		printf("%s%d,", (size / ALIGNMENT) % 16 ? " " : "\n    ", c);
+	}
+	printf("\n};\n");
+	return 0;
+}
@@ -1,294 +1,2455 @@
-/*
- * mm-implicit.c - Implicit free list allocator (first-fit)
- *
- * 개요(High-level):
- *   - 8바이트 정렬을 보장하는 힙 관리자입니다.
- *   - 각 블록은 [Header | Payload | (Footer)] 형태로 저장됩니다.
- *     * Header/Footer: 4바이트(word)로, (블록 전체 크기 | 할당 비트) 를 담습니다.
- *     * 최소 블록 크기: 16바이트(헤더 4 + 풋터 4 + 최소 페이로드 8)
- *   - 힙의 앞뒤에 Prologue(할당된 최소 가드 블록) / Epilogue(크기 0, 할당) 가드 블록을 둡니다.
- *   - 탐색은 first-fit, 배치 시 필요하면 분할(splitting)합니다.
- *   - free 시 즉시 인접 free 블록과 병합(coalescing)합니다.
- *   - realloc 은 새로 할당 후 데이터 복사, 기존 블록 free 로 단순 구현했습니다.
- */
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <assert.h>
-#include <unistd.h>
-#include <string.h>
-
-#include "mm.h"
-#include "memlib.h"
-
-team_t team = {
-    /* Team name */
-    "Jungle Team 12",
-    /* First member's full name */
-    "Yoo SungSoo",
-    /* First member's email address */
-    "elcane2@naver.com",
-    /* Second member's full name (leave blank if none) */
-    "",
-    /* Second member's email address (leave blank if none) */
-    ""
-};
-
-/* ====== 상수/매크로 정의 ====== */
-
-/* 단위 크기들 */
-#define WSIZE       4             /* word size: 헤더/풋터 단위(4바이트) */
-#define DSIZE       8             /* double word(8바이트 정렬 단위) */
-#define CHUNKSIZE   (1 << 12)     /* 힙 확장 시 기본 요청 크기(4096바이트) */
-
-/* 유틸 매크로 */
-#define MAX(x, y)       ((x) > (y) ? (x) : (y))          /* 최대값 */
-#define PACK(size, a)   ((size) | (a))                   /* 헤더/풋터에 (크기|할당비트) 패킹 */
-
-/* 메모리 접근 매크로 (p는 void* 또는 char* 포인터여야 함) */
-#define GET(p)          (*(unsigned int *)(p))           /* p가 가리키는 곳의 4바이트 값 읽기 */
-#define PUT(p, val)     (*(unsigned int *)(p) = (val))   /* p가 가리키는 곳에 4바이트 값 쓰기 */
-
-/* 헤더/풋터로부터 정보 추출 */
-#define GET_SIZE(p)     (GET(p) & ~0x7)                  /* 하위 3비트를 제외한 블록 크기 */
-#define GET_ALLOC(p)    (GET(p) & 0x1)                   /* 할당 여부(하위 비트) */
-
-/* 블록 포인터(bp)로부터 헤더/풋터의 주소 얻기 */
-#define HDRP(bp)        ((char *)(bp) - WSIZE)           /* 현재 블록의 헤더 주소 */
-#define FTRP(bp)        ((char *)(bp) + GET_SIZE(HDRP(bp)) - DSIZE) /* 현재 블록의 풋터 주소 */
-
-/* 인접 블록으로 이동 */
-#define NEXT_BLKP(bp)   ((char *)(bp) + GET_SIZE(HDRP(bp)))         /* 다음 블록의 bp */
-#define PREV_BLKP(bp)   ((char *)(bp) - GET_SIZE((char *)(bp) - DSIZE)) /* 이전 블록의 bp (이전 풋터 이용) */
-
-/* 정렬 관련(참고용: mm_malloc에서 직접 사용하지는 않음) */
-#define ALIGNMENT 8
-#define ALIGN(size)     (((size) + (ALIGNMENT - 1)) & ~0x7)         /* 8바이트 배수로 반올림 */
-#define SIZE_T_SIZE     (ALIGN(sizeof(size_t)))                     /* size_t 저장 시 정렬된 크기 */
-
-/* ====== 전역 변수 ====== */
-static char *heap_listp = NULL;   /* 힙의 prologue 블록 바로 뒤를 가리키는 포인터(일반적으로 첫 bp 기준점) */
-static char *rover = NULL;     // ← next-fit 탐색 시작 지점
-
-/* ====== 내부 함수 프로토타입 ====== */
-static void *extend_heap(size_t words);   /* 힙을 words(워드) 만큼 확장 */
-static void *coalesce(void *bp);          /* 인접 free 블록 병합 */
-static void *find_fit(size_t asize);      /* first-fit or next-fit 탐색 */
-static void place(void *bp, size_t asize);/* 블록 배치 및 필요 시 분할 */
-
-/* ------------------------------------------------------ */
-/* mm_init - 힙 초기화: prologue/epilogue 생성 후 초기 확장 */
-/* ------------------------------------------------------ */
-int mm_init(void)
-{
-    /* prologue(프롤로그) + epilogue(에필로그)용으로 4워드 공간 요청 */
-    if ((heap_listp = mem_sbrk(4 * WSIZE)) == (void *)-1) return -1;
-
-    /* 프롤로그 구성
-       [패딩][프롤로그 헤더][프롤로그 풋터][에필로그 헤더] */
-    PUT(heap_listp + 0*WSIZE, 0);                 /* Alignment padding (사용 안 함) */
-    PUT(heap_listp + 1*WSIZE, PACK(DSIZE, 1));    /* Prologue header: 크기=8, 할당=1 */
-    PUT(heap_listp + 2*WSIZE, PACK(DSIZE, 1));    /* Prologue footer: 크기=8, 할당=1 */
-    PUT(heap_listp + 3*WSIZE, PACK(0, 1));        /* Epilogue header: 크기=0, 할당=1 */
-    heap_listp += (2 * WSIZE);                    /* heap_listp를 프롤로그의 payload 위치로 이동 */
-
-    /* 초기 힙 확장: CHUNKSIZE 바이트 만큼 가용 블록 생성 */
-    if (extend_heap(CHUNKSIZE / WSIZE) == NULL) return -1;
-    rover = NEXT_BLKP(heap_listp);   // 프롤로그 다음 블록부터 시작
-    return 0;
-}
-
-/* ------------------------------------------------------ */
-/* extend_heap - 힙을 words(워드) 만큼 확장하여 새 free 블록 생성 */
-/*               짝수 워드로 맞춰 8바이트 정렬 유지                */
-/* ------------------------------------------------------ */
-static void *extend_heap(size_t words)
-{
-    char *bp;
-    size_t size;
-
-    /* 짝수 워드로 반올림(8바이트 정렬 유지) */
-    size = (words % 2) ? (words + 1) * WSIZE : words * WSIZE;
-
-    /* 힙 확장(mem_sbrk) */
-    if ((long)(bp = mem_sbrk(size)) == -1) return NULL;
-
-    /* 새로 얻은 영역을 하나의 큰 free 블록으로 초기화 */
-    PUT(HDRP(bp), PACK(size, 0));                  /* Free block header */
-    PUT(FTRP(bp), PACK(size, 0));                  /* Free block footer */
-    PUT(HDRP(NEXT_BLKP(bp)), PACK(0, 1));          /* New epilogue header (끝 표시) */
-
-    /* 이전 블록이 free였다면 병합해서 단편화 감소 */
-    rover = bp;                           // ← 새로 확장된 free 블록으로 이동
-
-    return coalesce(bp);
-}
-
-/* ------------------------------------------------------ */
-/* coalesce - 인접한 free 블록을 즉시 병합하여 큰 블록 확보 */
-/*   prev_alloc / next_alloc 조합에 따라 4가지 경우 처리     */
-/* ------------------------------------------------------ */
-static void *coalesce(void *bp)
-{
-    /* 이전 블록의 할당 여부: 이전 블록의 풋터를 보고 판단 */
-    size_t prev_alloc = GET_ALLOC(FTRP(PREV_BLKP(bp)));
-    /* 다음 블록의 할당 여부: 다음 블록의 헤더를 보고 판단 */
-    size_t next_alloc = GET_ALLOC(HDRP(NEXT_BLKP(bp)));
-    /* 현재 블록의 크기 */
-    size_t size = GET_SIZE(HDRP(bp));
-
-    if (prev_alloc && next_alloc) { /* Case 1: 양쪽 모두 할당 -> 병합 없음 */
-        return bp;
-    }
-    else if (prev_alloc && !next_alloc) { /* Case 2: 다음만 free -> 현재와 다음 병합 */
-        size += GET_SIZE(HDRP(NEXT_BLKP(bp)));     /* 다음 블록 크기 더하기 */
-        PUT(HDRP(bp), PACK(size, 0));              /* 새 크기로 현재 헤더 갱신 */
-        PUT(FTRP(bp), PACK(size, 0));              /* 새 크기로 현재 풋터 갱신 */
-    }
-    else if (!prev_alloc && next_alloc) { /* Case 3: 이전만 free -> 이전과 현재 병합 */
-        size += GET_SIZE(HDRP(PREV_BLKP(bp)));     /* 이전 블록 크기 더하기 */
-        PUT(FTRP(bp), PACK(size, 0));              /* 새 크기로 최종 풋터 갱신 */
-        PUT(HDRP(PREV_BLKP(bp)), PACK(size, 0));   /* 이전 블록 헤더를 새 크기로 */
-        bp = PREV_BLKP(bp);                         /* bp를 병합된 블록의 시작으로 이동 */
-    }
-    else { /* Case 4: 양쪽 모두 free -> 세 블록(이전,현재,다음) 전부 병합 */
-        size += GET_SIZE(HDRP(PREV_BLKP(bp)))      /* 이전 블록 크기 */
-              + GET_SIZE(FTRP(NEXT_BLKP(bp)));     /* 다음 블록 크기
-                                                      (참고: HDRP(NEXT_BLKP(bp))를 써도 동일) */
-        PUT(HDRP(PREV_BLKP(bp)), PACK(size, 0));   /* 병합된 헤더(이전 블록 헤더 위치) */
-        PUT(FTRP(NEXT_BLKP(bp)), PACK(size, 0));   /* 병합된 풋터(다음 블록 풋터 위치) */
-        bp = PREV_BLKP(bp);                         /* bp를 병합된 블록의 시작으로 이동 */
-    }
-    rover = bp;   // ← 병합 결과 블록으로 로버 보정(충분히 안전하고 단순)
-    return bp;
-}
-
-/* ------------------------------------------------------ */
-/* find_fit - first-fit 방식으로 asize 이상 수용 가능한 가용 블록 탐색 */
-/*   순회 시작: 프롤로그 다음 블록부터, 에필로그(크기 0) 직전까지        */
-/* ------------------------------------------------------ */
-static void *find_fit(size_t asize)
-{
-    void *bp;
-
-    /*First Fit*/
-    /* heap_listp는 프롤로그 payload를 가리키므로 그 다음 블록부터 검사 */
-
-    // for (bp = NEXT_BLKP(heap_listp);               /* 첫 실제 블록 */
-    //      GET_SIZE(HDRP(bp)) > 0;                   /* 에필로그(사이즈 0) 전까지 */
-    //      bp = NEXT_BLKP(bp))                       /* 다음 블록으로 이동 */
-    // {
-    //     if (!GET_ALLOC(HDRP(bp)) && (asize <= GET_SIZE(HDRP(bp)))) {
-    //         return bp;                             /* 처음 맞는 free 블록 반환 */
-    //     }
-    // }
-
-    /*Next Fit*/
-       /* 1) rover에서 에필로그 직전까지 */
-    for (bp = rover; GET_SIZE(HDRP(bp)) > 0; bp = NEXT_BLKP(bp)) {
-        if (!GET_ALLOC(HDRP(bp)) && (asize <= GET_SIZE(HDRP(bp))))
-            return bp;
-    }
-
-    /* 2) 못 찾으면 리스트의 앞(프롤로그 다음)부터 rover 직전까지 */
-    for (bp = NEXT_BLKP(heap_listp); bp != rover; bp = NEXT_BLKP(bp)) {
-        if (!GET_ALLOC(HDRP(bp)) && (asize <= GET_SIZE(HDRP(bp))))
-            return bp;
-    }
-
-
-    return NULL;                                   /* 적합 블록 없음 */
-}
-
-/* ------------------------------------------------------ */
-/* place - 찾은 free 블록 bp에 asize만큼 배치, 남으면 분할      */
-/*   분할 임계: 남는 공간이 최소 블록(16B) 이상일 때만 분할        */
-/* ------------------------------------------------------ */
-static void place(void *bp, size_t asize)
-{
-    size_t csize = GET_SIZE(HDRP(bp));             /* 현재 free 블록의 총 크기 */
-
-    if ((csize - asize) >= (2 * DSIZE)) {          /* 분할 가능한 충분한 여유(>=16) */
-        PUT(HDRP(bp), PACK(asize, 1));             /* 앞쪽 조각을 할당 상태로 설정 */
-        PUT(FTRP(bp), PACK(asize, 1));
-
-        bp = NEXT_BLKP(bp);                        /* 남은 뒷부분을 새 free 블록으로 설정 */
-        PUT(HDRP(bp), PACK(csize - asize, 0));
-        PUT(FTRP(bp), PACK(csize - asize, 0));
-         rover = bp; // ← 남은 free 조각부터 다음 탐색 시작
-    } else {                                       /* 분할하지 않고 전부 할당 */
-        PUT(HDRP(bp), PACK(csize, 1));
-        PUT(FTRP(bp), PACK(csize, 1));
-            rover = NEXT_BLKP(bp); // ← 바로 다음 블록부터 시작
-    }
-}
-
-/* ------------------------------------------------------ */
-/* mm_malloc - 크기 size의 블록 요청 처리                     */
-/*   1) 요청 정규화(asize) → 2) 가용 블록 탐색 → 3) 없으면 확장   */
-/* ------------------------------------------------------ */
-void *mm_malloc(size_t size)
-{
-    if (size == 0) return NULL;                    /* 0바이트 요청은 NULL 반환(관례) */
-
-    size_t asize;                                  /* 헤더/풋터 포함·정렬된 크기 */
-
-    /* 최소 블록 보장: 요청이 8바이트 이하라면 블록 전체 16바이트로 */
-    if (size <= DSIZE)
-        asize = 2 * DSIZE;                         /* 16바이트 */
-    else
-        /* size + 헤더/풋터(=8) 후 8바이트 배수로 반올림 */
-        asize = DSIZE * ((size + DSIZE + (DSIZE - 1)) / DSIZE);
-
-    /* 1) first-fit 탐색 */
-    void *bp = find_fit(asize);
-    if (bp != NULL) {
-        place(bp, asize);
-        return bp;                                 /* 배치한 payload 포인터 반환 */
-    }
-
-    /* 2) 적합 블록이 없으면 힙 확장 후 배치 */
-    size_t extendsize = MAX(asize, CHUNKSIZE);     /* 한번에 최소 CHUNKSIZE만큼 늘림 */
-    if ((bp = extend_heap(extendsize / WSIZE)) == NULL)
-        return NULL;                               /* 확장 실패 시 NULL */
-    place(bp, asize);
-    return bp;
-}
-
-/* ------------------------------------------------------ */
-/* mm_free - 블록 해제 후 인접 free 블록과 즉시 병합            */
-/* ------------------------------------------------------ */
-void mm_free(void *bp)
-{
-    if (bp == NULL) return;                        /* NULL free 방어 */
-
-    size_t size = GET_SIZE(HDRP(bp));              /* 현재 블록의 전체 크기 */
-    PUT(HDRP(bp), PACK(size, 0));                  /* 헤더를 free로 마킹 */
-    PUT(FTRP(bp), PACK(size, 0));                  /* 풋터를 free로 마킹 */
-    coalesce(bp);                                  /* 인접 free 블록과 병합 */
-}
-
-/* ------------------------------------------------------ */
-/* mm_realloc - 단순 구현: 새로 할당 → 최소크기만큼 복사 → 원래 free */
-/*   최적화 아이디어(참고):
-/*     - 오른쪽 블록이 free면 흡수하여 in-place 확장 시도 */
-/*     - 줄이는 경우엔 분할하여 뒤쪽을 free로 돌려주기     */
-/* ------------------------------------------------------ */
-void *mm_realloc(void *ptr, size_t size)
-{
-    if (ptr == NULL) return mm_malloc(size);       /* realloc(NULL, s) == malloc(s) */
-    if (size == 0)   { mm_free(ptr); return NULL;} /* realloc(p, 0) == free(p) */
-
-    /* 새 블록 요청 */
-    void *newptr = mm_malloc(size);
-    if (newptr == NULL) return NULL;
-
-    /* 복사 크기: 기존 payload 크기와 새 요청 중 작은 값 */
-    size_t oldsize = GET_SIZE(HDRP(ptr)) - DSIZE;  /* 기존 블록의 payload 크기(헤더/풋터 제외) */
-    size_t copySize = (size < oldsize) ? size : oldsize;
-    memcpy(newptr, ptr, copySize);
-
-    /* 기존 블록 해제 */
-    mm_free(ptr);
-    return newptr;
-}
+/*
+ * mm.c - Segregated explicit free list allocator
+ *
+ * 개요(High-level):
+ *   - 8바이트 정렬을 보장하는 힙 관리자입니다(MM_64BIT 모드에선 16바이트).
+ *   - 각 블록은 [Header | Payload | (Footer)] 형태로 저장됩니다.
+ *     * Header/Footer: 4바이트(word)로, (블록 전체 크기 | 이전 블록 할당 비트 | 할당 비트) 를 담습니다.
+ *     * FOOTERLESS_ALLOC(config.h) 이 켜지면 할당 블록은 풋터 없이 헤더만 가지며,
+ *       이전 블록이 free 인지는 헤더의 PREV_ALLOC 비트로 판단합니다(최소 오버헤드 4바이트).
+ *     * 가용 블록은 payload 앞부분에 pred/succ 링크(포인터 2개)를 저장합니다.
+ *     * 최소 블록 크기: 24바이트(헤더 4 + pred 8 + succ 8 + 풋터 4)
+ *     * MM_64BIT(config.h) 모드에선 태그가 size_t(8바이트) 폭이라 4GB 이상 블록도 표현하며,
+ *       최소 블록은 32바이트(헤더 8 + pred 8 + succ 8 + 풋터 8)입니다.
+ *   - 힙의 앞뒤에 Prologue(할당된 최소 가드 블록) / Epilogue(크기 0, 할당) 가드 블록을 둡니다.
+ *   - 가용 블록만 크기 클래스(2의 거듭제곱 구간)별 이중 연결 리스트에 LIFO 로 보관합니다.
+ *     TREE_MIN_SIZE(config.h) 이상의 큰 free 블록은 리스트 대신 (크기, 주소) 순 트립(treap)에
+ *     넣어 O(log n) best-fit 으로 찾습니다(트리 링크도 payload 에 저장).
+ *   - 탐색은 요청 크기의 클래스부터 시작해 더 큰 클래스로 올라가며,
+ *     배치 정책(first/next/best/good-fit)은 config.h 의 FIT_POLICY 로 컴파일 시 고릅니다.
+ *   - 배치 시 필요하면 분할(splitting)하고, 남은 조각은 다시 리스트에 넣습니다.
+ *   - free 시 즉시 인접 free 블록과 병합(coalescing)합니다.
+ *     DEFER_COALESCE(config.h) 모드에선 작은 블록을 할당 상태 그대로 크기별 quick 리스트에
+ *     두었다가 같은 크기 요청에 그대로 돌려주고, 병합은 맞는 블록이 없거나 리스트가
+ *     길어졌을 때 모아서(sweep) 합니다.
+ *     병합 결과가 힙 끝의 TRIM_THRESHOLD(config.h) 이상 free 블록이면 그 뒷부분을
+ *     mem_trim 으로 시스템에 돌려줍니다(mm_trim 으로 직접 요청할 수도 있음).
+ *   - SLAB_MAX_SIZE(config.h) 이하의 작은 요청은 슬랩이 처리합니다: 정렬된 페이지 하나를
+ *     한 크기의 칸(run)으로 나누고 비트맵으로 빈 칸을 찾으며, 칸에는 헤더가 없습니다.
+ *     페이지 자체는 일반 할당 블록이고, 주소를 페이지 경계로 내려(masking) run 을 찾습니다.
+ *   - MMAP_THRESHOLD(config.h) 이상의 큰 요청은 힙을 거치지 않고 mem_map 으로 받은 전용
+ *     페이지 매핑에 두고, free 하면 바로 unmap, realloc 은 mem_remap(mremap)으로 복사 없이
+ *     늘립니다. 힙 밖 주소인지로 매핑 블록을 알아보며, 매핑 길이는 payload 바로 앞에 둡니다.
+ *   - realloc 은 가능한 한 제자리에서 처리합니다(축소 시 분할, 오른쪽 free 흡수,
+ *     힙 끝이면 확장, 왼쪽 free 와 병합 후 memmove). 모두 안 되면 새로 할당 후 복사합니다.
+ *   - MM_THREADS(config.h) 모드에선 스레드마다 작은 블록 캐시(tcache)를 두어
+ *     동기화 없이 malloc/free 를 처리하고, 캐시가 비거나 넘칠 때만 뮤텍스로 보호된
+ *     공유 힙에서 여러 블록을 한꺼번에 가져오거나(refill) 돌려줍니다(flush).
+ *   - MM_ARENAS 모드에선 공유 힙 대신 스레드마다 전담 아레나(독립된 분리 리스트와 영역)를
+ *     두고, 다른 스레드가 free 한 블록은 소유 아레나의 lock-free 원격 큐로 보냅니다.
+ *   - MM_PROFILE(config.h) 이 켜지면 할당/해제 경로에 힙 프로파일러(prof.c) 훅이 들어갑니다:
+ *     할당은 스레드별 샘플 간격에서 크기를 빼기만 하고, 다 썼을 때만 prof_sample 로 갑니다.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "config.h"
+#if MM_THREADS
+#include <pthread.h>
+#endif
+#if MM_ARENAS && !MM_THREADS
+#error "MM_ARENAS requires MM_THREADS"
+#endif
+
+#include "mm.h"
+#include "memlib.h"
+#include "sizeclass.h"                 /* mkclasses 가 만든 크기 클래스 표 */
+#if MM_PROFILE
+#include "prof.h"
+#endif
+
+team_t team = {
+    /* Team name */
+    "Jungle Team 12",
+    /* First member's full name */
+    "Yoo SungSoo",
+    /* First member's email address */
+    "elcane2@naver.com",
+    /* Second member's full name (leave blank if none) */
+    "",
+    /* Second member's email address (leave blank if none) */
+    ""
+};
+
+/* ====== 상수/매크로 정의 ====== */
+
+/* 단위 크기들 */
+#if MM_64BIT
+typedef size_t word_t;            /* 헤더/풋터 한 워드의 타입 */
+#define WSIZE       8             /* word size: 헤더/풋터 단위(8바이트) */
+#define DSIZE       16            /* double word(16바이트 정렬 단위) */
+#else
+typedef unsigned int word_t;      /* 헤더/풋터 한 워드의 타입 */
+#define WSIZE       4             /* word size: 헤더/풋터 단위(4바이트) */
+#define DSIZE       8             /* double word(8바이트 정렬 단위) */
+#endif
+#define PSIZE       sizeof(void *) /* 가용 블록 안에 저장하는 링크 포인터 크기 */
+#define CHUNKSIZE   (1 << 12)     /* 힙 확장 시 기본 요청 크기(4096바이트) */
+
+/* 유틸 매크로 */
+#define MAX(x, y)       ((x) > (y) ? (x) : (y))          /* 최대값 */
+#define MIN(x, y)       ((x) < (y) ? (x) : (y))          /* 최소값 */
+#define PACK(size, a)   ((size) | (a))                   /* 헤더/풋터에 (크기|할당비트) 패킹 */
+
+/* 메모리 접근 매크로 (p는 void* 또는 char* 포인터여야 함) */
+#define GET(p)          (*(word_t *)(p))                 /* p가 가리키는 곳의 한 워드 값 읽기 */
+#define PUT(p, val)     (*(word_t *)(p) = (val))         /* p가 가리키는 곳에 한 워드 값 쓰기 */
+
+/* 헤더/풋터로부터 정보 추출 */
+#define GET_SIZE(p)     (GET(p) & ~0x7)                  /* 하위 3비트를 제외한 블록 크기 */
+#define GET_ALLOC(p)    (GET(p) & 0x1)                   /* 할당 여부(하위 비트) */
+#define GET_PREV_ALLOC(p) (GET(p) & PREV_ALLOC)          /* 바로 앞 블록의 할당 여부 */
+
+/* 헤더의 두 번째 비트: 바로 앞 블록이 할당 상태인지 (헤더에만 의미 있음) */
+#define PREV_ALLOC      0x2
+#if MM_THREADS
+/* 뒤 블록은 다른 스레드가 쥐고 있는 할당 블록일 수 있음(락 없이 자기 헤더를 읽음): 원자적으로 비트만 수정 */
+#define SET_PREV_ALLOC(p) __atomic_or_fetch((word_t *)(p), PREV_ALLOC, __ATOMIC_RELAXED)
+#define CLR_PREV_ALLOC(p) __atomic_and_fetch((word_t *)(p), ~(word_t)PREV_ALLOC, __ATOMIC_RELAXED)
+#else
+#define SET_PREV_ALLOC(p) PUT(p, GET(p) | PREV_ALLOC)    /* 앞 블록이 할당됨으로 표시 */
+#define CLR_PREV_ALLOC(p) PUT(p, GET(p) & ~PREV_ALLOC)   /* 앞 블록이 free 로 표시 */
+#endif
+
+/* 헤더 갱신: 크기/할당 비트만 바꾸고 PREV_ALLOC 비트는 보존 */
+#define SET_HDR(bp, size, a) \
+    PUT(HDRP(bp), PACK(size, a) | GET_PREV_ALLOC(HDRP(bp)))
+
+/* 할당 블록의 풋터: FOOTERLESS_ALLOC 모드에선 쓰지 않음 */
+#if FOOTERLESS_ALLOC
+#define OVERHEAD        WSIZE                            /* 할당 블록 메타데이터 = 헤더 */
+#define SET_ALLOC_FTR(bp, size)                          /* 풋터 없음 */
+#else
+#define OVERHEAD        DSIZE                            /* 할당 블록 메타데이터 = 헤더 + 풋터 */
+#define SET_ALLOC_FTR(bp, size) PUT(FTRP(bp), PACK(size, 1))
+#endif
+
+/* 블록 포인터(bp)로부터 헤더/풋터의 주소 얻기 */
+#define HDRP(bp)        ((char *)(bp) - WSIZE)           /* 현재 블록의 헤더 주소 */
+#define FTRP(bp)        ((char *)(bp) + GET_SIZE(HDRP(bp)) - DSIZE) /* 현재 블록의 풋터 주소 */
+
+/* 인접 블록으로 이동 */
+#define NEXT_BLKP(bp)   ((char *)(bp) + GET_SIZE(HDRP(bp)))         /* 다음 블록의 bp */
+#define PREV_BLKP(bp)   ((char *)(bp) - GET_SIZE((char *)(bp) - DSIZE)) /* 이전 블록의 bp (이전 풋터 이용) */
+                                                 /* ※ 풋터는 free 블록에만 보장되므로 */
+                                                 /*    GET_PREV_ALLOC 이 0일 때만 사용 */
+
+/* 가용 블록 payload 에 저장된 리스트 링크 (bp는 free 블록이어야 함) */
+#define PRED(bp)        (*(char **)(bp))                  /* 같은 클래스의 이전 free 블록 */
+#define SUCC(bp)        (*(char **)((char *)(bp) + PSIZE)) /* 같은 클래스의 다음 free 블록 */
+
+/* 큰 free 블록은 같은 자리에 트리 자식 링크를 저장 */
+#define LEFT(bp)        PRED(bp)                          /* (크기, 주소)가 더 작은 쪽 */
+#define RIGHT(bp)       SUCC(bp)                          /* 더 큰 쪽 */
+/* 트리 키 비교: 크기 순, 같으면 주소 순 (키가 모두 달라짐) */
+#define TREE_LESS(x, y) (GET_SIZE(HDRP(x)) < GET_SIZE(HDRP(y)) || \
+                         (GET_SIZE(HDRP(x)) == GET_SIZE(HDRP(y)) && (char *)(x) < (char *)(y)))
+
+/* 정렬 관련 (ALIGNMENT 는 config.h) */
+#define ALIGN(size)     (((size) + (ALIGNMENT - 1)) & ~(size_t)(ALIGNMENT - 1)) /* ALIGNMENT 배수로 반올림 */
+#define SIZE_T_SIZE     (ALIGN(sizeof(size_t)))                     /* size_t 저장 시 정렬된 크기 */
+
+/* 최소 블록: 헤더 + 풋터 + pred/succ 링크를 담을 수 있어야 함 */
+#define MINBLOCK        ALIGN(DSIZE + 2 * PSIZE)                    /* 24바이트(MM_64BIT: 32바이트) */
+
+/* 요청 크기(정렬 요청은 크기 + align) 상한: 헤더·정렬·여유분·페이지 반올림을
+ * 더해도 size_t 가 넘치지 않음. 이보다 큰 요청은 어차피 채울 수 없으니 NULL */
+#define MAX_REQUEST     (SIZE_MAX / 2)
+
+/* 크기 클래스: CLASS_TABLE_MAX 미만은 CLASS_BOUNDS(config.h)로 나눈 CLASS_SMALL 개,
+ * 그 위로는 2의 거듭제곱마다 하나, 마지막은 그 이상 전부.
+ * 기본값은 class 0 = [MINBLOCK, 32), class k = [2^(k+4), 2^(k+5)) */
+#define NUM_CLASSES     MM_NUM_CLASSES
+
+/* 슬랩: 크기 클래스 c 의 칸 크기는 (c+1)*ALIGNMENT */
+#if SLAB_MAX_SIZE
+#define SLAB_CLASSES    (SLAB_MAX_SIZE / ALIGNMENT)
+#define SLAB_CLASS(size) (((size) - 1) / ALIGNMENT)         /* 요청 크기(>0) → 슬랩 클래스 */
+#define SLAB_MAP_WORDS  ((SLAB_PAGE / ALIGNMENT + 63) / 64)  /* 칸 비트맵 워드 수 */
+
+/* run 헤더: 페이지 맨 앞에 놓이고 그 뒤로 칸들이 이어짐 */
+typedef struct slab_run {
+    struct slab_run *next, *prev;       /* 같은 클래스의 빈 칸 있는 run 리스트 */
+    unsigned int osize;                 /* 칸 크기 */
+    unsigned int nobj;                  /* 칸 수 */
+    unsigned int nfree;                 /* 빈 칸 수 */
+    unsigned long long freemap[SLAB_MAP_WORDS]; /* 1 = 빈 칸 */
+} slab_run_t;
+
+#define SLAB_HDR        ALIGN(sizeof(slab_run_t))            /* 첫 칸의 오프셋 */
+#endif
+
+/* quick 리스트: 블록 크기(ALIGNMENT 배수)별 LIFO, 링크는 payload 첫 워드 */
+#if DEFER_COALESCE
+#define QUICK_BINS      (QUICK_MAX_SIZE / ALIGNMENT + 1)
+#define QUICK_INDEX(asize) ((asize) / ALIGNMENT)
+#define QUICK_NEXT(bp)  (*(char **)(bp))
+#endif
+
+/* 직접 매핑 블록: [매핑 길이(size_t) | payload], payload 는 매핑 시작 + MAP_HDR */
+#if MMAP_THRESHOLD
+#define MAP_HDR         ALIGN(sizeof(size_t))
+#define MAP_LEN(bp)     (*(size_t *)((char *)(bp) - sizeof(size_t))) /* 매핑 전체 길이 */
+#define MAP_BASE(bp)    ((char *)(bp) - MAP_HDR)
+#define PAGE_UP(n)      (((n) + map_page - 1) & ~(map_page - 1))
+/* 힙(최대 MAX_HEAP) 밖의 주소면 매핑 블록 */
+#define IS_MAPPED(bp)   ((size_t)((char *)(bp) - map_heap_lo) >= MAX_HEAP)
+#endif
+
+/* ====== 힙(아레나) 상태 ====== */
+
+/*
+ * 분리 리스트 등 힙 하나의 상태를 담는 구조체. 기본/MM_THREADS 모드에선 main_arena
+ * 하나뿐이고, MM_ARENAS 모드에선 스레드마다 하나씩 배정됩니다. 내부 함수는 모두
+ * 작업할 아레나 a를 인자로 받습니다.
+ */
+typedef struct arena {
+    char *seg_heads[NUM_CLASSES];       /* 크기 클래스별 free 리스트의 첫 블록 */
+#if FIT_POLICY == FIT_NEXT
+    char *rovers[NUM_CLASSES];          /* 클래스별 next-fit 탐색 재개 지점 */
+#endif
+#if TREE_MIN_SIZE
+    char *tree_root;                    /* TREE_MIN_SIZE 이상 free 블록의 트립 */
+#endif
+#if SLAB_MAX_SIZE
+    slab_run_t *slabs[SLAB_CLASSES];    /* 클래스별 빈 칸 있는 run 리스트 */
+#endif
+#if DEFER_COALESCE
+    char *quick[QUICK_BINS];            /* 병합을 미룬 블록 (할당 상태로 보관) */
+    unsigned int quick_counts[QUICK_BINS];
+#endif
+    unsigned long fit_calls;            /* find_fit 호출 수 (mm_stats 용) */
+    unsigned long fit_examined;         /* find_fit 이 살펴본 free 블록 수 */
+#if MM_THREADS
+    pthread_mutex_t lock;               /* 이 아레나의 리스트/블록을 보호 */
+#endif
+#if MM_ARENAS
+    char *end;                          /* 마지막으로 받은 영역의 끝 (연속 확장 판단용) */
+    void *remote;                       /* 다른 스레드가 free 한 블록 스택 (MPSC, lock-free) */
+    int owned;                          /* 전담 스레드가 있으면 1 */
+#endif
+}
+#if MM_THREADS
+__attribute__((aligned(64)))            /* 아레나끼리 캐시 라인 공유(false sharing) 방지 */
+#endif
+arena_t;
+
+/* ====== 전역 변수 ====== */
+#if !MM_ARENAS
+static char *heap_listp = NULL;   /* 힙의 prologue 블록 바로 뒤를 가리키는 포인터(일반적으로 첫 bp 기준점) */
+#endif
+
+#if MM_ARENAS
+/* 아레나 풀과, ARENA_GRAIN 단위 주소 → 소유 아레나 번호(+1) 지도 */
+static arena_t arenas[MAX_ARENAS] = {
+    [0 ... MAX_ARENAS - 1] = { .lock = PTHREAD_MUTEX_INITIALIZER }
+};
+static unsigned char arena_map[MAX_HEAP / ARENA_GRAIN];
+static pthread_mutex_t arena_pool_lock = PTHREAD_MUTEX_INITIALIZER; /* 아레나 배정용 */
+static int arena_next;                      /* 모두 배정되었을 때 공유시킬 다음 아레나 */
+static __thread arena_t *my_arena;          /* 이 스레드에 배정된 아레나 */
+#elif MM_THREADS
+static arena_t main_arena = { .lock = PTHREAD_MUTEX_INITIALIZER };
+#else
+static arena_t main_arena;
+#endif
+
+/* 모든 아레나 순회용 */
+#if MM_ARENAS
+#define NUM_ARENAS      MAX_ARENAS
+#define ARENA(i)        (&arenas[i])
+#else
+#define NUM_ARENAS      1
+#define ARENA(i)        (&main_arena)
+#endif
+
+#if SLAB_MAX_SIZE
+/* 힙 페이지(SLAB_PAGE, heap_lo 기준 번호) → run 이 시작하면 1 */
+static unsigned char slab_map[MAX_HEAP / SLAB_PAGE + 1];
+static char *slab_heap_lo;        /* mem_heap_lo() (슬랩 지도 기준점) */
+#endif
+
+#if MMAP_THRESHOLD
+static char *map_heap_lo;         /* mem_heap_lo() (매핑 블록 판별 기준점) */
+static size_t map_page;           /* 매핑 단위(페이지 크기) */
+static size_t map_blocks;         /* 살아있는 매핑 블록 수 (mm_stats 용) */
+static size_t map_bytes;          /* 그 매핑들의 전체 길이 */
+#endif
+
+#if MM_THREADS
+#define ARENA_LOCK(a)   pthread_mutex_lock(&(a)->lock)
+#define ARENA_UNLOCK(a) pthread_mutex_unlock(&(a)->lock)
+#else
+#define ARENA_LOCK(a)                               /* 단일 스레드: 락 없음 */
+#define ARENA_UNLOCK(a)
+#endif
+
+/* 힙 일관성 검사 (mm_check) */
+#define CHECK_MAX_REPORTS 16      /* stderr 에 출력할 최대 실패 수 */
+static int check_failed;          /* mm_init 이후 실패한 검사 수 */
+#if MM_CHECK
+static int check_level;           /* mm_check 로 정한 요청별 검사 수준 */
+/* 요청이 다룬 블록의 O(1) 검사: 수준 1 이상일 때만 */
+#define CHECK_ALLOC(bp) (check_level ? check_alloc(bp) : (void *)(bp))
+#define CHECK_FREE(bp)  do { if (check_level) check_free(bp); } while (0)
+#else
+#define CHECK_ALLOC(bp) ((void *)(bp))
+#define CHECK_FREE(bp)
+#endif
+#define IN_HEAP(p)      ((char *)(p) >= (char *)mem_heap_lo() && (char *)(p) <= (char *)mem_heap_hi())
+
+/* 힙 프로파일러(prof.h) 훅: 꺼져 있으면 할당마다 뺄셈·분기, free 마다 읽기·분기 하나 */
+#if MM_PROFILE
+#define PROF_ALLOC(bp, size) prof_alloc(bp, size)
+#define PROF_FREE(bp)   do { if (__builtin_expect(__atomic_load_n(&prof_live, __ATOMIC_RELAXED) != 0, 0)) \
+                             prof_forget(bp); } while (0)
+#define PROF_RESIZE(bp, size) do { if (__builtin_expect(__atomic_load_n(&prof_live, __ATOMIC_RELAXED) != 0, 0)) \
+                             prof_resize(bp, size); } while (0)
+#define PROF_MOVE_BEGIN(bp) (__atomic_load_n(&prof_live, __ATOMIC_RELAXED) != 0 && prof_move_begin(bp))
+#define PROF_MOVE_END(bp, held, moved) prof_move_end(bp, held, moved)
+#else
+#define PROF_ALLOC(bp, size) ((void *)(bp))
+#define PROF_FREE(bp)
+#define PROF_RESIZE(bp, size)
+#define PROF_MOVE_BEGIN(bp) 0
+#define PROF_MOVE_END(bp, held, moved) ((void)(held))
+#endif
+
+/* ====== 내부 함수 프로토타입 ====== */
+static void *extend_heap(arena_t *a, size_t words); /* 힙을 words(워드) 만큼 확장 */
+static void *coalesce(arena_t *a, void *bp);  /* 인접 free 블록 병합 */
+static inline void *find_fit(arena_t *a, size_t asize); /* 분리 리스트에서 FIT_POLICY 로 탐색 */
+static void place(arena_t *a, void *bp, size_t asize); /* 블록 배치 및 필요 시 분할 */
+static inline size_t adjust_size(size_t size); /* 요청 크기 → 헤더/풋터 포함 정렬 크기 */
+static void shrink_block(arena_t *a, void *bp, size_t asize); /* 할당 블록의 뒷부분을 잘라 free 로 반환 */
+static inline int size_class(size_t asize);   /* 블록 크기 → 클래스 번호 */
+static inline size_t class_min(int c);        /* 클래스 c 의 가장 작은 블록 크기 */
+static void insert_free_block(arena_t *a, void *bp); /* free 블록을 해당 클래스 리스트 앞에 삽입 */
+static void remove_free_block(arena_t *a, void *bp); /* free 블록을 소속 리스트에서 제거 */
+#if TREE_MIN_SIZE
+static void tree_insert(arena_t *a, char *bp); /* 큰 free 블록을 트리에 삽입 */
+static void tree_remove(arena_t *a, char *bp); /* 큰 free 블록을 트리에서 제거 */
+static char *tree_best_fit(arena_t *a, size_t asize); /* asize 이상 중 가장 작은 블록 */
+#endif
+static void arena_reset(arena_t *a);          /* 아레나의 리스트 비우기 */
+static inline arena_t *thread_arena(void);    /* 호출 스레드가 쓸 아레나 */
+static void *heap_malloc(arena_t *a, size_t asize); /* 아레나에서 asize 블록 할당 (락 보유 상태) */
+static void heap_free(arena_t *a, void *bp);  /* 아레나에 블록 반환 (락 보유 상태) */
+static void block_free(arena_t *a, void *bp); /* 슬랩 칸이 아닌 블록 반환 (락 보유 상태) */
+static inline void free_block(void *bp, int slab); /* mm_free/mm_free_sized 공통 경로 */
+static void release_block(arena_t *a, void *bp); /* 블록을 free 로 표시하고 즉시 병합 */
+#if DEFER_COALESCE
+static int quick_sweep(arena_t *a);           /* quick 리스트의 블록을 모두 free·병합 */
+#endif
+static size_t heap_trim(arena_t *a, size_t pad); /* 힙 끝 free 블록을 pad 만 남기고 반환 */
+static void *heap_realloc(arena_t *a, void *ptr, size_t size); /* 아레나에서 크기 변경 (락 보유 상태) */
+static size_t carve_blocks(arena_t *a, char *bp, size_t asize, void **ptrs, size_t n); /* free 블록 하나를 asize 블록 여러 개로 */
+static size_t heap_malloc_batch(arena_t *a, size_t asize, void **ptrs, size_t n); /* asize 블록 n 개 할당 (락 보유 상태) */
+static size_t free_run(arena_t *a, void **ptrs, size_t i, size_t n); /* 주소가 이어진 블록들을 한 번에 해제 */
+static void *heap_memalign(arena_t *a, size_t align, size_t asize); /* payload 가 align 정렬된 블록 할당 */
+#if SLAB_MAX_SIZE
+static inline slab_run_t *slab_run_of(void *bp); /* 슬랩 칸이면 그 run, 아니면 NULL */
+static void *slab_malloc(arena_t *a, size_t size); /* 슬랩에서 size 이하 칸 할당 */
+static void slab_free(arena_t *a, void *bp);   /* 칸 반환 */
+static void *slab_realloc(arena_t *a, void *ptr, size_t size); /* 칸 크기 변경 */
+#endif
+static inline void *malloc_block(size_t size); /* mm_malloc 본체 (프로파일 기록 없음) */
+#if MMAP_THRESHOLD
+static void *map_malloc(size_t size);         /* 전용 매핑에 큰 블록 할당 */
+static void map_free(void *bp);               /* 매핑 블록 unmap */
+static void *map_realloc(void *bp, size_t size); /* 매핑 블록 크기 변경 (mremap) */
+#endif
+#if MM_THREADS
+static void tcache_new_epoch(void);           /* 힙 재초기화 시 모든 스레드 캐시 무효화 */
+static void *tcache_get(size_t asize);        /* 스레드 캐시에서 asize 블록 꺼내기 */
+static int tcache_put(void *bp, int slab);    /* 스레드 캐시에 블록 넣기(성공하면 1) */
+static void tcache_refill(arena_t *a, size_t asize); /* 아레나에서 여러 블록을 가져와 캐시 채우기 */
+#endif
+static void check_fail(void *bp, const char *msg); /* 검사 실패를 기록·출력 */
+#if MM_CHECK
+static void *check_alloc(void *bp);            /* 할당 블록 하나의 O(1) 검사 */
+static void check_free(void *bp);              /* 병합을 마친 free 블록 하나의 O(1) 검사 */
+static void check_sized(void *bp, size_t size); /* mm_free_sized 의 크기가 블록에 맞는지 */
+#endif
+static void check_heap(void);                  /* 힙 전체와 모든 리스트 검사 */
+#if TREE_MIN_SIZE
+static size_t check_tree(char *t, char *lo, char *hi, unsigned int prio); /* 서브트리 검사, 노드 수 리턴 */
+#endif
+#if MM_ARENAS
+static inline arena_t *arena_of(void *bp);    /* 블록 주소 → 소유 아레나 */
+static void *arena_sbrk(arena_t *a, size_t size, int *contiguous); /* 아레나용 영역 확보 */
+static void remote_free(arena_t *owner, void *bp); /* 다른 아레나 블록을 소유자 큐에 넣기 */
+static int drain_remote(arena_t *a);          /* 큐에 쌓인 원격 free 처리 (락 보유 상태) */
+#endif
+
+#if MM_PROFILE
+/* ------------------------------------------------------ */
+/* prof_alloc - 이 스레드의 샘플 간격에서 size 를 빼고, 다 쓰면    */
+/*   prof_sample 로 bp 를 샘플. bp 를 그대로 리턴                   */
+/* ------------------------------------------------------ */
+static inline void *prof_alloc(void *bp, size_t size)
+{
+    if (__builtin_expect((prof_countdown -= (long)size) < 0, 0) && bp != NULL)
+        prof_sample(bp, size);
+    return bp;
+}
+#endif
+
+/* ------------------------------------------------------ */
+/* mm_init - 힙 초기화: prologue/epilogue 생성 후 초기 확장 */
+/*   MM_ARENAS 모드에선 아레나만 비우고, 각 아레나가 첫 할당 때 */
+/*   자기 영역(프롤로그/에필로그 포함)을 따로 받아감             */
+/* ------------------------------------------------------ */
+int mm_init(void)
+{
+    check_failed = 0;
+#if MM_PROFILE
+    prof_reset();                                  /* 예전 힙 블록의 샘플 버리기 */
+#endif
+#if MM_THREADS
+    tcache_new_epoch();                            /* 예전 힙을 가리키는 스레드 캐시 무효화 */
+#endif
+#if SLAB_MAX_SIZE
+    memset(slab_map, 0, sizeof(slab_map));         /* 예전 힙의 run 표시 지우기 */
+    slab_heap_lo = mem_heap_lo();
+#endif
+#if MMAP_THRESHOLD
+    map_heap_lo = mem_heap_lo();
+    map_page = mem_pagesize();
+    map_blocks = map_bytes = 0;                    /* 예전 매핑은 mem_reset_brk 가 정리 */
+#endif
+
+#if MM_ARENAS
+    int i;
+
+    /* 이전 트레이스의 리스트/원격 큐/주소 지도가 남아있지 않도록 모두 비우기 */
+    for (i = 0; i < MAX_ARENAS; i++)
+        arena_reset(&arenas[i]);
+    memset(arena_map, 0, sizeof(arena_map));
+    return 0;
+#else
+    arena_t *a = &main_arena;
+
+    /* 이전 트레이스의 리스트가 남아있지 않도록 모든 클래스 비우기 */
+    arena_reset(a);
+
+    /* prologue(프롤로그) + epilogue(에필로그)용으로 4워드 공간 요청 */
+    if ((heap_listp = mem_sbrk(4 * WSIZE)) == (void *)-1) return -1;
+
+    /* 프롤로그 구성
+       [패딩][프롤로그 헤더][프롤로그 풋터][에필로그 헤더] */
+    PUT(heap_listp + 0*WSIZE, 0);                 /* Alignment padding (사용 안 함) */
+    PUT(heap_listp + 1*WSIZE, PACK(DSIZE, 1));    /* Prologue header: 크기=DSIZE, 할당=1 */
+    PUT(heap_listp + 2*WSIZE, PACK(DSIZE, 1));    /* Prologue footer: 크기=DSIZE, 할당=1 */
+    PUT(heap_listp + 3*WSIZE, PACK(0, 1) | PREV_ALLOC); /* Epilogue header: 크기=0, 할당=1, 앞=프롤로그 */
+    heap_listp += (2 * WSIZE);                    /* heap_listp를 프롤로그의 payload 위치로 이동 */
+
+    /* 초기 힙 확장: CHUNKSIZE 바이트 만큼 가용 블록 생성 */
+    if (extend_heap(a, CHUNKSIZE / WSIZE) == NULL) return -1;
+    return 0;
+#endif
+}
+
+/* ------------------------------------------------------ */
+/* arena_reset - 아레나 a의 모든 free 리스트(와 원격 큐) 비우기 */
+/* ------------------------------------------------------ */
+static void arena_reset(arena_t *a)
+{
+    int i;
+
+    for (i = 0; i < NUM_CLASSES; i++) {
+        a->seg_heads[i] = NULL;
+#if FIT_POLICY == FIT_NEXT
+        a->rovers[i] = NULL;
+#endif
+    }
+#if TREE_MIN_SIZE
+    a->tree_root = NULL;
+#endif
+#if SLAB_MAX_SIZE
+    for (i = 0; i < SLAB_CLASSES; i++)
+        a->slabs[i] = NULL;
+#endif
+#if DEFER_COALESCE
+    for (i = 0; i < QUICK_BINS; i++) {
+        a->quick[i] = NULL;
+        a->quick_counts[i] = 0;
+    }
+#endif
+    a->fit_calls = a->fit_examined = 0;
+#if MM_ARENAS
+    a->end = NULL;
+    a->remote = NULL;
+#endif
+}
+
+/* ------------------------------------------------------ */
+/* extend_heap - 힙을 words(워드) 만큼 확장하여 새 free 블록 생성 */
+/*               짝수 워드로 맞춰 DSIZE 정렬 유지                  */
+/*   MM_ARENAS: 아레나의 마지막 영역 바로 뒤를 받으면 기존처럼     */
+/*   에필로그 자리를 이어 쓰고, 다른 아레나가 끼어들었으면         */
+/*   프롤로그/에필로그를 갖춘 독립 영역으로 초기화                 */
+/* ------------------------------------------------------ */
+static void *extend_heap(arena_t *a, size_t words)
+{
+    char *bp;
+    size_t size;
+
+    /* 짝수 워드로 반올림(DSIZE 정렬 유지) */
+    size = (words % 2) ? (words + 1) * WSIZE : words * WSIZE;
+
+#if MM_ARENAS
+    int contiguous;
+
+    /* 새 영역은 ARENA_GRAIN 단위로만 받아야 주소 지도 칸과 맞음 */
+    size = (size + 4 * WSIZE + ARENA_GRAIN - 1) & ~(size_t)(ARENA_GRAIN - 1);
+    if ((bp = arena_sbrk(a, size, &contiguous)) == NULL) return NULL;
+    if (!contiguous) {
+        /* [패딩][프롤로그 헤더][프롤로그 풋터][블록 ...][에필로그 헤더] */
+        PUT(bp + 0*WSIZE, 0);
+        PUT(bp + 1*WSIZE, PACK(DSIZE, 1));
+        PUT(bp + 2*WSIZE, PACK(DSIZE, 1));
+        PUT(bp + 3*WSIZE, PACK(0, 1) | PREV_ALLOC); /* 곧 free 블록 헤더로 덮어씀 */
+        bp += 4 * WSIZE;
+        size -= 4 * WSIZE;
+    }
+#else
+    /* 힙 확장(mem_sbrk) */
+    if ((long)(bp = mem_sbrk(size)) == -1) return NULL;
+#endif
+
+    /* 새로 얻은 영역을 하나의 큰 free 블록으로 초기화 */
+    /* (헤더 자리는 예전 에필로그이므로 그 PREV_ALLOC 비트를 물려받음) */
+    SET_HDR(bp, size, 0);                          /* Free block header */
+    PUT(FTRP(bp), PACK(size, 0));                  /* Free block footer */
+    PUT(HDRP(NEXT_BLKP(bp)), PACK(0, 1));          /* New epilogue header (끝 표시, 앞=free) */
+
+    /* 이전 블록이 free였다면 병합해서 단편화 감소 (리스트 삽입은 coalesce가 담당) */
+    return coalesce(a, bp);
+}
+
+/* ------------------------------------------------------ */
+/* size_class - 블록 크기(asize)가 속하는 분리 리스트 번호 */
+/*   CLASS_TABLE_MAX 미만은 빌드 때 만든 표를 한 번 읽고,  */
+/*   그 이상은 최상위 비트 위치(clz)로 2배마다 한 클래스씩  */
+/* ------------------------------------------------------ */
+static inline int size_class(size_t asize)
+{
+    int c;
+
+    if (asize < CLASS_TABLE_MAX)
+        return class_table[asize / ALIGNMENT];
+    c = CLASS_SMALL + (63 - __builtin_clzll(asize)) - CLASS_TABLE_SHIFT;
+    return MIN(c, NUM_CLASSES - 1);
+}
+
+/* class_min - 클래스 c 에 드는 가장 작은 블록 크기 (size_class 의 역) */
+static inline size_t class_min(int c)
+{
+    static const size_t bounds[] = {CLASS_BOUNDS};
+
+    return c < CLASS_SMALL ? bounds[c] : (size_t)1 << (c - CLASS_SMALL + CLASS_TABLE_SHIFT);
+}
+
+/* ------------------------------------------------------ */
+/* insert_free_block - free 블록 bp를 클래스 리스트 맨 앞에 삽입(LIFO) */
+/* ------------------------------------------------------ */
+static void insert_free_block(arena_t *a, void *bp)
+{
+    int c;
+
+#if TREE_MIN_SIZE
+    if (GET_SIZE(HDRP(bp)) >= TREE_MIN_SIZE) {     /* 큰 블록은 트리로 */
+        tree_insert(a, bp);
+        return;
+    }
+#endif
+    c = size_class(GET_SIZE(HDRP(bp)));
+    PRED(bp) = NULL;
+    SUCC(bp) = a->seg_heads[c];
+    if (a->seg_heads[c] != NULL)
+        PRED(a->seg_heads[c]) = bp;
+    a->seg_heads[c] = bp;
+}
+
+/* ------------------------------------------------------ */
+/* remove_free_block - free 블록 bp를 소속 클래스 리스트에서 떼어냄 */
+/*   헤더 크기가 아직 리스트에 넣을 때의 크기여야 클래스가 맞음      */
+/* ------------------------------------------------------ */
+static void remove_free_block(arena_t *a, void *bp)
+{
+#if TREE_MIN_SIZE
+    if (GET_SIZE(HDRP(bp)) >= TREE_MIN_SIZE) {
+        tree_remove(a, bp);
+        return;
+    }
+#endif
+#if FIT_POLICY == FIT_NEXT
+    int c = size_class(GET_SIZE(HDRP(bp)));
+
+    if (a->rovers[c] == bp)                        /* 로버가 빠지는 블록이면 다음으로 */
+        a->rovers[c] = SUCC(bp);
+#endif
+    if (PRED(bp) != NULL)
+        SUCC(PRED(bp)) = SUCC(bp);
+    else
+        a->seg_heads[size_class(GET_SIZE(HDRP(bp)))] = SUCC(bp);
+    if (SUCC(bp) != NULL)
+        PRED(SUCC(bp)) = PRED(bp);
+}
+
+#if TREE_MIN_SIZE
+/* ====== 큰 free 블록용 트립(treap) ====== */
+
+/*
+ * 키 (크기, 주소)로는 이진 탐색 트리, 주소에서 뽑은 우선순위로는 힙(부모 ≥ 자식)인
+ * 트리입니다. 우선순위가 키와 무관한 난수처럼 분포하므로 기대 높이가 O(log n) 이고,
+ * 우선순위를 매번 주소에서 계산하므로 노드에는 자식 링크 두 개만 저장합니다.
+ */
+
+/* tree_prio - 블록 주소의 해시 (Knuth 곱셈 해시) */
+static inline unsigned int tree_prio(char *bp)
+{
+    return (unsigned int)((uintptr_t)bp / ALIGNMENT) * 2654435761u;
+}
+
+/* ------------------------------------------------------ */
+/* tree_insert - 우선순위가 더 낮은 첫 노드 자리에 bp를 놓고    */
+/*   그 자리의 서브트리를 bp 키 기준 왼쪽/오른쪽으로 쪼개 매닮  */
+/* ------------------------------------------------------ */
+static void tree_insert(arena_t *a, char *bp)
+{
+    char **link = &a->tree_root;
+    char **l = &LEFT(bp), **r = &RIGHT(bp);
+    unsigned int prio = tree_prio(bp);
+    char *t;
+
+    while (*link != NULL && tree_prio(*link) >= prio)
+        link = TREE_LESS(bp, *link) ? &LEFT(*link) : &RIGHT(*link);
+
+    for (t = *link; t != NULL; ) {                 /* split: 키 < bp 는 왼쪽, > bp 는 오른쪽 */
+        if (TREE_LESS(t, bp)) {
+            *l = t;
+            l = &RIGHT(t);
+            t = RIGHT(t);
+        } else {
+            *r = t;
+            r = &LEFT(t);
+            t = LEFT(t);
+        }
+    }
+    *l = *r = NULL;
+    *link = bp;
+}
+
+/* ------------------------------------------------------ */
+/* tree_remove - bp를 찾아 두 자식 서브트리를 우선순위 순으로   */
+/*   합친(merge) 것으로 대체                                     */
+/*   헤더 크기가 아직 트리에 넣을 때의 크기여야 찾을 수 있음      */
+/* ------------------------------------------------------ */
+static void tree_remove(arena_t *a, char *bp)
+{
+    char **link = &a->tree_root;
+    char *l, *r;
+
+    while (*link != bp)
+        link = TREE_LESS(bp, *link) ? &LEFT(*link) : &RIGHT(*link);
+
+    l = LEFT(bp);                                  /* l 의 키는 모두 r 의 키보다 작음 */
+    r = RIGHT(bp);
+    while (l != NULL && r != NULL) {
+        if (tree_prio(l) > tree_prio(r)) {
+            *link = l;
+            link = &RIGHT(l);
+            l = RIGHT(l);
+        } else {
+            *link = r;
+            link = &LEFT(r);
+            r = LEFT(r);
+        }
+    }
+    *link = (l != NULL) ? l : r;
+}
+
+/* ------------------------------------------------------ */
+/* tree_best_fit - 크기 asize 이상인 블록 중 가장 작은 것(동률이면 */
+/*   낮은 주소)을 루트에서 한 번 내려가며 찾음, 없으면 NULL       */
+/* ------------------------------------------------------ */
+static char *tree_best_fit(arena_t *a, size_t asize)
+{
+    char *t = a->tree_root, *best = NULL;
+
+    while (t != NULL) {
+        a->fit_examined++;
+        if (GET_SIZE(HDRP(t)) >= asize) {
+            best = t;
+            t = LEFT(t);
+        } else {
+            t = RIGHT(t);
+        }
+    }
+    return best;
+}
+#endif /* TREE_MIN_SIZE */
+
+/* ------------------------------------------------------ */
+/* coalesce - 인접한 free 블록을 즉시 병합하여 큰 블록 확보 */
+/*   prev_alloc / next_alloc 조합에 따라 4가지 경우 처리     */
+/*   병합에 쓰인 이웃은 리스트에서 빼고, 결과 블록을 삽입    */
+/*   bp의 헤더/풋터는 이미 free 로 기록되어 있어야 함         */
+/* ------------------------------------------------------ */
+static void *coalesce(arena_t *a, void *bp)
+{
+    /* 이전 블록의 할당 여부: 현재 헤더의 PREV_ALLOC 비트로 판단 */
+    size_t prev_alloc = GET_PREV_ALLOC(HDRP(bp));
+    /* 다음 블록의 할당 여부: 다음 블록의 헤더를 보고 판단 */
+    size_t next_alloc = GET_ALLOC(HDRP(NEXT_BLKP(bp)));
+    /* 현재 블록의 크기 */
+    size_t size = GET_SIZE(HDRP(bp));
+
+    if (prev_alloc && next_alloc) { /* Case 1: 양쪽 모두 할당 -> 병합 없음 */
+        /* 그대로 리스트에 삽입 */
+    }
+    else if (prev_alloc && !next_alloc) { /* Case 2: 다음만 free -> 현재와 다음 병합 */
+        remove_free_block(a, NEXT_BLKP(bp));
+        size += GET_SIZE(HDRP(NEXT_BLKP(bp)));     /* 다음 블록 크기 더하기 */
+        SET_HDR(bp, size, 0);                      /* 새 크기로 현재 헤더 갱신 */
+        PUT(FTRP(bp), PACK(size, 0));              /* 새 크기로 현재 풋터 갱신 */
+    }
+    else if (!prev_alloc && next_alloc) { /* Case 3: 이전만 free -> 이전과 현재 병합 */
+        remove_free_block(a, PREV_BLKP(bp));
+        size += GET_SIZE(HDRP(PREV_BLKP(bp)));     /* 이전 블록 크기 더하기 */
+        PUT(FTRP(bp), PACK(size, 0));              /* 새 크기로 최종 풋터 갱신 */
+        SET_HDR(PREV_BLKP(bp), size, 0);           /* 이전 블록 헤더를 새 크기로 */
+        bp = PREV_BLKP(bp);                         /* bp를 병합된 블록의 시작으로 이동 */
+    }
+    else { /* Case 4: 양쪽 모두 free -> 세 블록(이전,현재,다음) 전부 병합 */
+        remove_free_block(a, PREV_BLKP(bp));
+        remove_free_block(a, NEXT_BLKP(bp));
+        size += GET_SIZE(HDRP(PREV_BLKP(bp)))      /* 이전 블록 크기 */
+              + GET_SIZE(FTRP(NEXT_BLKP(bp)));     /* 다음 블록 크기
+                                                      (참고: HDRP(NEXT_BLKP(bp))를 써도 동일) */
+        SET_HDR(PREV_BLKP(bp), size, 0);           /* 병합된 헤더(이전 블록 헤더 위치) */
+        PUT(FTRP(NEXT_BLKP(bp)), PACK(size, 0));   /* 병합된 풋터(다음 블록 풋터 위치) */
+        bp = PREV_BLKP(bp);                         /* bp를 병합된 블록의 시작으로 이동 */
+    }
+    CLR_PREV_ALLOC(HDRP(NEXT_BLKP(bp)));            /* 뒤 블록에게 앞이 free 임을 알림 */
+    insert_free_block(a, bp);                       /* 병합 결과를 새 크기의 클래스에 삽입 */
+    CHECK_FREE(bp);
+    return bp;
+}
+
+/* ------------------------------------------------------ */
+/* find_fit - asize 이상 수용 가능한 가용 블록 탐색            */
+/*   asize의 클래스부터 시작해 큰 클래스로 올라감              */
+/*   (free 블록만 방문하므로 힙 전체를 훑지 않음)              */
+/*   정책은 FIT_POLICY 로 하나만 컴파일되어 mm_malloc에 인라인 */
+/*   TREE_MIN_SIZE 이상은 리스트에 없으므로, 큰 요청이나 리스트  */
+/*   탐색이 실패한 경우는 트리에서 best-fit                    */
+/* ------------------------------------------------------ */
+static inline void *find_fit(arena_t *a, size_t asize)
+{
+    int c;
+    char *bp;
+
+    a->fit_calls++;
+#if TREE_MIN_SIZE
+    if (asize >= TREE_MIN_SIZE)
+        return tree_best_fit(a, asize);
+#endif
+
+#if FIT_POLICY == FIT_FIRST
+    /* First Fit: 처음 맞는 free 블록 반환 */
+    for (c = size_class(asize); c < NUM_CLASSES; c++) {
+        for (bp = a->seg_heads[c]; bp != NULL; bp = SUCC(bp)) {
+            a->fit_examined++;
+            if (asize <= GET_SIZE(HDRP(bp)))
+                return bp;
+        }
+    }
+
+#elif FIT_POLICY == FIT_NEXT
+    /* Next Fit: 클래스마다 지난번에 멈춘 곳(rover)부터 끝까지, */
+    /*           못 찾으면 리스트 앞에서 rover 직전까지          */
+    for (c = size_class(asize); c < NUM_CLASSES; c++) {
+        for (bp = a->rovers[c]; bp != NULL; bp = SUCC(bp)) {
+            a->fit_examined++;
+            if (asize <= GET_SIZE(HDRP(bp)))
+                return a->rovers[c] = bp;
+        }
+        for (bp = a->seg_heads[c]; bp != a->rovers[c]; bp = SUCC(bp)) {
+            a->fit_examined++;
+            if (asize <= GET_SIZE(HDRP(bp)))
+                return a->rovers[c] = bp;
+        }
+    }
+
+#elif FIT_POLICY == FIT_BEST || FIT_POLICY == FIT_GOOD
+    /* Best/Good Fit: 맞는 블록 중 가장 작은 것.                */
+    /*   위 클래스의 블록은 항상 더 크므로 후보를 찾은 클래스에서 멈춤 */
+    /*   good-fit 은 후보 GOOD_FIT_LIMIT 개만 보고 결정            */
+    char *best = NULL;
+    size_t bsize = 0, size;
+#if FIT_POLICY == FIT_GOOD
+    int seen = 0;                                  /* 지금까지 본 후보 수 */
+#endif
+
+    for (c = size_class(asize); c < NUM_CLASSES && best == NULL; c++) {
+        for (bp = a->seg_heads[c]; bp != NULL; bp = SUCC(bp)) {
+            a->fit_examined++;
+            size = GET_SIZE(HDRP(bp));
+            if (asize > size)
+                continue;
+            if (size == asize)                     /* 딱 맞으면 더 볼 필요 없음 */
+                return bp;
+            if (best == NULL || size < bsize) {
+                best = bp;
+                bsize = size;
+            }
+#if FIT_POLICY == FIT_GOOD
+            if (++seen >= GOOD_FIT_LIMIT)
+                return best;
+#endif
+        }
+    }
+    if (best != NULL)
+        return best;
+
+#else
+#error "FIT_POLICY must be one of FIT_FIRST, FIT_NEXT, FIT_BEST, FIT_GOOD"
+#endif
+
+#if TREE_MIN_SIZE
+    return tree_best_fit(a, asize);                /* 리스트에 없으면 큰 블록 중 best-fit */
+#else
+    return NULL;                                   /* 적합 블록 없음 */
+#endif
+}
+
+/* ------------------------------------------------------ */
+/* place - 찾은 free 블록 bp에 asize만큼 배치, 남으면 분할      */
+/*   분할 임계: 남는 공간이 최소 블록(MINBLOCK) 이상일 때만 분할  */
+/*   남은 뒷부분은 새 크기에 맞는 클래스 리스트로 옮겨감          */
+/* ------------------------------------------------------ */
+static void place(arena_t *a, void *bp, size_t asize)
+{
+    size_t csize = GET_SIZE(HDRP(bp));             /* 현재 free 블록의 총 크기 */
+
+    remove_free_block(a, bp);                      /* 더 이상 가용 블록이 아님 */
+
+    if ((csize - asize) >= MINBLOCK) {             /* 분할 가능한 충분한 여유 */
+        SET_HDR(bp, asize, 1);                     /* 앞쪽 조각을 할당 상태로 설정 */
+        SET_ALLOC_FTR(bp, asize);
+
+        bp = NEXT_BLKP(bp);                        /* 남은 뒷부분을 새 free 블록으로 설정 */
+        PUT(HDRP(bp), PACK(csize - asize, 0) | PREV_ALLOC);
+        PUT(FTRP(bp), PACK(csize - asize, 0));
+        insert_free_block(a, bp);
+        CHECK_FREE(bp);
+    } else {                                       /* 분할하지 않고 전부 할당 */
+        SET_HDR(bp, csize, 1);
+        SET_ALLOC_FTR(bp, csize);
+        SET_PREV_ALLOC(HDRP(NEXT_BLKP(bp)));       /* 뒤 블록에게 앞이 할당됨을 알림 */
+    }
+}
+
+/* ------------------------------------------------------ */
+/* adjust_size - 요청 크기 size를 실제 블록 크기(asize)로 정규화 */
+/* ------------------------------------------------------ */
+static inline size_t adjust_size(size_t size)
+{
+    /* size + 헤더(/풋터) 후 ALIGNMENT 배수로 반올림(덧셈과 마스크) */
+    size_t asize = ALIGN(size + OVERHEAD);
+
+    /* 최소 블록 보장: free 가 되었을 때 링크 포인터를 담을 수 있는 MINBLOCK 이상.
+     * 분기 대신 조건부 이동(cmov)으로 컴파일됨 */
+    return MAX(asize, MINBLOCK);
+}
+
+/* ------------------------------------------------------ */
+/* shrink_block - 할당 블록 bp를 asize로 줄이고 남는 뒷부분을 free 로 */
+/*   남는 공간이 MINBLOCK 미만이면 그대로 둠(내부 단편화로 흡수)      */
+/*   잘린 조각은 coalesce 로 오른쪽 free 이웃과 합쳐 리스트에 들어감  */
+/* ------------------------------------------------------ */
+static void shrink_block(arena_t *a, void *bp, size_t asize)
+{
+    size_t csize = GET_SIZE(HDRP(bp));
+    char *rest;
+
+    if ((csize - asize) < MINBLOCK)
+        return;
+
+    SET_HDR(bp, asize, 1);
+    SET_ALLOC_FTR(bp, asize);
+
+    rest = NEXT_BLKP(bp);
+    PUT(HDRP(rest), PACK(csize - asize, 0) | PREV_ALLOC);
+    PUT(FTRP(rest), PACK(csize - asize, 0));
+    coalesce(a, rest);
+}
+
+/* ------------------------------------------------------ */
+/* heap_malloc - 정규화된 크기 asize의 블록을 공유 힙에서 할당  */
+/*   1) 가용 블록 탐색 → 2) 없으면 확장                          */
+/*   DEFER_COALESCE: 같은 크기 quick 블록을 먼저 쓰고, 탐색이     */
+/*   실패하면 quick 리스트를 병합(sweep)한 뒤 한 번 더 탐색       */
+/* ------------------------------------------------------ */
+static void *heap_malloc(arena_t *a, size_t asize)
+{
+    void *bp;
+
+#if DEFER_COALESCE
+    if (asize <= QUICK_MAX_SIZE && (bp = a->quick[QUICK_INDEX(asize)]) != NULL) {
+        a->quick[QUICK_INDEX(asize)] = QUICK_NEXT(bp); /* 이미 할당 상태: 그대로 반환 */
+        a->quick_counts[QUICK_INDEX(asize)]--;
+        return bp;
+    }
+#endif
+
+    /* 1) 분리 리스트 탐색 */
+    bp = find_fit(a, asize);
+#if DEFER_COALESCE
+    if (bp == NULL && quick_sweep(a))
+        bp = find_fit(a, asize);
+#endif
+    if (bp != NULL) {
+        place(a, bp, asize);
+        return bp;                                 /* 배치한 payload 포인터 반환 */
+    }
+
+    /* 2) 적합 블록이 없으면 힙 확장 후 배치 */
+    size_t extendsize = MAX(asize, CHUNKSIZE);     /* 한번에 최소 CHUNKSIZE만큼 늘림 */
+    if ((bp = extend_heap(a, extendsize / WSIZE)) == NULL)
+        return NULL;                               /* 확장 실패 시 NULL */
+    place(a, bp, asize);
+    return bp;
+}
+
+/* ------------------------------------------------------ */
+/* heap_free - 블록을 공유 힙에 반환하고 인접 free 블록과 즉시 병합 */
+/*   슬랩 칸이면 슬랩으로 보냄                                    */
+/*   DEFER_COALESCE: 작은 블록은 병합하지 않고 quick 리스트에 둠   */
+/* ------------------------------------------------------ */
+static void heap_free(arena_t *a, void *bp)
+{
+#if SLAB_MAX_SIZE
+    if (slab_run_of(bp) != NULL) {                 /* 헤더 없는 슬랩 칸 */
+        slab_free(a, bp);
+        return;
+    }
+#endif
+    block_free(a, bp);
+}
+
+/* ------------------------------------------------------ */
+/* block_free - 헤더가 있는 블록을 아레나에 반환 (heap_free 참고)  */
+/* ------------------------------------------------------ */
+static void block_free(arena_t *a, void *bp)
+{
+#if DEFER_COALESCE
+    size_t size = GET_SIZE(HDRP(bp));
+
+    if (size <= QUICK_MAX_SIZE) {
+        QUICK_NEXT(bp) = a->quick[QUICK_INDEX(size)];
+        a->quick[QUICK_INDEX(size)] = bp;
+        if (++a->quick_counts[QUICK_INDEX(size)] > QUICK_COUNT)
+            quick_sweep(a);                        /* 너무 길어지면 한꺼번에 병합 */
+        return;
+    }
+#endif
+    release_block(a, bp);
+}
+
+/* ------------------------------------------------------ */
+/* release_block - 블록을 free 로 표시하고 인접 free 블록과 병합  */
+/*   힙 끝에 TRIM_THRESHOLD 이상 free 블록이 생기면 반환           */
+/* ------------------------------------------------------ */
+static void release_block(arena_t *a, void *bp)
+{
+    size_t size = GET_SIZE(HDRP(bp));              /* 현재 블록의 전체 크기 */
+    SET_HDR(bp, size, 0);                          /* 헤더를 free로 마킹 */
+    PUT(FTRP(bp), PACK(size, 0));                  /* 풋터를 free로 마킹 */
+    bp = coalesce(a, bp);                          /* 인접 free 블록과 병합(뒤 블록 비트 갱신 포함) */
+#if TRIM_THRESHOLD
+    /* 힙 끝에 큰 free 블록이 생겼으면 다음 확장분(CHUNKSIZE)만 남기고 반환 */
+    if (GET_SIZE(HDRP(bp)) >= TRIM_THRESHOLD && GET_SIZE(HDRP(NEXT_BLKP(bp))) == 0)
+        heap_trim(a, CHUNKSIZE);
+#endif
+}
+
+#if DEFER_COALESCE
+/* ------------------------------------------------------ */
+/* quick_sweep - quick 리스트의 블록을 모두 free 로 돌리며 병합    */
+/*   이웃한 quick 블록끼리도 차례로 합쳐짐. 처리한 블록이 있으면 1 */
+/* ------------------------------------------------------ */
+static int quick_sweep(arena_t *a)
+{
+    char *bp, *next;
+    int i, swept = 0;
+
+    for (i = 0; i < QUICK_BINS; i++) {
+        for (bp = a->quick[i]; bp != NULL; bp = next) {
+            next = QUICK_NEXT(bp);
+            release_block(a, bp);
+            swept = 1;
+        }
+        a->quick[i] = NULL;
+        a->quick_counts[i] = 0;
+    }
+    return swept;
+}
+#endif
+
+/* ------------------------------------------------------ */
+/* heap_trim - 힙(아레나의 마지막 영역) 끝의 free 블록을 pad      */
+/*   바이트만 남기고 mem_trim 으로 돌려줌. 반환한 바이트 수 리턴   */
+/*   에필로그의 PREV_ALLOC 비트로 마지막 블록이 free 인지 판단     */
+/* ------------------------------------------------------ */
+static size_t heap_trim(arena_t *a, size_t pad)
+{
+    char *end, *bp;
+    size_t size, keep, trim;
+
+#if MM_ARENAS
+    if ((end = a->end) == NULL)                    /* 아직 영역이 없는 아레나 */
+        return 0;
+#else
+    end = (char *)mem_heap_hi() + 1;
+#endif
+    if (GET_PREV_ALLOC(end - WSIZE))               /* 에필로그 앞 블록이 할당 상태 */
+        return 0;
+    size = GET_SIZE(end - DSIZE);                  /* 마지막 free 블록의 풋터 */
+    bp = end - size;
+
+    keep = ALIGN(pad);
+    if (keep > 0 && keep < MINBLOCK)               /* 남길 조각도 블록이 되어야 함 */
+        keep = MINBLOCK;
+    if (keep >= size)
+        return 0;
+    trim = size - keep;
+#if MM_ARENAS
+    trim &= ~(size_t)(ARENA_GRAIN - 1);            /* 영역은 ARENA_GRAIN 단위로만 */
+    if (trim < size && size - trim < MINBLOCK)
+        trim -= ARENA_GRAIN;
+    if (trim == 0 || trim > size)
+        return 0;
+    keep = size - trim;
+#endif
+
+    /* 링크를 읽으려면 반환 전에 리스트에서 빼야 함. 다른 아레나가 그새 */
+    /* 힙을 늘렸으면(끝이 바뀜) mem_trim 이 실패하므로 되돌림           */
+    remove_free_block(a, bp);
+    if (mem_trim(end, trim) < 0) {
+        insert_free_block(a, bp);
+        return 0;
+    }
+    if (keep > 0) {
+        SET_HDR(bp, keep, 0);
+        PUT(FTRP(bp), PACK(keep, 0));
+        PUT(HDRP(NEXT_BLKP(bp)), PACK(0, 1));      /* 새 에필로그 (앞=free) */
+        insert_free_block(a, bp);
+    } else {
+        /* 블록 헤더 자리가 새 에필로그: 앞 블록은 할당 상태(병합됐으므로) */
+        PUT(HDRP(bp), PACK(0, 1) | GET_PREV_ALLOC(HDRP(bp)));
+    }
+#if MM_ARENAS
+    a->end = end - trim;
+#endif
+    return trim;
+}
+
+/* ------------------------------------------------------ */
+/* heap_realloc - 가능한 한 제자리(in-place)에서 크기 변경       */
+/*   1) 줄이는 경우: 뒷부분을 분할해 free 로 돌려줌               */
+/*   2) 오른쪽 블록이 free 이고 합쳐서 충분하면 흡수              */
+/*   3) 힙의 마지막 블록이면 모자란 만큼만 힙을 확장해 흡수       */
+/*   4) 왼쪽(+오른쪽) free 와 합쳐 충분하면 병합 후 memmove       */
+/*   5) 모두 안 되면 새로 할당 → 복사 → 원래 free                 */
+/*      (MMAP_THRESHOLD 이상이면 새 블록은 매핑: 이후 확장은 mremap) */
+/*   (슬랩 칸은 slab_realloc 이 처리)                             */
+/* ------------------------------------------------------ */
+static void *heap_realloc(arena_t *a, void *ptr, size_t size)
+{
+#if SLAB_MAX_SIZE
+    if (slab_run_of(ptr) != NULL)
+        return slab_realloc(a, ptr, size);
+#endif
+    size_t asize = adjust_size(size);
+    size_t oldsize = GET_SIZE(HDRP(ptr));          /* 기존 블록 전체 크기 */
+    char *next = NEXT_BLKP(ptr);
+    size_t next_free = !GET_ALLOC(HDRP(next));
+    size_t nsize = next_free ? GET_SIZE(HDRP(next)) : 0; /* 흡수 가능한 오른쪽 크기 */
+    size_t total;
+
+    /* 1) 축소(또는 그대로): 제자리에서 분할 */
+    if (asize <= oldsize) {
+        shrink_block(a, ptr, asize);
+        return ptr;
+    }
+
+    /* 3) 오른쪽이 에필로그(또는 free 뒤 에필로그)면 모자란 만큼 힙 확장 */
+    /*    extend_heap 이 새 영역을 오른쪽 free 와 병합해 주므로 2)로 이어짐 */
+    if (oldsize + nsize < asize &&
+        GET_SIZE(HDRP(next_free ? NEXT_BLKP(next) : next)) == 0) {
+        /* 새 조각이 잠시 free 블록이 되므로 최소 MINBLOCK 은 늘려야 함 */
+        if (extend_heap(a, MAX(asize - oldsize - nsize, MINBLOCK) / WSIZE) == NULL)
+            return NULL;
+        /* 아레나 모드에선 새 영역이 떨어진 곳에 올 수 있으므로 다시 확인 */
+        next_free = !GET_ALLOC(HDRP(next));
+        nsize = next_free ? GET_SIZE(HDRP(next)) : 0;
+    }
+
+    /* 2) 오른쪽 free 흡수 */
+    if (oldsize + nsize >= asize) {
+        remove_free_block(a, next);
+        total = oldsize + nsize;
+        SET_HDR(ptr, total, 1);
+        SET_ALLOC_FTR(ptr, total);
+        SET_PREV_ALLOC(HDRP(NEXT_BLKP(ptr)));      /* 흡수한 free 뒤 블록: 앞이 이제 할당 */
+        shrink_block(a, ptr, asize);
+        return ptr;
+    }
+
+    /* 4) 왼쪽 free 와 병합: payload 가 겹칠 수 있으므로 memmove */
+    if (!GET_PREV_ALLOC(HDRP(ptr))) {
+        char *prev = PREV_BLKP(ptr);
+        total = GET_SIZE(HDRP(prev)) + oldsize + nsize;
+        if (total >= asize) {
+            remove_free_block(a, prev);
+            if (next_free)
+                remove_free_block(a, next);
+            SET_HDR(prev, total, 1);               /* 헤더는 prev payload 앞, 데이터와 안 겹침 */
+            memmove(prev, ptr, oldsize - OVERHEAD); /* 기존 payload 를 앞으로 당김 */
+            SET_ALLOC_FTR(prev, total);            /* 풋터는 이동이 끝난 뒤에 기록 */
+            SET_PREV_ALLOC(HDRP(NEXT_BLKP(prev)));
+            shrink_block(a, prev, asize);
+            return prev;
+        }
+    }
+
+    /* 5) 새 블록 요청 */
+    void *newptr;
+#if MMAP_THRESHOLD
+    if (size >= MMAP_THRESHOLD)
+        newptr = map_malloc(size);
+    else
+#endif
+    newptr = heap_malloc(a, asize);
+    if (newptr == NULL) return NULL;
+
+    /* 복사 크기: 늘리는 경우만 여기 오므로 기존 payload 전체 */
+    memcpy(newptr, ptr, oldsize - OVERHEAD);       /* 기존 블록의 payload 크기(헤더/풋터 제외) */
+
+    /* 기존 블록 해제 */
+    heap_free(a, ptr);
+    return newptr;
+}
+
+/* ------------------------------------------------------ */
+/* heap_memalign - payload 가 align 배수 주소인 asize 블록 할당   */
+/*   넉넉히 할당한 뒤, 정렬 지점 앞 조각(MINBLOCK 이상)은 free 로 */
+/*   돌려 병합하고 뒤에 남는 부분은 shrink_block 으로 잘라냄       */
+/*   작은 요청은 여유분을 다음 클래스 하한까지 올려 받음(잠깐만 씀): */
+/*   그 클래스의 첫 블록이 반드시 맞아, 정렬 요청이 남긴 자투리로     */
+/*   가득한 작은 클래스 리스트를 훑지 않음                            */
+/* ------------------------------------------------------ */
+static void *heap_memalign(arena_t *a, size_t align, size_t asize)
+{
+    char *bp, *p;
+    size_t size, lead, want = asize + align + MINBLOCK;
+    int c = size_class(want);
+
+    if (want < CLASS_TABLE_MAX && c + 1 < NUM_CLASSES)
+        want = MAX(want, class_min(c + 1));
+    if ((bp = heap_malloc(a, want)) == NULL)
+        return NULL;
+    p = (char *)(((uintptr_t)bp + align - 1) & ~(uintptr_t)(align - 1));
+    if (p != bp && (size_t)(p - bp) < MINBLOCK)    /* 앞 조각이 블록이 되기엔 작음 */
+        p += align;
+
+    if ((lead = p - bp) > 0) {
+        size = GET_SIZE(HDRP(bp));
+        PUT(HDRP(p), PACK(size - lead, 1));        /* 뒤 블록: 할당, 앞=free */
+        SET_ALLOC_FTR(p, size - lead);
+        SET_HDR(bp, lead, 0);                      /* 앞 조각을 free 로 */
+        PUT(FTRP(bp), PACK(lead, 0));
+        coalesce(a, bp);                           /* 왼쪽 free 와 합치고 리스트에 삽입 */
+    }
+    shrink_block(a, p, asize);
+    return p;
+}
+
+#if SLAB_MAX_SIZE
+/* ====== 작은 객체용 슬랩 ====== */
+
+/* ------------------------------------------------------ */
+/* slab_run_of - 주소를 페이지 경계로 내려(mask) run 을 찾음       */
+/*   run 이 시작하는 페이지인지는 slab_map 으로 확인               */
+/* ------------------------------------------------------ */
+static inline slab_run_t *slab_run_of(void *bp)
+{
+    char *page = (char *)((uintptr_t)bp & ~(uintptr_t)(SLAB_PAGE - 1));
+
+    if (page < slab_heap_lo || !slab_map[(page - slab_heap_lo) / SLAB_PAGE])
+        return NULL;
+    return (slab_run_t *)page;
+}
+
+/* ------------------------------------------------------ */
+/* slab_new_run - 클래스 c 용 run 을 만들어 리스트 맨 앞에 둠      */
+/*   run 은 payload 가 SLAB_PAGE 정렬된 일반 할당 블록              */
+/* ------------------------------------------------------ */
+static slab_run_t *slab_new_run(arena_t *a, int c)
+{
+    slab_run_t *run;
+    unsigned int i;
+
+    if ((run = heap_memalign(a, SLAB_PAGE, adjust_size(SLAB_PAGE))) == NULL)
+        return NULL;
+    run->osize = (c + 1) * ALIGNMENT;
+    run->nobj = run->nfree = (SLAB_PAGE - SLAB_HDR) / run->osize;
+    memset(run->freemap, 0, sizeof(run->freemap));
+    for (i = 0; i < run->nobj; i++)
+        run->freemap[i / 64] |= 1ULL << (i % 64);
+
+    run->prev = NULL;
+    run->next = a->slabs[c];
+    if (run->next != NULL)
+        run->next->prev = run;
+    a->slabs[c] = run;
+    slab_map[((char *)run - slab_heap_lo) / SLAB_PAGE] = 1;
+    return run;
+}
+
+/* slab_unlink - 빈 칸 리스트에서 run 제거 */
+static void slab_unlink(arena_t *a, slab_run_t *run)
+{
+    if (run->prev != NULL)
+        run->prev->next = run->next;
+    else
+        a->slabs[SLAB_CLASS(run->osize)] = run->next;
+    if (run->next != NULL)
+        run->next->prev = run->prev;
+    run->next = run->prev = NULL;
+}
+
+/* ------------------------------------------------------ */
+/* slab_malloc - size 가 들어가는 클래스의 첫 run 에서 빈 칸 하나   */
+/*   비트맵의 가장 낮은 1 비트(ctz)가 빈 칸, 다 차면 리스트에서 뺌 */
+/* ------------------------------------------------------ */
+static void *slab_malloc(arena_t *a, size_t size)
+{
+    int c = SLAB_CLASS(size), w, i;
+    slab_run_t *run = a->slabs[c];
+
+    if (run == NULL && (run = slab_new_run(a, c)) == NULL)
+        return NULL;
+    for (w = 0; run->freemap[w] == 0; w++)
+        ;
+    i = __builtin_ctzll(run->freemap[w]);
+    run->freemap[w] &= run->freemap[w] - 1;        /* 가장 낮은 1 비트 지우기 */
+    if (--run->nfree == 0)
+        slab_unlink(a, run);
+    return (char *)run + SLAB_HDR + (size_t)(w * 64 + i) * run->osize;
+}
+
+/* ------------------------------------------------------ */
+/* slab_free - 칸을 비트맵에 돌려줌                               */
+/*   꽉 찼던 run 은 다시 리스트로, 완전히 빈 run 은 클래스에 다른  */
+/*   run 이 있을 때만 힙에 반환(하나는 남겨 생성/반환 반복 방지)   */
+/* ------------------------------------------------------ */
+static void slab_free(arena_t *a, void *bp)
+{
+    slab_run_t *run = slab_run_of(bp);
+    unsigned int i = ((char *)bp - (char *)run - SLAB_HDR) / run->osize;
+    int c = SLAB_CLASS(run->osize);
+
+    run->freemap[i / 64] |= 1ULL << (i % 64);
+    if (run->nfree++ == 0) {
+        run->prev = NULL;
+        run->next = a->slabs[c];
+        if (run->next != NULL)
+            run->next->prev = run;
+        a->slabs[c] = run;
+    } else if (run->nfree == run->nobj && (run->prev != NULL || run->next != NULL)) {
+        slab_unlink(a, run);
+        slab_map[((char *)run - slab_heap_lo) / SLAB_PAGE] = 0;
+        heap_free(a, run);                         /* 페이지를 일반 free 블록으로 */
+    }
+}
+
+/* ------------------------------------------------------ */
+/* slab_realloc - 같은 클래스면 그대로, 아니면 새로 할당 후 복사   */
+/* ------------------------------------------------------ */
+static void *slab_realloc(arena_t *a, void *ptr, size_t size)
+{
+    slab_run_t *run = slab_run_of(ptr);
+    void *newptr;
+
+    if (size <= SLAB_MAX_SIZE) {
+        if (SLAB_CLASS(size) == SLAB_CLASS(run->osize))
+            return ptr;
+        newptr = slab_malloc(a, size);
+    } else {
+#if MMAP_THRESHOLD
+        if (size >= MMAP_THRESHOLD)                /* mm_malloc 과 같이 전용 매핑 */
+            newptr = map_malloc(size);
+        else
+#endif
+        newptr = heap_malloc(a, adjust_size(size));
+    }
+    if (newptr == NULL) return NULL;
+    memcpy(newptr, ptr, MIN(size, run->osize));
+    slab_free(a, ptr);
+    return newptr;
+}
+#endif /* SLAB_MAX_SIZE */
+
+/* ------------------------------------------------------ */
+/* thread_arena - 호출 스레드가 할당에 쓸 아레나               */
+/* ------------------------------------------------------ */
+#if MM_ARENAS
+static void arena_attach(void);
+#endif
+static inline arena_t *thread_arena(void)
+{
+#if MM_ARENAS
+    if (my_arena == NULL)
+        arena_attach();                            /* 스레드의 첫 할당: 아레나 배정 */
+    return my_arena;
+#else
+    return &main_arena;
+#endif
+}
+
+#if MMAP_THRESHOLD
+/* ====== 직접 매핑(huge) 블록 ====== */
+
+/* ------------------------------------------------------ */
+/* map_malloc - size 바이트 payload 를 담을 전용 매핑 할당       */
+/*   아레나/락과 무관: mem_map 이 알아서 동기화                 */
+/* ------------------------------------------------------ */
+static void *map_malloc(size_t size)
+{
+    size_t len = PAGE_UP(MAP_HDR + size);
+    char *base;
+
+    if ((base = mem_map(len)) == NULL)
+        return NULL;
+    __atomic_add_fetch(&map_blocks, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&map_bytes, len, __ATOMIC_RELAXED);
+    MAP_LEN(base + MAP_HDR) = len;
+    return base + MAP_HDR;
+}
+
+/* ------------------------------------------------------ */
+/* map_free - 매핑 블록을 즉시 시스템에 반환                    */
+/* ------------------------------------------------------ */
+static void map_free(void *bp)
+{
+    __atomic_sub_fetch(&map_blocks, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&map_bytes, MAP_LEN(bp), __ATOMIC_RELAXED);
+    mem_unmap(MAP_BASE(bp));
+}
+
+/* ------------------------------------------------------ */
+/* map_realloc - 매핑 블록 크기 변경                            */
+/*   MMAP_THRESHOLD 이상이면 mem_remap 으로 페이지째 옮김(복사 없음) */
+/*   그보다 작아지면 힙 블록으로 옮기고 매핑 반환                 */
+/*   옮겼으면 옛 주소가 다시 쓰이기 전에 그 샘플을 지움            */
+/*   (새 블록의 샘플은 mm_realloc 이 기록)                          */
+/* ------------------------------------------------------ */
+static void *map_realloc(void *bp, size_t size)
+{
+    size_t len = PAGE_UP(MAP_HDR + size), oldlen = MAP_LEN(bp);
+    char *base;
+    void *newptr;
+    int held;
+
+    if (size < MMAP_THRESHOLD) {
+        if ((newptr = malloc_block(size)) == NULL)
+            return NULL;
+        memcpy(newptr, bp, size);                  /* 줄어드는 경우만 여기 옴 */
+        PROF_FREE(bp);
+        map_free(bp);
+        return newptr;
+    }
+    if (len == oldlen)
+        return bp;
+    held = PROF_MOVE_BEGIN(bp);                    /* mremap 이 옛 주소를 놓는 동안 */
+    base = mem_remap(MAP_BASE(bp), len);
+    PROF_MOVE_END(bp, held, base != NULL && base + MAP_HDR != (char *)bp);
+    if (base == NULL)
+        return NULL;
+    __atomic_add_fetch(&map_bytes, len - oldlen, __ATOMIC_RELAXED); /* 줄면 wrap-around 로 감소 */
+    MAP_LEN(base + MAP_HDR) = len;
+    return base + MAP_HDR;
+}
+#endif /* MMAP_THRESHOLD */
+
+/* 블록 bp를 관리하는 아레나 */
+#if MM_ARENAS
+#define OWNER(bp)       arena_of(bp)
+#else
+#define OWNER(bp)       (&main_arena)
+#endif
+
+#if MM_THREADS
+/* ====== 스레드 캐시(tcache) ====== */
+
+/*
+ * 스레드마다 asize 별(ALIGNMENT 간격) bin 을 두고, 비운 블록을 단일 연결 리스트로
+ * 보관합니다. 캐시 안의 블록은 힙에서는 여전히 "할당" 상태이므로 병합되지 않으며,
+ * 다음 링크는 payload 첫 워드에 저장합니다(원격 free 큐도 같은 링크를 씀).
+ * mm_init 이 힙을 새로 만들면 heap_epoch 가 바뀌고, 각 스레드는 다음 접근 때
+ * 예전 힙을 가리키는 캐시를 그냥 버립니다.
+ */
+#define TC_BINS         ((TCACHE_MAX_SIZE - MINBLOCK) / ALIGNMENT + 1)
+#define TC_INDEX(asize) (((asize) - MINBLOCK) / ALIGNMENT)
+#define TC_NEXT(bp)     (*(void **)(bp))
+
+typedef struct {
+    unsigned long epoch;                /* 이 캐시가 속한 힙 세대 */
+    void *bins[TC_BINS];                /* 크기별 캐시 블록 리스트 */
+    unsigned int counts[TC_BINS];       /* 크기별 캐시 블록 수 */
+} tcache_t;
+
+static __thread tcache_t tcache;        /* 스레드 전용: 접근에 동기화 불필요 */
+static __thread int thread_registered;  /* 스레드 종료 훅 등록 여부 */
+static unsigned long heap_epoch = 1;    /* mm_init 마다 증가 */
+static pthread_key_t thread_key;        /* 스레드 종료 시 thread_exit 호출용 */
+static pthread_once_t thread_key_once = PTHREAD_ONCE_INIT;
+
+static void thread_exit(void *arg);
+
+static void thread_make_key(void)
+{
+    pthread_key_create(&thread_key, thread_exit);
+}
+
+/* ------------------------------------------------------ */
+/* thread_register - 스레드의 첫 사용 때 종료 훅 등록           */
+/* ------------------------------------------------------ */
+static void thread_register(void)
+{
+    if (thread_registered)
+        return;
+    pthread_once(&thread_key_once, thread_make_key);
+    pthread_setspecific(thread_key, &tcache);
+    thread_registered = 1;
+}
+
+/* ------------------------------------------------------ */
+/* tcache_new_epoch - 힙 재초기화: 모든 스레드의 캐시를 무효화 */
+/* ------------------------------------------------------ */
+static void tcache_new_epoch(void)
+{
+    __atomic_add_fetch(&heap_epoch, 1, __ATOMIC_RELEASE);
+}
+
+/* ------------------------------------------------------ */
+/* tcache_check - 캐시가 현재 힙 세대 것인지 확인, 아니면 비움   */
+/* ------------------------------------------------------ */
+static inline void tcache_check(void)
+{
+    unsigned long epoch = __atomic_load_n(&heap_epoch, __ATOMIC_ACQUIRE);
+
+    if (tcache.epoch == epoch)
+        return;
+    memset(tcache.bins, 0, sizeof(tcache.bins));
+    memset(tcache.counts, 0, sizeof(tcache.counts));
+    tcache.epoch = epoch;
+    thread_register();
+}
+
+/* ------------------------------------------------------ */
+/* tcache_flush_bin - bin i를 keep 개만 남기고 소유 아레나로 반환 */
+/*   내 아레나 블록은 한 번의 락으로 heap_free, 남의 것은 원격 큐로 */
+/* ------------------------------------------------------ */
+static void tcache_flush_bin(size_t i, unsigned int keep)
+{
+    arena_t *me = thread_arena();
+    arena_t *owner;
+    void *victim;
+
+    ARENA_LOCK(me);
+    while (tcache.counts[i] > keep) {
+        victim = tcache.bins[i];
+        tcache.bins[i] = TC_NEXT(victim);
+        tcache.counts[i]--;
+        owner = OWNER(victim);
+#if MM_ARENAS
+        if (owner != me) {
+            remote_free(owner, victim);
+            continue;
+        }
+#endif
+        heap_free(owner, victim);
+    }
+    ARENA_UNLOCK(me);
+}
+
+/* ------------------------------------------------------ */
+/* thread_exit - 종료하는 스레드의 캐시를 반환하고 아레나를 놓음 */
+/* ------------------------------------------------------ */
+#if MM_ARENAS
+static void arena_detach(void);
+#endif
+static void thread_exit(void *arg)
+{
+    size_t i;
+
+    (void)arg;
+    if (tcache.epoch == __atomic_load_n(&heap_epoch, __ATOMIC_ACQUIRE)) {
+        for (i = 0; i < TC_BINS; i++)
+            if (tcache.counts[i] > 0)
+                tcache_flush_bin(i, 0);
+    }
+#if MM_ARENAS
+    arena_detach();
+#endif
+}
+
+/* ------------------------------------------------------ */
+/* tcache_get - asize 크기의 캐시 블록을 꺼냄(없으면 NULL)      */
+/* ------------------------------------------------------ */
+static void *tcache_get(size_t asize)
+{
+    void *bp;
+    size_t i;
+
+    if (asize > TCACHE_MAX_SIZE)
+        return NULL;
+    tcache_check();
+    i = TC_INDEX(asize);
+    if ((bp = tcache.bins[i]) != NULL) {
+        tcache.bins[i] = TC_NEXT(bp);
+        tcache.counts[i]--;
+    }
+    return bp;
+}
+
+/* ------------------------------------------------------ */
+/* tcache_refill - 방금 asize 캐시가 비었으므로                 */
+/*   아레나 a에서 TCACHE_BATCH-1 개를 더 할당해 bin 에 채움(락 보유) */
+/* ------------------------------------------------------ */
+static void tcache_refill(arena_t *a, size_t asize)
+{
+    void *bp;
+    size_t i;
+    int n;
+
+    if (asize > TCACHE_MAX_SIZE)
+        return;
+    i = TC_INDEX(asize);
+    for (n = 1; n < TCACHE_BATCH && tcache.counts[i] < TCACHE_COUNT; n++) {
+        if ((bp = heap_malloc(a, asize)) == NULL)
+            break;
+        if (GET_SIZE(HDRP(bp)) != asize) {         /* 분할 안 된 큰 블록은 캐시 bin 과 안 맞음 */
+            heap_free(a, bp);
+            break;
+        }
+        TC_NEXT(bp) = tcache.bins[i];
+        tcache.bins[i] = bp;
+        tcache.counts[i]++;
+    }
+}
+
+/* ------------------------------------------------------ */
+/* tcache_put - 블록 bp를 캐시에 넣음. 캐시 대상이 아니면 0     */
+/*   bin 이 가득 차면 절반을 한 번의 락으로 돌려줌(flush)        */
+/* ------------------------------------------------------ */
+static int tcache_put(void *bp, int slab)
+{
+#if SLAB_MAX_SIZE
+    if (slab && slab_run_of(bp) != NULL)           /* 슬랩 칸은 헤더가 없어 캐시 대상 아님 */
+        return 0;
+#else
+    (void)slab;
+#endif
+    /* 락 없이 자기 블록 헤더를 읽음: 다른 스레드는 락을 잡고 PREV_ALLOC 비트만 */
+    /* 바꿀 수 있고 크기 비트는 그대로이므로 relaxed load 로 충분               */
+    size_t size = __atomic_load_n((word_t *)HDRP(bp), __ATOMIC_RELAXED) & ~0x7;
+    size_t i;
+
+    if (size > TCACHE_MAX_SIZE)
+        return 0;
+    tcache_check();
+    i = TC_INDEX(size);
+    if (tcache.counts[i] >= TCACHE_COUNT)
+        tcache_flush_bin(i, TCACHE_COUNT / 2);
+    TC_NEXT(bp) = tcache.bins[i];
+    tcache.bins[i] = bp;
+    tcache.counts[i]++;
+    return 1;
+}
+#endif /* MM_THREADS */
+
+#if MM_ARENAS
+/* ====== 스레드별 아레나 ====== */
+
+/*
+ * 각 스레드는 풀에서 전담 아레나를 하나 받습니다(모두 배정되면 돌아가며 공유).
+ * 아레나는 memlib 에서 ARENA_GRAIN 배수 크기의 영역을 받아 쓰고, arena_map 에
+ * 영역의 각 칸 → 아레나 번호를 기록해 두므로 블록 주소만으로 소유자를 찾습니다.
+ * 다른 스레드가 블록을 free 하면 소유 아레나의 remote 스택에 CAS 로 push 하고,
+ * 소유자는 다음 mm_malloc·mm_free 때 스택 전체를 한 번에 떼어와(exchange)
+ * 병합합니다. 힙이 모자랄 때, 아레나를 놓을 때와 넘겨받을 때도 병합합니다.
+ */
+#define REMOTE_NEXT(bp) (*(void **)(bp))
+
+/* ------------------------------------------------------ */
+/* arena_of - 블록 bp가 들어있는 영역의 소유 아레나           */
+/* ------------------------------------------------------ */
+static inline arena_t *arena_of(void *bp)
+{
+    size_t idx = ((char *)bp - (char *)mem_heap_lo()) / ARENA_GRAIN;
+
+    return &arenas[arena_map[idx] - 1];
+}
+
+/* ------------------------------------------------------ */
+/* arena_attach - 호출 스레드에 아레나 배정                       */
+/*   주인 없는 아레나(종료한 스레드가 놓은 것 포함)를 우선 사용하고, */
+/*   주인이 없던 사이 쌓인 원격 free 를 먼저 병합                  */
+/* ------------------------------------------------------ */
+static __thread int my_arena_owned;        /* 배정받은 아레나를 전담하는지 */
+
+static void arena_attach(void)
+{
+    int i;
+
+    pthread_mutex_lock(&arena_pool_lock);
+    for (i = 0; i < MAX_ARENAS && arenas[i].owned; i++)
+        ;
+    if (i < MAX_ARENAS) {
+        arenas[i].owned = 1;
+        my_arena_owned = 1;
+    } else {                                   /* 스레드가 아레나보다 많음: 락으로 공유 */
+        i = arena_next;
+        arena_next = (arena_next + 1) % MAX_ARENAS;
+        my_arena_owned = 0;
+    }
+    my_arena = &arenas[i];
+    pthread_mutex_unlock(&arena_pool_lock);
+    thread_register();
+    ARENA_LOCK(my_arena);
+    drain_remote(my_arena);
+    ARENA_UNLOCK(my_arena);
+}
+
+/* ------------------------------------------------------ */
+/* arena_detach - 종료하는 스레드의 아레나를 풀에 돌려줌          */
+/*   원격 free 를 병합해 두고 넘기며, 블록은 그대로 남아 다음에     */
+/*   배정받는 스레드가 이어서 씀                                   */
+/* ------------------------------------------------------ */
+static void arena_detach(void)
+{
+    if (my_arena != NULL) {
+        ARENA_LOCK(my_arena);
+        drain_remote(my_arena);
+        ARENA_UNLOCK(my_arena);
+    }
+    pthread_mutex_lock(&arena_pool_lock);
+    if (my_arena != NULL && my_arena_owned)
+        my_arena->owned = 0;
+    my_arena = NULL;
+    pthread_mutex_unlock(&arena_pool_lock);
+}
+
+/* ------------------------------------------------------ */
+/* arena_sbrk - 아레나 a에 size 바이트 영역 할당 (락 보유 상태)   */
+/*   *contiguous: 직전 영역 바로 뒤라서 이어 쓸 수 있으면 1       */
+/* ------------------------------------------------------ */
+static void *arena_sbrk(arena_t *a, size_t size, int *contiguous)
+{
+    char *p;
+    size_t i, first;
+    unsigned char id = (unsigned char)(a - arenas + 1);
+
+    if ((long)(p = mem_sbrk(size)) == -1)
+        return NULL;
+    *contiguous = (p == a->end);
+    a->end = p + size;
+    first = (p - (char *)mem_heap_lo()) / ARENA_GRAIN;
+    for (i = 0; i < size / ARENA_GRAIN; i++)
+        arena_map[first + i] = id;
+    return p;
+}
+
+/* ------------------------------------------------------ */
+/* remote_free - 다른 아레나의 블록을 소유자의 원격 스택에 push   */
+/*   (lock-free, 여러 스레드가 동시에 호출 가능)                  */
+/* ------------------------------------------------------ */
+static void remote_free(arena_t *owner, void *bp)
+{
+    void *head = __atomic_load_n(&owner->remote, __ATOMIC_RELAXED);
+
+    do {
+        REMOTE_NEXT(bp) = head;
+    } while (!__atomic_compare_exchange_n(&owner->remote, &head, bp, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/* ------------------------------------------------------ */
+/* drain_remote - 원격 스택을 통째로 떼어와 각 블록을 병합       */
+/*   스택 전체를 exchange 로 떼므로 ABA 문제 없음. 아레나 락을    */
+/*   잡은 스레드면 누구든 호출 가능. 병합한 블록이 있으면 1       */
+/* ------------------------------------------------------ */
+static int drain_remote(arena_t *a)
+{
+    void *bp, *next;
+
+    if (__atomic_load_n(&a->remote, __ATOMIC_RELAXED) == NULL)
+        return 0;
+    bp = __atomic_exchange_n(&a->remote, NULL, __ATOMIC_ACQUIRE);
+    for (; bp != NULL; bp = next) {
+        next = REMOTE_NEXT(bp);
+        heap_free(a, bp);
+    }
+    return 1;
+}
+#endif /* MM_ARENAS */
+
+/* ------------------------------------------------------ */
+/* mm_malloc - 크기 size의 블록 요청 처리 (malloc_block 참고)    */
+/* ------------------------------------------------------ */
+void *mm_malloc(size_t size)
+{
+    return PROF_ALLOC(CHECK_ALLOC(malloc_block(size)), size);
+}
+
+/* ------------------------------------------------------ */
+/* malloc_block - mm_malloc 의 본체                            */
+/*   1) 큰 요청은 전용 매핑 → 2) 작은 요청은 슬랩               */
+/*   → 3) 요청 정규화(asize) → 4) 스레드 캐시 → 5) 아레나        */
+/* ------------------------------------------------------ */
+static inline void *malloc_block(size_t size)
+{
+    arena_t *a;
+    void *bp;
+
+    if (size == 0) return NULL;                    /* 0바이트 요청은 NULL 반환(관례) */
+    if (size > MAX_REQUEST) return NULL;           /* 크기 계산이 넘침 */
+
+#if MMAP_THRESHOLD
+    if (size >= MMAP_THRESHOLD)                    /* 힙을 키우지 않도록 따로 매핑 */
+        return map_malloc(size);
+#endif
+
+#if SLAB_MAX_SIZE
+    if (size <= SLAB_MAX_SIZE) {                   /* 작은 객체: 슬랩 (스레드 캐시 안 씀) */
+        a = thread_arena();
+        ARENA_LOCK(a);
+#if MM_ARENAS
+        drain_remote(a);
+#endif
+        bp = slab_malloc(a, size);
+        ARENA_UNLOCK(a);
+        return bp;
+    }
+#endif
+
+    size_t asize = adjust_size(size);              /* 헤더/풋터 포함·정렬된 크기 */
+
+#if MM_THREADS
+    if ((bp = tcache_get(asize)) != NULL)          /* 락 없이 처리 */
+        return bp;
+#endif
+    a = thread_arena();
+    ARENA_LOCK(a);
+#if MM_ARENAS
+    drain_remote(a);                               /* 다른 스레드가 돌려준 블록 먼저 병합 */
+#endif
+    bp = heap_malloc(a, asize);
+#if MM_ARENAS
+    if (bp == NULL && drain_remote(a))             /* 그 사이 돌아온 블록으로 재시도 */
+        bp = heap_malloc(a, asize);
+#endif
+#if MM_THREADS
+    if (bp != NULL)
+        tcache_refill(a, asize);                   /* 같은 락으로 다음 요청분을 미리 확보 */
+#endif
+    ARENA_UNLOCK(a);
+    return bp;
+}
+
+/* ------------------------------------------------------ */
+/* mm_free - 블록 해제: 캐시에 넣거나, 소유 아레나에서 즉시 병합 */
+/*   MM_ARENAS: 남의 아레나 블록이면 소유자 원격 큐로 보냄       */
+/* ------------------------------------------------------ */
+void mm_free(void *bp)
+{
+    if (bp == NULL) return;                        /* NULL free 방어 */
+    (void)CHECK_ALLOC(bp);                         /* 이중 free·잘못된 포인터 */
+    PROF_FREE(bp);
+    free_block(bp, 1);
+}
+
+/* ------------------------------------------------------ */
+/* mm_free_sized - 크기를 아는 호출자의 free (C++14 sized delete)  */
+/*   size 는 mm_malloc 등에 요청한 크기. SLAB_MAX_SIZE 보다 크면    */
+/*   슬랩 칸일 수 없으므로(슬랩 칸은 realloc 해도 같은 클래스에만   */
+/*   머묾) 슬랩 조회를 건너뜀. 이득은 그것뿐: 작은 size 는 슬랩 칸  */
+/*   이라는 보장이 아님(제자리에서 줄인 힙 블록) - 나머지는 mm_free */
+/*   와 같음. 검사 모드에선 size 가 맞는지도 봄                     */
+/* ------------------------------------------------------ */
+void mm_free_sized(void *bp, size_t size)
+{
+    if (bp == NULL) return;
+    (void)CHECK_ALLOC(bp);
+#if MM_CHECK
+    if (check_level)
+        check_sized(bp, size);
+#endif
+    PROF_FREE(bp);
+    free_block(bp, size <= SLAB_MAX_SIZE);
+}
+
+/* ------------------------------------------------------ */
+/* free_block - 매핑, 스레드 캐시, 남의 아레나, 내 아레나 순으로   */
+/*   블록 반환. slab 이 0 이면 슬랩 칸이 아님을 호출자가 보장      */
+/* ------------------------------------------------------ */
+static inline void free_block(void *bp, int slab)
+{
+    arena_t *a;
+
+#if MMAP_THRESHOLD
+    if (IS_MAPPED(bp)) {                           /* 헤더가 없으므로 가장 먼저 판별 */
+        map_free(bp);
+        return;
+    }
+#endif
+#if MM_THREADS
+    if (tcache_put(bp, slab))
+        return;
+#endif
+    a = OWNER(bp);
+#if MM_ARENAS
+    if (a != thread_arena()) {
+        remote_free(a, bp);
+        return;
+    }
+#endif
+    ARENA_LOCK(a);
+#if MM_ARENAS
+    drain_remote(a);                               /* 할당이 뜸한 소유자도 비워 둠 */
+#endif
+    if (slab)
+        heap_free(a, bp);
+    else
+        block_free(a, bp);
+    ARENA_UNLOCK(a);
+}
+
+/* ------------------------------------------------------ */
+/* mm_aligned_alloc - payload 가 align(2 의 거듭제곱) 배수 주소인   */
+/*   size 바이트 블록. ALIGNMENT 이하면 mm_malloc 과 같음           */
+/*   힙에서 넉넉히 받아 정렬 지점 앞 조각은 free 블록으로 돌려주고  */
+/*   뒷부분은 잘라냄(heap_memalign). 크기와 무관하게 힙 블록이라      */
+/*   슬랩·매핑을 거치지 않으며, mm_free/mm_realloc 으로 다룰 수 있음 */
+/* ------------------------------------------------------ */
+void *mm_aligned_alloc(size_t align, size_t size)
+{
+    arena_t *a;
+    void *bp;
+
+    if (size == 0 || align == 0 || (align & (align - 1)) != 0)
+        return NULL;
+    if (align > MAX_REQUEST || size > MAX_REQUEST - align)
+        return NULL;                               /* asize + align 이 넘침 */
+    if (align <= ALIGNMENT)
+        return mm_malloc(size);
+    a = thread_arena();
+    ARENA_LOCK(a);
+#if MM_ARENAS
+    drain_remote(a);
+#endif
+    bp = heap_memalign(a, align, adjust_size(size));
+    ARENA_UNLOCK(a);
+    return PROF_ALLOC(CHECK_ALLOC(bp), size);
+}
+
+/* ------------------------------------------------------ */
+/* mm_realloc - 블록 크기 변경 (heap_realloc 참고)            */
+/*   블록의 소유 아레나에서 처리(남의 아레나면 그 락을 잡음)    */
+/*   매핑 블록은 map_realloc 이 처리                             */
+/* ------------------------------------------------------ */
+void *mm_realloc(void *ptr, size_t size)
+{
+    arena_t *a;
+    void *newptr;
+
+    if (ptr == NULL) return mm_malloc(size);       /* realloc(NULL, s) == malloc(s) */
+    if (size == 0)   { mm_free(ptr); return NULL;} /* realloc(p, 0) == free(p) */
+    if (size > MAX_REQUEST) return NULL;           /* 채울 수 없음: ptr 은 그대로 */
+
+    (void)CHECK_ALLOC(ptr);
+#if MMAP_THRESHOLD
+    if (IS_MAPPED(ptr)) {
+        newptr = map_realloc(ptr, size);           /* 옮겼으면 옛 샘플은 거기서 지움 */
+    } else
+#endif
+    {
+        a = OWNER(ptr);
+        ARENA_LOCK(a);
+        newptr = heap_realloc(a, ptr, size);
+        if (newptr != NULL && newptr != ptr)       /* 옮김: 옛 주소를 다른 스레드가 */
+            PROF_FREE(ptr);                        /* 받기 전, 락 안에서 샘플을 지움 */
+        ARENA_UNLOCK(a);
+    }
+    if (newptr == NULL)                            /* 실패: ptr 과 그 샘플은 그대로 */
+        return NULL;
+    if (newptr == ptr) {                           /* 제자리: 샘플 크기만 바꿈 */
+        PROF_RESIZE(ptr, size);
+        return newptr;
+    }
+    return PROF_ALLOC(CHECK_ALLOC(newptr), size);  /* 프로파일엔 free + malloc 으로 */
+}
+
+/* ====== 일괄 할당/해제 ====== */
+
+/* ------------------------------------------------------ */
+/* carve_blocks - free 블록 bp 앞에서부터 asize 블록을 최대 n 개  */
+/*   연달아 잘라 ptrs 에 담음. 헤더(/풋터)를 한 번 훑으며 쓰고,   */
+/*   남는 뒷부분은 MINBLOCK 이상이면 free 로, 아니면 마지막 블록에 */
+/*   붙임. 잘라낸 블록 수 리턴                                   */
+/* ------------------------------------------------------ */
+static size_t carve_blocks(arena_t *a, char *bp, size_t asize, void **ptrs, size_t n)
+{
+    size_t csize = GET_SIZE(HDRP(bp));
+    size_t k = MIN(n, csize / asize), rest = csize - k * asize, size, i;
+
+    remove_free_block(a, bp);
+    for (i = 0; i < k; i++, bp += size) {
+        /* 자투리가 MINBLOCK 미만이면 마지막 블록이 흡수(내부 단편화) */
+        size = (i == k - 1 && rest < MINBLOCK) ? asize + rest : asize;
+        if (i == 0)
+            SET_HDR(bp, size, 1);                  /* 첫 블록은 앞 블록 비트를 그대로 */
+        else
+            PUT(HDRP(bp), PACK(size, 1) | PREV_ALLOC);
+        SET_ALLOC_FTR(bp, size);
+        ptrs[i] = bp;
+    }
+    if (rest >= MINBLOCK) {                        /* 남은 뒷부분은 free 블록으로 */
+        PUT(HDRP(bp), PACK(rest, 0) | PREV_ALLOC);
+        PUT(FTRP(bp), PACK(rest, 0));
+        insert_free_block(a, bp);
+        CHECK_FREE(bp);
+    } else {
+        SET_PREV_ALLOC(HDRP(bp));                  /* bp 는 이제 뒤 블록: 앞이 할당됨 */
+    }
+    return k;
+}
+
+/* ------------------------------------------------------ */
+/* heap_malloc_batch - asize 블록 n 개를 아레나 a 에서 할당       */
+/*   남은 개수를 한꺼번에 담을 free 블록을 찾아 잘라 쓰고, 없으면  */
+/*   하나라도 들어가는 블록, 그것도 없으면 한 번에 필요한 만큼 확장 */
+/*   DEFER_COALESCE: 같은 크기 quick 블록을 먼저 씀. 할당한 수 리턴 */
+/* ------------------------------------------------------ */
+static size_t heap_malloc_batch(arena_t *a, size_t asize, void **ptrs, size_t n)
+{
+    size_t got = 0, want;
+    char *bp;
+
+#if DEFER_COALESCE
+    if (asize <= QUICK_MAX_SIZE) {
+        while (got < n && (bp = a->quick[QUICK_INDEX(asize)]) != NULL) {
+            a->quick[QUICK_INDEX(asize)] = QUICK_NEXT(bp);
+            a->quick_counts[QUICK_INDEX(asize)]--;
+            ptrs[got++] = bp;
+        }
+    }
+#endif
+    while (got < n) {
+        want = asize * MIN(n - got, MAX_HEAP / asize);
+        if ((bp = find_fit(a, want)) == NULL && (bp = find_fit(a, asize)) == NULL) {
+#if DEFER_COALESCE
+            if (quick_sweep(a))
+                continue;                          /* 병합된 블록으로 다시 탐색 */
+#endif
+            if ((bp = extend_heap(a, MAX(want, CHUNKSIZE) / WSIZE)) == NULL &&
+                (want == asize || (bp = extend_heap(a, MAX(asize, CHUNKSIZE) / WSIZE)) == NULL))
+                break;
+        }
+        got += carve_blocks(a, bp, asize, ptrs + got, n - got);
+    }
+    return got;
+}
+
+/* ------------------------------------------------------ */
+/* free_run - 주소 순으로 정렬된 ptrs[i..] 중 ptrs[i] 부터 힙에서  */
+/*   바로 이어지는 블록들을 한 블록으로 묶어 한 번만 병합        */
+/*   (락 보유 상태). 다음에 볼 인덱스 리턴                       */
+/* ------------------------------------------------------ */
+static size_t free_run(arena_t *a, void **ptrs, size_t i, size_t n)
+{
+    char *bp = ptrs[i], *end = NEXT_BLKP(bp);
+    size_t j;
+
+    for (j = i + 1; j < n && ptrs[j] == end; j++)
+        end = NEXT_BLKP(ptrs[j]);
+    SET_HDR(bp, (size_t)(end - bp), 1);            /* 이어진 블록 전체를 한 블록으로 */
+    release_block(a, bp);
+    return j;
+}
+
+/* ------------------------------------------------------ */
+/* mm_malloc_batch - 크기 size 블록 n 개를 한 번에 할당해 ptrs 에 */
+/*   담음. 락을 한 번만 잡고, 힙 블록은 free 블록 하나에서 이어서 */
+/*   잘라냄(carve_blocks). 할당한 수 리턴(모자라면 앞쪽만 채움)   */
+/* ------------------------------------------------------ */
+size_t mm_malloc_batch(size_t size, void **ptrs, size_t n)
+{
+    arena_t *a;
+    size_t got = 0, i;
+
+    if (size == 0 || n == 0 || size > MAX_REQUEST)
+        return 0;
+#if MMAP_THRESHOLD
+    if (size >= MMAP_THRESHOLD) {                  /* 매핑 블록은 하나씩 */
+        for (; got < n && (ptrs[got] = map_malloc(size)) != NULL; got++)
+            (void)PROF_ALLOC(CHECK_ALLOC(ptrs[got]), size);
+        return got;
+    }
+#endif
+    a = thread_arena();
+    ARENA_LOCK(a);
+#if MM_ARENAS
+    drain_remote(a);
+#endif
+#if SLAB_MAX_SIZE
+    if (size <= SLAB_MAX_SIZE) {
+        for (; got < n && (ptrs[got] = slab_malloc(a, size)) != NULL; got++)
+            ;
+    } else
+#endif
+        got = heap_malloc_batch(a, adjust_size(size), ptrs, n);
+    ARENA_UNLOCK(a);
+    for (i = 0; i < got; i++)
+        (void)PROF_ALLOC(CHECK_ALLOC(ptrs[i]), size);
+    return got;
+}
+
+/* 포인터 주소 비교 (qsort 용) */
+static int ptr_cmp(const void *x, const void *y)
+{
+    uintptr_t p = (uintptr_t)*(void *const *)x, q = (uintptr_t)*(void *const *)y;
+
+    return (p > q) - (p < q);
+}
+
+/* ------------------------------------------------------ */
+/* mm_free_batch - ptrs 의 블록 n 개를 한 번에 해제 (NULL 은 건너뜀) */
+/*   병합과 무관한 블록(매핑, 슬랩 칸, 남의 아레나)은 바로 보내고   */
+/*   힙 블록만 ptrs 앞쪽에 모아 주소 순으로 정렬(호출자의 배열을    */
+/*   덮어씀)한 뒤, 이어진 블록들은 한 번에 병합. 락은 한 번만 잡음  */
+/*   스레드 캐시와 quick 리스트는 거치지 않음                       */
+/* ------------------------------------------------------ */
+void mm_free_batch(void **ptrs, size_t n)
+{
+    arena_t *a = thread_arena();
+    char *bp;
+    size_t i, m = 0;
+
+    ARENA_LOCK(a);
+    for (i = 0; i < n; i++) {
+        if ((bp = ptrs[i]) == NULL)
+            continue;
+        (void)CHECK_ALLOC(bp);
+        PROF_FREE(bp);
+#if MMAP_THRESHOLD
+        if (IS_MAPPED(bp)) {
+            map_free(bp);
+            continue;
+        }
+#endif
+#if MM_ARENAS
+        if (OWNER(bp) != a) {
+            remote_free(OWNER(bp), bp);
+            continue;
+        }
+#endif
+#if SLAB_MAX_SIZE
+        if (slab_run_of(bp) != NULL) {
+            slab_free(a, bp);
+            continue;
+        }
+#endif
+        ptrs[m++] = bp;
+    }
+    for (i = 1; i < m && (char *)ptrs[i - 1] < (char *)ptrs[i]; i++)
+        ;
+    if (i < m)                                     /* 이미 주소 순이면 정렬 생략 */
+        qsort(ptrs, m, sizeof(void *), ptr_cmp);
+    for (i = 0; i < m; )
+        i = free_run(a, ptrs, i, m);
+    ARENA_UNLOCK(a);
+}
+
+/* ------------------------------------------------------ */
+/* mm_trim - 각 아레나의 힙 끝 free 공간을 pad 만 남기고 반환    */
+/*   반환한 메모리가 있으면 1, 없으면 0 (malloc_trim 과 같은 뜻) */
+/* ------------------------------------------------------ */
+int mm_trim(size_t pad)
+{
+    size_t released = 0;
+    int i;
+
+    for (i = 0; i < NUM_ARENAS; i++) {
+        ARENA_LOCK(ARENA(i));
+#if DEFER_COALESCE
+        quick_sweep(ARENA(i));                     /* 힙 끝에 묶인 quick 블록부터 풀기 */
+#endif
+        released += heap_trim(ARENA(i), pad);
+        ARENA_UNLOCK(ARENA(i));
+    }
+    return released > 0;
+}
+
+/* ====== 힙 일관성 검사 ====== */
+
+/* ------------------------------------------------------ */
+/* check_fail - 실패 수를 세고 처음 몇 개만 stderr 에 출력     */
+/* ------------------------------------------------------ */
+static void check_fail(void *bp, const char *msg)
+{
+    if (__atomic_fetch_add(&check_failed, 1, __ATOMIC_RELAXED) < CHECK_MAX_REPORTS)
+        fprintf(stderr, "mm_check: block %p: %s\n", bp, msg);
+}
+
+#if MM_CHECK
+/* ------------------------------------------------------ */
+/* check_alloc - 요청이 돌려주거나 받은 할당 블록 bp 하나를 검사 */
+/*   정렬·힙 범위, 할당 비트, 크기, 헤더/풋터 일치, 뒤 블록의    */
+/*   PREV_ALLOC 비트 (슬랩 칸은 칸 경계·비트맵, 매핑은 길이)     */
+/*   CHECK_ALLOC 안에서 쓰도록 bp 를 그대로 리턴                  */
+/* ------------------------------------------------------ */
+static void *check_alloc(void *bp)
+{
+    size_t size;
+
+    if (bp == NULL)
+        return bp;
+#if MMAP_THRESHOLD
+    if (IS_MAPPED(bp)) {
+        if (((uintptr_t)MAP_BASE(bp) & (map_page - 1)) != 0 ||
+            MAP_LEN(bp) == 0 || (MAP_LEN(bp) & (map_page - 1)) != 0)
+            check_fail(bp, "mapped block is not a whole number of pages");
+        return bp;
+    }
+#endif
+    if ((uintptr_t)bp % ALIGNMENT != 0 || !IN_HEAP(HDRP(bp))) {
+        check_fail(bp, "misaligned or outside the heap");
+        return bp;
+    }
+#if SLAB_MAX_SIZE
+    slab_run_t *run = slab_run_of(bp);
+    if (run != NULL) {                             /* 헤더 없는 슬랩 칸 */
+        size_t off = (char *)bp - (char *)run - SLAB_HDR, i = off / run->osize;
+
+        if ((char *)bp < (char *)run + SLAB_HDR || off % run->osize != 0 || i >= run->nobj)
+            check_fail(bp, "not on a slab slot boundary");
+        else if ((run->freemap[i / 64] >> (i % 64)) & 1)
+            check_fail(bp, "slab slot is free (double free?)");
+        return bp;
+    }
+#endif
+    size = GET_SIZE(HDRP(bp));
+    if (!GET_ALLOC(HDRP(bp)))
+        check_fail(bp, "header says free (double free?)");
+    else if (size < MINBLOCK || size % ALIGNMENT != 0 || !IN_HEAP((char *)bp + size - WSIZE))
+        check_fail(bp, "bad block size in header");
+#if !FOOTERLESS_ALLOC
+    else if (GET(FTRP(bp)) != PACK(size, 1))
+        check_fail(bp, "header and footer disagree");
+#endif
+    else if (!GET_PREV_ALLOC(HDRP(NEXT_BLKP(bp))))
+        check_fail(bp, "next block's PREV_ALLOC bit is clear");
+    return bp;
+}
+
+/* ------------------------------------------------------ */
+/* check_free - 병합·분할을 마치고 리스트에 넣은 free 블록 검사  */
+/*   헤더/풋터 일치, 양옆이 할당 블록(병합 누락 없음), 뒤 블록의 */
+/*   PREV_ALLOC 비트가 꺼져 있는지                               */
+/* ------------------------------------------------------ */
+static void check_free(void *bp)
+{
+    size_t size = GET_SIZE(HDRP(bp));
+
+    if ((uintptr_t)bp % ALIGNMENT != 0 || size < MINBLOCK || size % ALIGNMENT != 0)
+        check_fail(bp, "misaligned or bad size for a free block");
+    else if (GET_ALLOC(HDRP(bp)) || GET(FTRP(bp)) != PACK(size, 0))
+        check_fail(bp, "free block's header and footer disagree");
+    else if (!GET_PREV_ALLOC(HDRP(bp)) || !GET_ALLOC(HDRP(NEXT_BLKP(bp))))
+        check_fail(bp, "free block has a free neighbour (missed coalesce)");
+    else if (GET_PREV_ALLOC(HDRP(NEXT_BLKP(bp))))
+        check_fail(bp, "next block's PREV_ALLOC bit is set");
+}
+
+/* ------------------------------------------------------ */
+/* check_sized - mm_free_sized 에 넘어온 size 가 블록 bp 의       */
+/*   payload 에 들어가는지 (크기를 잘못 넘기면 슬랩 조회를 건너뛰어 */
+/*   슬랩 칸을 헤더 있는 블록으로 반환하게 됨)                     */
+/* ------------------------------------------------------ */
+static void check_sized(void *bp, size_t size)
+{
+    size_t room;
+
+    if (size > MAX_REQUEST) {
+        check_fail(bp, "mm_free_sized: size is larger than any block");
+        return;
+    }
+#if MMAP_THRESHOLD
+    if (IS_MAPPED(bp)) {
+        if (size > MAP_LEN(bp) - MAP_HDR)
+            check_fail(bp, "mm_free_sized: size is larger than the mapped block");
+        return;
+    }
+#endif
+#if SLAB_MAX_SIZE
+    slab_run_t *run = slab_run_of(bp);
+    if (run != NULL) {
+        if (size > run->osize)
+            check_fail(bp, "mm_free_sized: size is larger than the slab slot");
+        return;
+    }
+#endif
+    room = GET_SIZE(HDRP(bp)) - OVERHEAD;
+    if (size > room)
+        check_fail(bp, "mm_free_sized: size is larger than the block");
+}
+#endif /* MM_CHECK */
+
+#if TREE_MIN_SIZE
+/* ------------------------------------------------------ */
+/* check_tree - t 를 루트로 하는 트립 검사: 키가 (lo, hi) 안,     */
+/*   우선순위가 부모(prio) 이하, 큰 free 블록만. 노드 수 리턴      */
+/*   규칙을 어긴 노드 아래로는 내려가지 않음(순환 링크 방지)       */
+/* ------------------------------------------------------ */
+static size_t check_tree(char *t, char *lo, char *hi, unsigned int prio)
+{
+    if (t == NULL)
+        return 0;
+    if (!IN_HEAP(t) || GET_ALLOC(HDRP(t)) || GET_SIZE(HDRP(t)) < TREE_MIN_SIZE) {
+        check_fail(t, "tree node is not a large free block");
+        return 1;
+    }
+    if ((lo != NULL && !TREE_LESS(lo, t)) || (hi != NULL && !TREE_LESS(t, hi)) ||
+        tree_prio(t) > prio) {
+        check_fail(t, "tree node out of key or priority order");
+        return 1;
+    }
+    return 1 + check_tree(LEFT(t), lo, t, tree_prio(t))
+             + check_tree(RIGHT(t), t, hi, tree_prio(t));
+}
+#endif
+
+#if SLAB_MAX_SIZE
+/* check_run - run 헤더의 칸 수와 비트맵이 맞는지 검사 */
+static void check_run(slab_run_t *run)
+{
+    unsigned int w, nfree = 0;
+
+    for (w = 0; w < SLAB_MAP_WORDS; w++)
+        nfree += __builtin_popcountll(run->freemap[w]);
+    if (run->osize == 0 || run->osize > SLAB_MAX_SIZE ||
+        run->nobj != (SLAB_PAGE - SLAB_HDR) / run->osize || nfree != run->nfree)
+        check_fail(run, "slab run header disagrees with its free map");
+}
+#endif
+
+/* ------------------------------------------------------ */
+/* check_heap - 힙 전체를 블록 단위로 훑고 모든 리스트를 따라감  */
+/*   블록: 정렬·크기, 헤더/풋터, PREV_ALLOC 비트, 이웃 free 없음, */
+/*   각 영역의 프롤로그/에필로그                                  */
+/*   리스트: 링크 일관성, 크기 클래스, 트립 순서, quick 리스트 수, */
+/*   그리고 리스트+트리의 블록 수 = 힙의 free 블록 수             */
+/*   모든 아레나를 잠근 상태에서 호출                             */
+/* ------------------------------------------------------ */
+static void check_heap(void)
+{
+    char *bp, *prev, *end = (char *)mem_heap_hi() + 1;
+    size_t size, prev_alloc, nfree = 0, nlisted = 0;
+    int i, c;
+
+    for (bp = (char *)mem_heap_lo() + 4 * WSIZE; bp < end; bp += 4 * WSIZE) {
+        /* 영역 시작: [패딩][프롤로그 헤더][프롤로그 풋터][첫 블록 헤더] */
+        if (GET(bp - 3 * WSIZE) != PACK(DSIZE, 1) || GET(bp - 2 * WSIZE) != PACK(DSIZE, 1)) {
+            check_fail(bp - 2 * WSIZE, "bad prologue");
+            return;                                /* 블록 경계를 더 따라갈 수 없음 */
+        }
+        prev_alloc = 1;
+        for (; (size = GET_SIZE(HDRP(bp))) > 0; bp += size) {
+            if ((uintptr_t)bp % ALIGNMENT != 0 || size < MINBLOCK ||
+                size % ALIGNMENT != 0 || bp + size > end) {
+                check_fail(bp, "bad block size or alignment");
+                return;
+            }
+            if (!GET_PREV_ALLOC(HDRP(bp)) != !prev_alloc)
+                check_fail(bp, "PREV_ALLOC bit disagrees with the previous block");
+            if (!GET_ALLOC(HDRP(bp))) {
+                nfree++;
+                if (GET(FTRP(bp)) != PACK(size, 0))
+                    check_fail(bp, "free block's header and footer disagree");
+                if (!prev_alloc)
+                    check_fail(bp, "two adjacent free blocks (missed coalesce)");
+            }
+#if !FOOTERLESS_ALLOC
+            else if (GET(FTRP(bp)) != PACK(size, 1))
+                check_fail(bp, "header and footer disagree");
+#endif
+#if SLAB_MAX_SIZE
+            else if (slab_run_of(bp) == (slab_run_t *)bp)
+                check_run((slab_run_t *)bp);
+#endif
+            prev_alloc = GET_ALLOC(HDRP(bp));
+        }
+        if (!GET_ALLOC(HDRP(bp)) || !GET_PREV_ALLOC(HDRP(bp)) != !prev_alloc)
+            check_fail(bp, "bad epilogue");
+        /* bp 는 에필로그 바로 뒤 = 다음 영역의 시작 */
+    }
+
+    for (i = 0; i < NUM_ARENAS; i++) {
+        arena_t *a = ARENA(i);
+
+        for (c = 0; c < NUM_CLASSES; c++) {
+            for (prev = NULL, bp = a->seg_heads[c]; bp != NULL; prev = bp, bp = SUCC(bp)) {
+                if (++nlisted > nfree || !IN_HEAP(bp) || GET_ALLOC(HDRP(bp))) {
+                    check_fail(bp, "free list entry is not a free heap block (or the list loops)");
+                    return;
+                }
+                size = GET_SIZE(HDRP(bp));
+                if (size_class(size) != c)
+                    check_fail(bp, "free block on the wrong size class list");
+#if TREE_MIN_SIZE
+                if (size >= TREE_MIN_SIZE)
+                    check_fail(bp, "large free block on a list instead of the tree");
+#endif
+                if (PRED(bp) != prev)
+                    check_fail(bp, "pred link does not point back");
+            }
+        }
+#if TREE_MIN_SIZE
+        nlisted += check_tree(a->tree_root, NULL, NULL, ~0u);
+#endif
+#if DEFER_COALESCE
+        for (c = 0; c < QUICK_BINS; c++) {
+            unsigned int n = 0;
+
+            for (bp = a->quick[c]; bp != NULL && n <= a->quick_counts[c]; bp = QUICK_NEXT(bp), n++)
+                if (!IN_HEAP(bp) || !GET_ALLOC(HDRP(bp)) || GET_SIZE(HDRP(bp)) != (size_t)c * ALIGNMENT) {
+                    check_fail(bp, "quick list entry is not a parked block of its size");
+                    break;
+                }
+            if (bp == NULL && n != a->quick_counts[c])
+                check_fail(a->quick[c], "quick list length disagrees with its count");
+        }
+#endif
+#if SLAB_MAX_SIZE
+        for (c = 0; c < SLAB_CLASSES; c++) {
+            slab_run_t *run, *rprev = NULL;
+            size_t n = 0;
+
+            for (run = a->slabs[c]; run != NULL; rprev = run, run = run->next)
+                if (++n > MAX_HEAP / SLAB_PAGE || slab_run_of(run) != run ||
+                    run->osize != (unsigned int)(c + 1) * ALIGNMENT ||
+                    run->nfree == 0 || run->prev != rprev) {
+                    check_fail(run, "bad slab run on its class list");
+                    break;
+                }
+        }
+#endif
+    }
+    if (nlisted != nfree)
+        check_fail(NULL, "free lists and tree miss some of the heap's free blocks");
+}
+
+/* ------------------------------------------------------ */
+/* mm_check - 이후 요청의 검사 수준을 level 로 정하고 (1 이상이면  */
+/*   요청마다 다룬 블록을 O(1) 검사), 2 이상이면 지금 힙 전체 검사 */
+/*   mm_init 이후 실패한 검사가 없으면 1                          */
+/* ------------------------------------------------------ */
+int mm_check(int level)
+{
+    int i;
+
+#if MM_CHECK
+    check_level = level;
+#endif
+    if (level >= 2) {
+        for (i = 0; i < NUM_ARENAS; i++)           /* mm_stats 와 같은 순서로 잠금 */
+            ARENA_LOCK(ARENA(i));
+        check_heap();
+        for (i = NUM_ARENAS - 1; i >= 0; i--)
+            ARENA_UNLOCK(ARENA(i));
+    }
+    return __atomic_load_n(&check_failed, __ATOMIC_RELAXED) == 0;
+}
+
+/* ------------------------------------------------------ */
+/* mm_stats - 힙 전체를 블록 단위로 훑어 통계 수집            */
+/*   각 영역은 [패딩][프롤로그 헤더/풋터][블록 ...][에필로그]   */
+/*   모양이고, 영역이 여럿이면(MM_ARENAS) 주소순으로 붙어 있음  */
+/*   스레드 모드에선 훑는 동안 모든 아레나를 잠금              */
+/* ------------------------------------------------------ */
+void mm_stats(mm_stats_t *st)
+{
+    char *bp, *end;
+    size_t size;
+    int i;
+
+    memset(st, 0, sizeof(*st));
+    for (i = 0; i < NUM_ARENAS; i++)               /* 항상 같은 순서로 잠가 교착 방지 */
+        ARENA_LOCK(ARENA(i));
+
+    end = (char *)mem_heap_hi() + 1;
+    for (bp = (char *)mem_heap_lo() + 4 * WSIZE; bp < end; bp += 4 * WSIZE) {
+        for (; (size = GET_SIZE(HDRP(bp))) > 0; bp += size) {
+            if (GET_ALLOC(HDRP(bp))) {
+                st->live_blocks++;
+                st->live_bytes += size;
+#if SLAB_MAX_SIZE
+                slab_run_t *run = slab_run_of(bp);
+                if (run != NULL && (char *)run == bp) { /* run 페이지 블록 */
+                    st->slab_runs++;
+                    st->slab_free_bytes += (size_t)run->nfree * run->osize;
+                }
+#endif
+            } else {
+                st->free_blocks++;
+                st->free_bytes += size;
+                st->free_by_class[size_class(size)]++;
+                if (size > st->largest_free)
+                    st->largest_free = size;
+            }
+        }
+        /* bp 는 에필로그 바로 뒤 = 다음 영역의 시작 */
+    }
+    for (i = 0; i < NUM_ARENAS; i++) {
+        st->fit_calls += ARENA(i)->fit_calls;
+        st->fit_examined += ARENA(i)->fit_examined;
+#if DEFER_COALESCE
+        int q;
+        for (q = 0; q < QUICK_BINS; q++)
+            st->quick_blocks += ARENA(i)->quick_counts[q];
+#endif
+    }
+
+    for (i = NUM_ARENAS - 1; i >= 0; i--)
+        ARENA_UNLOCK(ARENA(i));
+
+    st->heap_size = mem_heapsize();
+#if MMAP_THRESHOLD
+    st->mapped_blocks = __atomic_load_n(&map_blocks, __ATOMIC_RELAXED);
+    st->mapped_bytes = __atomic_load_n(&map_bytes, __ATOMIC_RELAXED);
+#endif
+    st->frag = st->free_bytes ? 1.0 - (double)st->largest_free / st->free_bytes : 0;
+}
@@ -1,23 +1,114 @@
-#include <stdio.h>
-
-extern int mm_init (void);
-extern void *mm_malloc (size_t size);
-extern void mm_free (void *ptr);
-extern void *mm_realloc(void *ptr, size_t size);
-
-
-/* 
- * Students work in teams of one or two.  Teams enter their team name, 
- * personal names and login IDs in a struct of this
- * type in their bits.c file.
- */
-typedef struct {
-    char *teamname; /* ID1+ID2 or ID1 */
-    char *name1;    /* full name of first member */
-    char *id1;      /* login ID of first member */
-    char *name2;    /* full name of second member (if any) */
-    char *id2;      /* login ID of second member */
-} team_t;
-
-extern team_t team;
-
+#ifndef __MM_H_
+#define __MM_H_
+
+#include <stdio.h>
+
+/*
+ * An allocator compiled with -DMM_PREFIX=<p> names its functions
+ * <p>mm_init, <p>mm_malloc, ..., so that several builds of mm.c (and
+ * other allocators written against this header) can be linked into
+ * one driver side by side (see backend.h).
+ */
+#ifdef MM_PREFIX
+#define MM_CAT_(a, b) a##b
+#define MM_CAT(a, b) MM_CAT_(a, b)
+#define mm_init MM_CAT(MM_PREFIX, mm_init)
+#define mm_malloc MM_CAT(MM_PREFIX, mm_malloc)
+#define mm_free MM_CAT(MM_PREFIX, mm_free)
+#define mm_realloc MM_CAT(MM_PREFIX, mm_realloc)
+#define mm_malloc_batch MM_CAT(MM_PREFIX, mm_malloc_batch)
+#define mm_free_batch MM_CAT(MM_PREFIX, mm_free_batch)
+#define mm_free_sized MM_CAT(MM_PREFIX, mm_free_sized)
+#define mm_aligned_alloc MM_CAT(MM_PREFIX, mm_aligned_alloc)
+#define mm_trim MM_CAT(MM_PREFIX, mm_trim)
+#define mm_check MM_CAT(MM_PREFIX, mm_check)
+#define mm_stats MM_CAT(MM_PREFIX, mm_stats)
+#define team MM_CAT(MM_PREFIX, team)
+#endif
+
+extern int mm_init (void);
+extern void *mm_malloc (size_t size);
+extern void mm_free (void *ptr);
+extern void *mm_realloc(void *ptr, size_t size);
+extern int mm_trim(size_t pad);
+
+/*
+ * Batch requests. mm_malloc_batch allocates n blocks of size bytes
+ * into ptrs and returns how many it could (all of them unless memory
+ * ran out); heap blocks are carved one after another out of a single
+ * free block. mm_free_batch frees the n blocks in ptrs (NULLs are
+ * skipped) and overwrites ptrs: the heap blocks are sorted there by
+ * address, so that neighbours are coalesced once, as one block.
+ */
+extern size_t mm_malloc_batch(size_t size, void **ptrs, size_t n);
+extern void mm_free_batch(void **ptrs, size_t n);
+
+/*
+ * mm_free_sized frees a block whose size the caller knows, like C++14
+ * sized delete: size must be the size last asked for (mm_malloc,
+ * mm_realloc, ...). A size above the slab limit lets it skip the slab
+ * lookup; the rest of the free is that of mm_free, since a small size
+ * doesn't prove a slab slot (a heap block realloc shrank in place keeps
+ * its place). With mm_check(1) or higher it checks that the size fits
+ * the block.
+ * mm_aligned_alloc returns a block whose address is a multiple of
+ * align, a power of two (e.g. 64 for a cache line, or a page), or NULL
+ * if align isn't one or the request can't be met; the block is freed
+ * and reallocated as any other.
+ */
+extern void mm_free_sized(void *ptr, size_t size);
+extern void *mm_aligned_alloc(size_t align, size_t size);
+
+/*
+ * Heap consistency checking. mm_check(level) sets how much checking
+ * the allocator does from now on and returns nonzero if no check has
+ * failed since mm_init (what failed is printed to stderr):
+ *   0  none: the requests run unchecked
+ *   1  O(1) checks of each block a request hands out, frees or coalesces
+ *   2  as 1, and a full walk of the heap and free lists now
+ */
+extern int mm_check(int level);
+
+/*
+ * Heap statistics, filled in by mm_stats(). Blocks parked in a
+ * per-thread cache (MM_THREADS) still count as allocated.
+ */
+#define MM_NUM_CLASSES 20   /* segregated free list size classes */
+
+typedef struct {
+    size_t heap_size;       /* bytes obtained from mem_sbrk */
+    size_t live_blocks;     /* allocated blocks */
+    size_t live_bytes;      /* their total size, headers included */
+    size_t free_blocks;     /* free blocks */
+    size_t free_bytes;      /* their total size */
+    size_t largest_free;    /* size of the largest free block */
+    double frag;            /* external fragmentation: 1 - largest_free / free_bytes */
+    size_t free_by_class[MM_NUM_CLASSES]; /* free blocks per size class */
+    size_t slab_runs;       /* slab pages (counted in live_blocks) */
+    size_t slab_free_bytes; /* free slots inside them (counted in live_bytes) */
+    size_t mapped_blocks;   /* blocks in their own mapping (not in the heap) */
+    size_t mapped_bytes;    /* total length of those mappings */
+    size_t quick_blocks;    /* freed blocks waiting on quick lists (counted in live_blocks) */
+    unsigned long fit_calls;    /* find_fit calls since mm_init */
+    unsigned long fit_examined; /* free blocks they examined */
+} mm_stats_t;
+
+extern void mm_stats(mm_stats_t *st);
+
+
+/* 
+ * Students work in teams of one or two.  Teams enter their team name, 
+ * personal names and login IDs in a struct of this
+ * type in their bits.c file.
+ */
+typedef struct {
+    char *teamname; /* ID1+ID2 or ID1 */
+    char *name1;    /* full name of first member */
+    char *id1;      /* login ID of first member */
+    char *name2;    /* full name of second member (if any) */
+    char *id2;      /* login ID of second member */
+} team_t;
+
+extern team_t team;
+
+#endif /* __MM_H_ */
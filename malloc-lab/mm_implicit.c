@@ -0,0 +1,265 @@
+/*
+ * mm_implicit.c - Implicit free list, next-fit allocator
+ *
+ * 개요(High-level):
+ *   - 교과서(CS:APP 9.9) 그대로의 묵시적 가용 리스트 할당기로, mm.c 와 비교하는
+ *     기준선(backend "implicit", backend.h)입니다.
+ *   - 각 블록은 [Header | Payload | Footer] 이며 헤더/풋터는 (블록 크기 | 할당 비트) 한 워드입니다.
+ *     가용 블록을 따로 모으지 않고, 힙 전체를 블록 크기로 건너뛰며 훑어 free 블록을 찾습니다.
+ *   - 탐색은 next-fit: 지난번 탐색이 끝난 곳(rover)부터 시작해 힙 끝에서 처음으로 돌아옵니다.
+ *   - free 시 경계 태그로 앞뒤 free 블록과 즉시 병합합니다.
+ *   - realloc 은 축소면 제자리, 뒤 블록이 free 거나 힙 끝이면 흡수/확장, 아니면 새로 할당 후 복사합니다.
+ *   - 스레드 안전하지 않고, mm_check 는 없습니다(mm_stats 는 힙을 훑어 셉니다).
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "config.h"
+#define MM_PREFIX implicit_
+#include "mm.h"
+#include "memlib.h"
+
+team_t team = {
+    "implicit", "next fit baseline", "", "", ""
+};
+
+/* ====== 상수/매크로 정의 ====== */
+
+#if MM_64BIT
+typedef size_t word_t;            /* 헤더/풋터 한 워드의 타입 */
+#else
+typedef unsigned int word_t;
+#endif
+#define WSIZE       (ALIGNMENT / 2)   /* 헤더/풋터 크기 */
+#define DSIZE       ALIGNMENT         /* 정렬 단위 = 헤더 + 풋터 */
+#define CHUNKSIZE   (1 << 12)         /* 힙 확장 시 기본 요청 크기 */
+#define MINBLOCK    (2 * DSIZE)       /* 헤더 + 풋터 + 최소 payload */
+
+#define MAX(x, y)       ((x) > (y) ? (x) : (y))
+#define PACK(size, a)   ((size) | (a))
+
+#define GET(p)          (*(word_t *)(p))
+#define PUT(p, val)     (*(word_t *)(p) = (word_t)(val))
+
+#define GET_SIZE(p)     ((size_t)(GET(p) & ~(word_t)(DSIZE - 1)))
+#define GET_ALLOC(p)    (GET(p) & 0x1)
+
+#define HDRP(bp)        ((char *)(bp) - WSIZE)
+#define FTRP(bp)        ((char *)(bp) + GET_SIZE(HDRP(bp)) - DSIZE)
+
+#define NEXT_BLKP(bp)   ((char *)(bp) + GET_SIZE(HDRP(bp)))
+#define PREV_BLKP(bp)   ((char *)(bp) - GET_SIZE((char *)(bp) - DSIZE))
+
+/* 요청 크기 -> 블록 크기(헤더/풋터 포함, 정렬) */
+#define ASIZE(size)     (((size) + DSIZE + (DSIZE - 1)) & ~(size_t)(DSIZE - 1))
+
+/* ====== 전역 상태 ====== */
+
+static char *heap_listp;          /* 프롤로그 블록의 payload */
+static char *rover;               /* next-fit 탐색을 시작할 블록 */
+
+/* ---------------------------------------------------------------------- */
+/* coalesce - 경계 태그로 앞뒤 free 블록과 병합                           */
+/*   rover 가 흡수된 블록 안을 가리키면 병합된 블록 시작으로 옮깁니다.      */
+/* ---------------------------------------------------------------------- */
+static void *coalesce(void *bp)
+{
+    size_t prev_alloc = GET_ALLOC(FTRP(PREV_BLKP(bp)));
+    size_t next_alloc = GET_ALLOC(HDRP(NEXT_BLKP(bp)));
+    size_t size = GET_SIZE(HDRP(bp));
+
+    if (!next_alloc) {
+        size += GET_SIZE(HDRP(NEXT_BLKP(bp)));
+        PUT(HDRP(bp), PACK(size, 0));
+        PUT(FTRP(bp), PACK(size, 0));
+    }
+    if (!prev_alloc) {
+        size += GET_SIZE(HDRP(PREV_BLKP(bp)));
+        bp = PREV_BLKP(bp);
+        PUT(HDRP(bp), PACK(size, 0));
+        PUT(FTRP(bp), PACK(size, 0));
+    }
+    if (rover > (char *)bp && rover < NEXT_BLKP(bp))
+        rover = bp;
+    return bp;
+}
+
+/* ---------------------------------------------------------------------- */
+/* extend_heap - 힙을 size 바이트 늘리고 새 free 블록을 병합해 돌려줌       */
+/* ---------------------------------------------------------------------- */
+static void *extend_heap(size_t size)
+{
+    char *bp;
+
+    if ((bp = mem_sbrk(size)) == (void *)-1)
+        return NULL;
+    PUT(HDRP(bp), PACK(size, 0));             /* 옛 에필로그 자리에 새 블록 헤더 */
+    PUT(FTRP(bp), PACK(size, 0));
+    PUT(HDRP(NEXT_BLKP(bp)), PACK(0, 1));     /* 새 에필로그 */
+    return coalesce(bp);
+}
+
+/* ---------------------------------------------------------------------- */
+/* place - free 블록 bp 앞부분에 asize 를 할당하고 남으면 분할             */
+/* ---------------------------------------------------------------------- */
+static void place(void *bp, size_t asize)
+{
+    size_t csize = GET_SIZE(HDRP(bp));
+
+    if (csize - asize >= MINBLOCK) {
+        PUT(HDRP(bp), PACK(asize, 1));
+        PUT(FTRP(bp), PACK(asize, 1));
+        bp = NEXT_BLKP(bp);
+        PUT(HDRP(bp), PACK(csize - asize, 0));
+        PUT(FTRP(bp), PACK(csize - asize, 0));
+    } else {
+        PUT(HDRP(bp), PACK(csize, 1));
+        PUT(FTRP(bp), PACK(csize, 1));
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+/* find_fit - rover 부터 에필로그까지, 그다음 처음부터 rover 까지 next-fit  */
+/* ---------------------------------------------------------------------- */
+static void *find_fit(size_t asize)
+{
+    char *bp;
+
+    for (bp = rover; GET_SIZE(HDRP(bp)) > 0; bp = NEXT_BLKP(bp))
+        if (!GET_ALLOC(HDRP(bp)) && GET_SIZE(HDRP(bp)) >= asize)
+            return rover = bp;
+    for (bp = heap_listp; bp < rover; bp = NEXT_BLKP(bp))
+        if (!GET_ALLOC(HDRP(bp)) && GET_SIZE(HDRP(bp)) >= asize)
+            return rover = bp;
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+/* mm_init - 패딩, 프롤로그(헤더+풋터), 에필로그를 놓고 첫 청크를 확보     */
+/* ---------------------------------------------------------------------- */
+int mm_init(void)
+{
+    if ((heap_listp = mem_sbrk(4 * WSIZE)) == (void *)-1)
+        return -1;
+    PUT(heap_listp, 0);                            /* 정렬 패딩 */
+    PUT(heap_listp + WSIZE, PACK(DSIZE, 1));       /* 프롤로그 헤더 */
+    PUT(heap_listp + 2 * WSIZE, PACK(DSIZE, 1));   /* 프롤로그 풋터 */
+    PUT(heap_listp + 3 * WSIZE, PACK(0, 1));       /* 에필로그 */
+    heap_listp += 2 * WSIZE;
+    rover = heap_listp;
+    if (extend_heap(CHUNKSIZE) == NULL)
+        return -1;
+    return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+/* mm_malloc - next-fit 으로 찾고, 없으면 힙을 늘려서 배치                 */
+/* ---------------------------------------------------------------------- */
+void *mm_malloc(size_t size)
+{
+    size_t asize;
+    char *bp;
+
+    if (size == 0)
+        return NULL;
+    asize = MAX(ASIZE(size), MINBLOCK);
+    if ((bp = find_fit(asize)) == NULL) {
+        if ((bp = extend_heap(MAX(asize, CHUNKSIZE))) == NULL)
+            return NULL;
+        rover = bp;
+    }
+    place(bp, asize);
+    return bp;
+}
+
+/* ---------------------------------------------------------------------- */
+/* mm_free - 할당 비트를 지우고 즉시 병합                                 */
+/* ---------------------------------------------------------------------- */
+void mm_free(void *bp)
+{
+    size_t size;
+
+    if (bp == NULL)
+        return;
+    size = GET_SIZE(HDRP(bp));
+    PUT(HDRP(bp), PACK(size, 0));
+    PUT(FTRP(bp), PACK(size, 0));
+    coalesce(bp);
+}
+
+/* ---------------------------------------------------------------------- */
+/* mm_realloc - 제자리 축소/흡수/확장을 먼저 시도하고, 안 되면 이동         */
+/* ---------------------------------------------------------------------- */
+void *mm_realloc(void *ptr, size_t size)
+{
+    size_t asize, csize, nsize;
+    char *next, *newp;
+
+    if (ptr == NULL)
+        return mm_malloc(size);
+    if (size == 0) {
+        mm_free(ptr);
+        return NULL;
+    }
+    asize = MAX(ASIZE(size), MINBLOCK);
+    csize = GET_SIZE(HDRP(ptr));
+    if (asize <= csize)                            /* 축소: 그대로 둠 */
+        return ptr;
+
+    next = NEXT_BLKP(ptr);
+    nsize = GET_ALLOC(HDRP(next)) ? 0 : GET_SIZE(HDRP(next));
+    if (GET_SIZE(HDRP(next)) == 0 ||
+        (nsize > 0 && GET_SIZE(HDRP(NEXT_BLKP(next))) == 0 && csize + nsize < asize)) {
+        /* 힙 끝 블록(뒤가 에필로그이거나 free 블록 하나 뒤 에필로그): 모자란 만큼 확장 */
+        if (extend_heap(asize - csize - nsize) == NULL)
+            return NULL;
+        nsize = GET_SIZE(HDRP(next));
+    }
+    if (csize + nsize >= asize) {                  /* 뒤 free 블록 흡수 */
+        if (rover == next)
+            rover = ptr;
+        PUT(HDRP(ptr), PACK(csize + nsize, 0));
+        place(ptr, asize);
+        return ptr;
+    }
+
+    if ((newp = mm_malloc(size)) == NULL)
+        return NULL;
+    memcpy(newp, ptr, csize - DSIZE);
+    mm_free(ptr);
+    return newp;
+}
+
+/* ---------------------------------------------------------------------- */
+/* mm_trim - 힙을 돌려주지 않음                                           */
+/* ---------------------------------------------------------------------- */
+int mm_trim(size_t pad)
+{
+    (void)pad;
+    return 0;
+}
+
+/* ---------------------------------------------------------------------- */
+/* mm_stats - 힙을 한 번 훑어 할당/가용 블록 통계를 채움                   */
+/*   크기 클래스 구분이 없으므로 free_by_class 는 비워 둡니다.             */
+/* ---------------------------------------------------------------------- */
+void mm_stats(mm_stats_t *st)
+{
+    char *bp;
+    size_t size;
+
+    memset(st, 0, sizeof(*st));
+    st->heap_size = mem_heapsize();
+    for (bp = heap_listp; (size = GET_SIZE(HDRP(bp))) > 0; bp = NEXT_BLKP(bp)) {
+        if (GET_ALLOC(HDRP(bp))) {
+            st->live_blocks++;
+            st->live_bytes += size;
+        } else {
+            st->free_blocks++;
+            st->free_bytes += size;
+            st->largest_free = MAX(st->largest_free, size);
+        }
+    }
+    st->frag = st->free_bytes ? 1.0 - (double)st->largest_free / st->free_bytes : 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * perfctr.c - Hardware event counts around a function (see perfctr.h)
+ *
+ * Each counter is opened disabled and is reset, enabled and disabled
+ * around the call with ioctl. Reads come with the time the counter
+ * was enabled and the time it was actually running on the PMU, whose
+ * ratio scales a multiplexed count. Elsewhere than Linux no counter is
+ * available.
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include "perfctr.h"
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/* Cache event config: cache, operation and result */
+#define CACHE_EVENT(c) ((c) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | \
+                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+static const struct {
+    const char *name;
+    uint32_t type;
+    uint64_t config;
+} events[PERF_NUM_EVENTS] = {
+    [PERF_INSTRUCTIONS] = {"instr", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    [PERF_CYCLES] = {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    [PERF_L1D_MISSES] = {"L1d", PERF_TYPE_HW_CACHE, CACHE_EVENT(PERF_COUNT_HW_CACHE_L1D)},
+    [PERF_LLC_MISSES] = {"LLC", PERF_TYPE_HW_CACHE, CACHE_EVENT(PERF_COUNT_HW_CACHE_LL)},
+    [PERF_DTLB_MISSES] = {"dTLB", PERF_TYPE_HW_CACHE, CACHE_EVENT(PERF_COUNT_HW_CACHE_DTLB)},
+    [PERF_BRANCH_MISSES] = {"br-miss", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    [PERF_FAULTS] = {"faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+};
+
+int perf_open(perf_ctrs_t *p)
+{
+    struct perf_event_attr attr;
+    int e, n = 0;
+
+    for (e = 0; e < PERF_NUM_EVENTS; e++) {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[e].type;
+        attr.config = events[e].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        p->fd[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        n += p->fd[e] >= 0;
+    }
+    return n;
+}
+
+void perf_measure(perf_ctrs_t *p, perf_funct f, void *argp, perf_counts_t *c)
+{
+    uint64_t v[3];                  /* count, time enabled, time running */
+    int e;
+
+    for (e = 0; e < PERF_NUM_EVENTS; e++)
+        if (p->fd[e] >= 0) {
+            ioctl(p->fd[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(p->fd[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    f(argp);
+    for (e = 0; e < PERF_NUM_EVENTS; e++)
+        if (p->fd[e] >= 0)
+            ioctl(p->fd[e], PERF_EVENT_IOC_DISABLE, 0);
+
+    c->valid = 1;
+    for (e = 0; e < PERF_NUM_EVENTS; e++) {
+        c->have[e] = p->fd[e] >= 0 && read(p->fd[e], v, sizeof(v)) == sizeof(v) && v[2] > 0;
+        c->count[e] = c->have[e] ? (double)v[0] * ((double)v[1] / v[2]) : 0;
+    }
+}
+
+void perf_close(perf_ctrs_t *p)
+{
+    int e;
+
+    for (e = 0; e < PERF_NUM_EVENTS; e++)
+        if (p->fd[e] >= 0) {
+            close(p->fd[e]);
+            p->fd[e] = -1;
+        }
+}
+
+const char *perf_event_name(int e)
+{
+    return events[e].name;
+}
+
+#else /* !__linux__ */
+
+static const char *names[PERF_NUM_EVENTS] = {
+    "instr", "cycles", "L1d", "LLC", "dTLB", "br-miss", "faults"
+};
+
+int perf_open(perf_ctrs_t *p)
+{
+    int e;
+
+    for (e = 0; e < PERF_NUM_EVENTS; e++)
+        p->fd[e] = -1;
+    return 0;
+}
+
+void perf_measure(perf_ctrs_t *p, perf_funct f, void *argp, perf_counts_t *c)
+{
+    (void)p;
+    f(argp);
+    memset(c, 0, sizeof(*c));
+    c->valid = 1;
+}
+
+void perf_close(perf_ctrs_t *p)
+{
+    (void)p;
+}
+
+const char *perf_event_name(int e)
+{
+    return names[e];
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,52 @@
+/*
+ * perfctr.h - Hardware event counts around a function (perf_event_open)
+ *
+ * Counts, in user space only, the instructions, cycles, L1 data and
+ * last level cache read misses, data TLB read misses, mispredicted
+ * branches and page faults of one call of a function. Each event is
+ * opened on its own, so an event the machine or the kernel's
+ * perf_event_paranoid setting doesn't allow is just missing (virtual
+ * machines often have no hardware counters at all) and the others
+ * are still counted; counts the kernel had to multiplex are scaled up
+ * to the whole call.
+ */
+#ifndef __PERFCTR_H_
+#define __PERFCTR_H_
+
+/* Events */
+enum {
+    PERF_INSTRUCTIONS,
+    PERF_CYCLES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_FAULTS,
+    PERF_NUM_EVENTS
+};
+
+typedef struct {
+    int fd[PERF_NUM_EVENTS];        /* -1: not available */
+} perf_ctrs_t;
+
+typedef struct {
+    int valid;                      /* was the function measured? */
+    int have[PERF_NUM_EVENTS];      /* was the event counted? */
+    double count[PERF_NUM_EVENTS];
+} perf_counts_t;
+
+typedef void (*perf_funct)(void *);
+
+/* Open the counters for the calling thread; returns how many are available */
+int perf_open(perf_ctrs_t *p);
+
+/* Count the events of one call of f(argp) into c */
+void perf_measure(perf_ctrs_t *p, perf_funct f, void *argp, perf_counts_t *c);
+
+/* Close the counters */
+void perf_close(perf_ctrs_t *p);
+
+/* Short name of event e, e.g. for a table heading */
+const char *perf_event_name(int e);
+
+#endif /* __PERFCTR_H_ */
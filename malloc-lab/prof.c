@@ -0,0 +1,511 @@
+/*
+ * prof.c - Sampling heap profiler of mm.c (see prof.h)
+ *
+ * 개요(High-level):
+ *   - 스레드마다 다음 샘플까지 남은 바이트(prof_countdown)를 두고, mm.c 의 훅이 할당마다
+ *     요청 크기만큼 빼다가 0 아래로 내려가면 prof_sample 을 부릅니다. 다음 간격은 평균이
+ *     rate 인 지수분포에서 뽑으므로(포아송 과정) 바이트마다 샘플될 확률이 같습니다.
+ *   - 프로파일이 꺼져 있으면 간격은 PROF_IDLE 이고, prof_sample 은 켜졌는지·시그널로 쓰기를
+ *     요청받았는지만 보고 돌아갑니다. 켜진 뒤 처음 들어온 스레드는 새 간격만 뽑고 샘플하지 않습니다.
+ *   - 샘플은 backtrace 로 호출 스택을 떠서 같은 스택끼리 버킷(bucket_t)에 모으고,
+ *     블록 주소 → 샘플(sample_t) 해시에 살아있는 샘플로 둡니다. mm_free 의 훅은 살아있는
+ *     샘플이 있을 때만 prof_forget 을 부르고, prof_forget 은 해시 칸이 비었으면 락 없이 돌아갑니다.
+ *   - 프로파일러의 메모리는 mm_malloc 이 아니라 mmap 으로 한 번 예약한 풀에서 bump 로 받습니다
+ *     (mm.c 가 malloc 을 대신하는 경우에도 재귀하지 않게). 풀이 차면 샘플을 버리고 셉니다.
+ *   - 프로파일은 gperftools 의 옛 텍스트 형식(heap_v2)으로 쓰며, 값은 샘플 그대로입니다.
+ *     pprof 가 각 샘플을 뽑힐 확률 1 - exp(-size/rate) 로 나눠 추정치로 되돌립니다.
+ *   - 스레드마다 busy 표시를 두어, 프로파일러 안에서 일어난 할당(backtrace 의 첫 호출 등)은
+ *     샘플하지 않고, 그 free 도 (락을 다시 잡지 않도록) 보지 않습니다.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "prof.h"
+
+#if MM_PROFILE
+#include <pthread.h>
+#include <execinfo.h>
+#include <sys/mman.h>
+
+/* ====== 상수/매크로 정의 ====== */
+
+#define STACK_HASH      (1 << 12)           /* 스택 버킷 해시 칸 수 */
+#define LIVE_HASH       (1 << 16)           /* 살아있는 샘플 해시 칸 수 */
+#define POOL_SIZE       ((size_t)16 << 20)  /* 버킷·샘플 풀(예약만, 쓰는 만큼 커밋) */
+#define SKIP            1                   /* 스택에서 버릴 프레임: prof_sample 자신 */
+#define PATH_LEN        256
+
+#define LIVE_INDEX(bp)  ((size_t)(((uint64_t)(uintptr_t)(bp) * 0x9E3779B97F4A7C15ULL) >> 48))
+#define RELAXED         __ATOMIC_RELAXED
+
+typedef struct bucket {
+    struct bucket *next;        /* 같은 해시 칸의 다음 버킷 */
+    uint64_t hash;
+    int depth;
+    size_t live_objs, live_bytes;   /* 살아있는 샘플 */
+    size_t alloc_objs, alloc_bytes; /* mm_prof_start 이후 모든 샘플 */
+    void *pcs[];                /* 호출 스택(안쪽 프레임부터) */
+} bucket_t;
+
+typedef struct sample {
+    struct sample *next;        /* 같은 해시 칸의 다음 샘플(풀에선 free 리스트) */
+    void *bp;
+    size_t size;
+    bucket_t *b;
+} sample_t;
+
+/* ====== 전역 상태 ====== */
+
+__thread long prof_countdown __attribute__((tls_model("initial-exec"))) = PROF_IDLE;
+size_t prof_live;                       /* 살아있는 샘플 수 (mm.c 훅이 락 없이 읽음) */
+
+static __thread unsigned my_epoch __attribute__((tls_model("initial-exec")));
+static __thread uint64_t rng __attribute__((tls_model("initial-exec")));
+static __thread int busy __attribute__((tls_model("initial-exec")));
+
+static pthread_mutex_t prof_lock = PTHREAD_MUTEX_INITIALIZER;
+static size_t prof_rate;                /* 지금 쓰는 샘플 간격, 0 = 꺼짐 */
+static size_t last_rate = PROF_RATE;    /* 프로파일에 적을 간격 */
+static unsigned prof_epoch;             /* mm_prof_start 마다 증가 */
+static size_t samples, dropped;         /* 샘플한 수, 풀이 차서 버린 수 */
+
+static bucket_t *stacks[STACK_HASH];
+static sample_t *live[LIVE_HASH];
+static sample_t *spare;                 /* 다시 쓸 샘플 */
+static char *pool, *pool_cur, *pool_end;
+
+static volatile sig_atomic_t dump_pending;
+static char dump_path[PATH_LEN];
+
+/* ------------------------------------------------------ */
+/* next_interval - 다음 샘플까지의 바이트: 평균 rate 인 지수분포 */
+/* ------------------------------------------------------ */
+static long next_interval(size_t rate)
+{
+    double u, d;
+
+    if (rng == 0)                                  /* 스레드마다 다른 씨앗 */
+        rng = (((uint64_t)(uintptr_t)&rng * 0x9E3779B97F4A7C15ULL) ^ (uint64_t)getpid()) | 1;
+    rng ^= rng << 13;                              /* xorshift64 */
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    u = ((rng >> 11) + 1) * (1.0 / 9007199254740992.0); /* (0, 1] */
+    d = -log(u) * (double)rate;
+    return d < (double)(LONG_MAX / 2) ? (long)d + 1 : LONG_MAX / 2;
+}
+
+/* ------------------------------------------------------ */
+/* pool_alloc - 풀에서 size 바이트 (락 보유 상태), 차면 NULL     */
+/* ------------------------------------------------------ */
+static void *pool_alloc(size_t size)
+{
+    char *p;
+
+    if (pool == NULL) {
+        p = mmap(NULL, POOL_SIZE, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (p == MAP_FAILED)
+            return NULL;
+        pool = pool_cur = p;
+        pool_end = p + POOL_SIZE;
+    }
+    size = (size + 15) & ~(size_t)15;
+    if ((size_t)(pool_end - pool_cur) < size)
+        return NULL;
+    p = pool_cur;
+    pool_cur += size;
+    return p;
+}
+
+/* ------------------------------------------------------ */
+/* find_bucket - 스택 pcs[0..depth) 의 버킷, 없으면 새로 (락 보유) */
+/* ------------------------------------------------------ */
+static bucket_t *find_bucket(void **pcs, int depth)
+{
+    uint64_t h = 14695981039346656037ULL;          /* FNV-1a, 프레임 단위 */
+    bucket_t *b;
+    int i;
+
+    for (i = 0; i < depth; i++)
+        h = (h ^ (uint64_t)(uintptr_t)pcs[i]) * 1099511628211ULL;
+    for (b = stacks[h % STACK_HASH]; b != NULL; b = b->next)
+        if (b->hash == h && b->depth == depth && memcmp(b->pcs, pcs, depth * sizeof(void *)) == 0)
+            return b;
+    if ((b = pool_alloc(sizeof(bucket_t) + depth * sizeof(void *))) == NULL)
+        return NULL;
+    memset(b, 0, sizeof(*b));
+    b->hash = h;
+    b->depth = depth;
+    memcpy(b->pcs, pcs, depth * sizeof(void *));
+    b->next = stacks[h % STACK_HASH];
+    stacks[h % STACK_HASH] = b;
+    return b;
+}
+
+/* ------------------------------------------------------ */
+/* forget - bp 의 살아있는 샘플을 지움 (락 보유 상태)            */
+/*   해시 칸 머리는 prof_forget 이 락 없이 읽으므로 atomic 으로 씀 */
+/* ------------------------------------------------------ */
+static void forget(void *bp)
+{
+    sample_t **pp = &live[LIVE_INDEX(bp)], *s;
+
+    for (; (s = *pp) != NULL; pp = &s->next)
+        if (s->bp == bp) {
+            __atomic_store_n(pp, s->next, RELAXED);
+            s->b->live_objs--;
+            s->b->live_bytes -= s->size;
+            __atomic_store_n(&prof_live, prof_live - 1, RELAXED);
+            s->next = spare;
+            spare = s;
+            return;
+        }
+}
+
+/* ------------------------------------------------------ */
+/* prof_sample - 샘플 간격을 다 쓴 할당 (mm.c 의 prof_alloc 에서)  */
+/*   밀린 시그널 쓰기를 처리하고, 켜져 있으면 스택을 떠서 기록      */
+/*   bp 에 이미 샘플이 있으면(realloc 안의 malloc 등) 새것으로 바꿈 */
+/* ------------------------------------------------------ */
+void prof_sample(void *bp, size_t size)
+{
+    void *pcs[PROF_DEPTH + SKIP];
+    size_t rate = __atomic_load_n(&prof_rate, RELAXED);
+    unsigned epoch = __atomic_load_n(&prof_epoch, RELAXED);
+    bucket_t *b;
+    sample_t *s;
+    int depth;
+
+    prof_countdown = rate ? next_interval(rate) : PROF_IDLE;
+    if (busy)
+        return;
+    if (dump_pending && __atomic_exchange_n(&dump_pending, 0, __ATOMIC_ACQ_REL))
+        (void)mm_prof_dump(dump_path);             /* 한 스레드만 씀 */
+    if (rate == 0)
+        return;
+    if (my_epoch != epoch) {                       /* 켜진 뒤 처음: 간격만 새로 */
+        my_epoch = epoch;
+        return;
+    }
+
+    busy = 1;
+    depth = backtrace(pcs, PROF_DEPTH + SKIP) - SKIP;
+    pthread_mutex_lock(&prof_lock);
+    forget(bp);
+    if (depth > 0 && (b = find_bucket(pcs + SKIP, depth)) != NULL &&
+        (s = spare != NULL ? spare : pool_alloc(sizeof(sample_t))) != NULL) {
+        if (s == spare)
+            spare = s->next;
+        s->bp = bp;
+        s->size = size;
+        s->b = b;
+        b->live_objs++;
+        b->live_bytes += size;
+        b->alloc_objs++;
+        b->alloc_bytes += size;
+        s->next = live[LIVE_INDEX(bp)];
+        __atomic_store_n(&live[LIVE_INDEX(bp)], s, RELAXED);
+        __atomic_store_n(&prof_live, prof_live + 1, RELAXED);
+        samples++;
+    } else
+        dropped++;
+    pthread_mutex_unlock(&prof_lock);
+    busy = 0;
+}
+
+/* ------------------------------------------------------ */
+/* prof_forget - 샘플이 살아있는 동안의 free (mm.c 의 prof_free)  */
+/*   bp 의 해시 칸이 비었으면 샘플이 아니므로 락 없이 돌아감        */
+/* ------------------------------------------------------ */
+void prof_forget(void *bp)
+{
+    if (__atomic_load_n(&live[LIVE_INDEX(bp)], RELAXED) == NULL || busy)
+        return;
+    pthread_mutex_lock(&prof_lock);
+    forget(bp);
+    pthread_mutex_unlock(&prof_lock);
+}
+
+/* ------------------------------------------------------ */
+/* prof_resize - 제자리 realloc (mm.c 의 PROF_RESIZE)            */
+/*   bp 의 샘플이 있으면 크기만 바꿈: 같은 할당이므로 새 샘플 없음   */
+/* ------------------------------------------------------ */
+void prof_resize(void *bp, size_t size)
+{
+    sample_t *s;
+
+    if (__atomic_load_n(&live[LIVE_INDEX(bp)], RELAXED) == NULL || busy)
+        return;
+    pthread_mutex_lock(&prof_lock);
+    for (s = live[LIVE_INDEX(bp)]; s != NULL; s = s->next)
+        if (s->bp == bp) {
+            s->b->live_bytes += size - s->size;    /* 줄면 wrap-around 로 감소 */
+            s->size = size;
+            break;
+        }
+    pthread_mutex_unlock(&prof_lock);
+}
+
+/* ------------------------------------------------------ */
+/* prof_move_begin - 샘플된 매핑 블록을 mremap 하기 전 (mm.c)     */
+/*   락을 잡아 두어, 옛 주소를 받은 다른 스레드의 샘플이 이 블록의 */
+/*   샘플을 지우기 전에 끼어들지 못하게 함. 잡았으면 1              */
+/* ------------------------------------------------------ */
+int prof_move_begin(void *bp)
+{
+    if (__atomic_load_n(&live[LIVE_INDEX(bp)], RELAXED) == NULL || busy)
+        return 0;
+    pthread_mutex_lock(&prof_lock);
+    return 1;
+}
+
+/* ------------------------------------------------------ */
+/* prof_move_end - mremap 뒤: 블록이 옮겨졌으면 옛 샘플을 지우고 락을 놓음 */
+/* ------------------------------------------------------ */
+void prof_move_end(void *bp, int held, int moved)
+{
+    if (!held)
+        return;
+    if (moved)
+        forget(bp);
+    pthread_mutex_unlock(&prof_lock);
+}
+
+/* ------------------------------------------------------ */
+/* prof_reset - 힙이 새로 시작될 때(mm_init) 샘플과 버킷을 모두 비움 */
+/*   아무것도 기록된 적 없으면 바로 돌아감(프로파일 없는 mm_init 용) */
+/* ------------------------------------------------------ */
+void prof_reset(void)
+{
+    if (pool == NULL || pool_cur == pool)
+        return;
+    pthread_mutex_lock(&prof_lock);
+    memset(stacks, 0, sizeof(stacks));
+    memset(live, 0, sizeof(live));
+    spare = NULL;
+    pool_cur = pool;
+    __atomic_store_n(&prof_live, 0, RELAXED);
+    samples = dropped = 0;
+    pthread_mutex_unlock(&prof_lock);
+}
+
+/* ------------------------------------------------------ */
+/* mm_prof_start - 평균 rate 바이트마다 샘플 시작               */
+/*   backtrace 를 미리 한 번 불러(첫 호출은 라이브러리를 읽으며  */
+/*   malloc 할 수 있음) 샘플 중에 할당이 끼지 않게 함            */
+/* ------------------------------------------------------ */
+void mm_prof_start(size_t rate)
+{
+    void *pc;
+
+    if (rate == 0)
+        rate = PROF_RATE;
+    busy = 1;
+    (void)backtrace(&pc, 1);
+    busy = 0;
+    pthread_mutex_lock(&prof_lock);
+    last_rate = rate;
+    __atomic_store_n(&prof_rate, rate, RELAXED);
+    __atomic_add_fetch(&prof_epoch, 1, RELAXED);
+    pthread_mutex_unlock(&prof_lock);
+    my_epoch = prof_epoch;                         /* 호출 스레드는 바로 샘플 시작 */
+    prof_countdown = next_interval(rate);
+}
+
+/* ------------------------------------------------------ */
+/* mm_prof_stop - 샘플 중지 (살아있는 샘플은 그대로 둠)          */
+/* ------------------------------------------------------ */
+void mm_prof_stop(void)
+{
+    __atomic_store_n(&prof_rate, 0, RELAXED);
+}
+
+/* ------------------------------------------------------ */
+/* mm_prof_counts - 샘플 수, 살아있는 샘플 수, 그 샘플들이 나타내는 */
+/*   살아있는 바이트의 추정치(샘플마다 뽑힐 확률로 나눈 크기의 합)   */
+/* ------------------------------------------------------ */
+void mm_prof_counts(size_t *nsamples, size_t *nlive, double *live_bytes)
+{
+    sample_t *s;
+    double est = 0;
+    size_t i;
+
+    pthread_mutex_lock(&prof_lock);
+    *nsamples = samples;
+    *nlive = prof_live;
+    if (prof_live > 0)
+        for (i = 0; i < LIVE_HASH; i++)
+            for (s = live[i]; s != NULL; s = s->next)
+                est += s->size / -expm1(-(double)s->size / last_rate);
+    pthread_mutex_unlock(&prof_lock);
+    *live_bytes = est;
+}
+
+/* ------------------------------------------------------ */
+/* write_all - fd 에 buf 를 끝까지 씀, 실패하면 -1             */
+/*   프로파일은 stdio 없이 씀: mm.c 가 malloc 을 대신할 때도     */
+/*   쓰는 중에 할당이 일어나지 않도록                           */
+/* ------------------------------------------------------ */
+static int write_all(int fd, const char *buf, size_t len)
+{
+    ssize_t n;
+
+    while (len > 0) {
+        if ((n = write(fd, buf, len)) < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------ */
+/* write_profile - 옛 gperftools 힙 프로파일 형식 (락 보유 상태)  */
+/*   머리줄(합계와 간격), 스택마다 한 줄, 그리고 주소를 심볼로    */
+/*   풀 수 있도록 /proc/self/maps 를 그대로 덧붙임               */
+/* ------------------------------------------------------ */
+static int write_profile(int fd)
+{
+    size_t lo = 0, lb = 0, ao = 0, ab = 0;
+    char buf[4096];
+    bucket_t *b;
+    ssize_t n;
+    int i, j, len, maps;
+
+    for (i = 0; i < STACK_HASH; i++)
+        for (b = stacks[i]; b != NULL; b = b->next) {
+            lo += b->live_objs;
+            lb += b->live_bytes;
+            ao += b->alloc_objs;
+            ab += b->alloc_bytes;
+        }
+    len = snprintf(buf, sizeof(buf), "heap profile: %zu: %zu [%zu: %zu] @ heap_v2/%zu\n",
+                   lo, lb, ao, ab, last_rate);
+    if (write_all(fd, buf, len) < 0)
+        return -1;
+
+    for (i = 0; i < STACK_HASH; i++)
+        for (b = stacks[i]; b != NULL; b = b->next) {
+            len = snprintf(buf, sizeof(buf), "%zu: %zu [%zu: %zu] @",
+                           b->live_objs, b->live_bytes, b->alloc_objs, b->alloc_bytes);
+            for (j = 0; j < b->depth; j++)
+                len += snprintf(buf + len, sizeof(buf) - len, " %p", b->pcs[j]);
+            buf[len++] = '\n';
+            if (write_all(fd, buf, len) < 0)
+                return -1;
+        }
+
+    if (write_all(fd, "\nMAPPED_LIBRARIES:\n", 19) < 0)
+        return -1;
+    if ((maps = open("/proc/self/maps", O_RDONLY)) < 0)
+        return 0;                                  /* 심볼 없이도 쓸 수는 있음 */
+    while ((n = read(maps, buf, sizeof(buf))) > 0)
+        if (write_all(fd, buf, (size_t)n) < 0) {
+            close(maps);
+            return -1;
+        }
+    close(maps);
+    return 0;
+}
+
+/* ------------------------------------------------------ */
+/* mm_prof_dump - 프로파일을 path 에 씀                        */
+/*   여는 것(O_TRUNC)부터 닫기까지 락 안에서 하므로, 같은 파일에   */
+/*   동시에 쓰는 두 덤프가 섞이지 않음                             */
+/* ------------------------------------------------------ */
+int mm_prof_dump(const char *path)
+{
+    int fd, ret, err;
+
+    busy = 1;
+    pthread_mutex_lock(&prof_lock);
+    if ((fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+        ret = -1;
+    } else {
+        ret = write_profile(fd);
+        err = errno;
+        if (close(fd) < 0)
+            ret = -1;
+        else
+            errno = err;
+    }
+    err = errno;
+    pthread_mutex_unlock(&prof_lock);
+    busy = 0;
+    errno = err;
+    return ret;
+}
+
+/* 시그널 핸들러: 표시만 하고, 쓰기는 다음 prof_sample 이 함 */
+static void on_signal(int sig)
+{
+    (void)sig;
+    dump_pending = 1;
+}
+
+/* ------------------------------------------------------ */
+/* mm_prof_signal - 시그널 sig 를 받으면 path 에 프로파일을 씀    */
+/*   핸들러 안에선 락을 잡을 수 없으므로 표시만 해 둠              */
+/* ------------------------------------------------------ */
+int mm_prof_signal(int sig, const char *path)
+{
+    struct sigaction sa;
+
+    if (strlen(path) >= PATH_LEN) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(dump_path, path);
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    return sigaction(sig, &sa, NULL);
+}
+
+#else /* !MM_PROFILE */
+
+/* 훅이 컴파일되지 않았으므로 샘플은 생기지 않음 */
+void mm_prof_start(size_t rate)
+{
+    (void)rate;
+}
+
+void mm_prof_stop(void)
+{
+}
+
+void mm_prof_counts(size_t *nsamples, size_t *nlive, double *live_bytes)
+{
+    *nsamples = *nlive = 0;
+    *live_bytes = 0;
+}
+
+int mm_prof_dump(const char *path)
+{
+    (void)path;
+    errno = ENOSYS;
+    return -1;
+}
+
+int mm_prof_signal(int sig, const char *path)
+{
+    (void)sig;
+    (void)path;
+    errno = ENOSYS;
+    return -1;
+}
+
+#endif /* MM_PROFILE */
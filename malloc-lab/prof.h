@@ -0,0 +1,71 @@
+/*
+ * prof.h - Sampling heap profiler of mm.c
+ *
+ * While a profile runs, mm_malloc (and mm_realloc, mm_aligned_alloc,
+ * mm_malloc_batch) record the call stack of about one allocation per
+ * rate bytes allocated: the bytes between samples are drawn from an
+ * exponential distribution of mean rate, so each byte is sampled with
+ * the same probability, and an allocation of size bytes with
+ * probability 1 - exp(-size / rate), whatever the pattern of sizes.
+ * Sampled blocks that are still live are remembered by address, and
+ * forgotten again when they are freed.
+ *
+ * A profile is written in the legacy text format of gperftools' heap
+ * profiler ("heap profile: ... @ heap_v2/<rate>", then one line per
+ * stack and the process's memory map), which pprof reads and scales
+ * back up from the samples to estimated totals:
+ *
+ *     pprof --text ./mdriver mdriver.prof
+ *
+ * Compiled in with MM_PROFILE (config.h); while no profile runs, the
+ * cost is a thread-local subtraction and a branch per allocation and a
+ * load and a branch per free, plus a call into the profiler every
+ * PROF_IDLE bytes allocated per thread.
+ */
+#ifndef __PROF_H_
+#define __PROF_H_
+
+#include <stddef.h>
+
+/* Start sampling about once per rate bytes allocated (0: PROF_RATE,
+ * see config.h). Live samples of an earlier profile are kept. */
+void mm_prof_start(size_t rate);
+
+/* Stop sampling. The live samples stay, so a profile can still be
+ * written, and their frees are still seen. */
+void mm_prof_stop(void);
+
+/* Write the profile to path; 0 on success, -1 with errno set */
+int mm_prof_dump(const char *path);
+
+/* On signal sig, write the profile to path. The handler only sets a
+ * flag: the profile is written by the next allocation that reaches the
+ * sampler, within about rate (or PROF_IDLE) bytes allocated by some
+ * thread. 0 on success, -1 with errno set. */
+int mm_prof_signal(int sig, const char *path);
+
+/* Samples taken and sampled blocks live now, and the live bytes those
+ * stand for (each sample's size over its probability of being taken),
+ * an unbiased estimate of the bytes mm_malloc is handing out */
+void mm_prof_counts(size_t *samples, size_t *live, double *live_bytes);
+
+/*
+ * Used by mm.c's hooks (prof_alloc, prof_free), not to be called
+ * directly: the bytes each thread has left before its next sample, the
+ * number of live sampled blocks, the slow path taken when the
+ * countdown runs out, the lookups taken on free and on an in-place
+ * realloc while samples are live, the pair that holds the profiler
+ * across an mremap that may move a sampled block (so that no other
+ * thread's sample lands on the old address before this one is
+ * forgotten), and the reset mm_init does when the heap starts over.
+ */
+extern __thread long prof_countdown __attribute__((tls_model("initial-exec")));
+extern size_t prof_live;
+void prof_sample(void *bp, size_t size);
+void prof_forget(void *bp);
+void prof_resize(void *bp, size_t size);
+int prof_move_begin(void *bp);
+void prof_move_end(void *bp, int held, int moved);
+void prof_reset(void);
+
+#endif /* __PROF_H_ */
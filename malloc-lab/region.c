@@ -0,0 +1,128 @@
+/*
+ * region.c - Request-scoped bump allocator on top of mm.c (see region.h)
+ *
+ * 개요(High-level):
+ *   - 청크(chunk)는 mm_malloc 으로 받은 REGION_CHUNK 바이트 블록이며, 맨 앞에 다음 청크를
+ *     가리키는 헤더가 있습니다. region_t 자체는 첫 청크의 헤더 바로 뒤에 삽니다.
+ *   - region_alloc 은 현재 청크의 [cur, end) 에서 포인터만 밀어 줍니다(객체별 헤더 없음).
+ *     모자라면 새 청크를 받아 리스트 앞에 달고 거기서 계속합니다.
+ *   - REGION_CHUNK/4 보다 큰 요청은 딱 맞는 전용 청크를 받아 현재 청크 뒤에 끼워 두므로,
+ *     현재 청크의 남은 공간이 버려지지 않습니다.
+ *   - region_reset 은 첫 청크만 남기고 나머지를 mm_free 로 힙에 돌려주며(청크당 free 한 번),
+ *     region_destroy 는 첫 청크까지 돌려줍니다.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "mm.h"
+#include "region.h"
+
+/* ====== 상수/매크로 정의 ====== */
+
+#define ALIGN(n)        (((n) + (ALIGNMENT - 1)) & ~(size_t)(ALIGNMENT - 1))
+#define CHUNK_HDR       ALIGN(sizeof(chunk_t))      /* 청크 헤더(정렬) */
+#define REGION_HDR      ALIGN(sizeof(region_t))     /* 첫 청크에 든 region_t(정렬) */
+#define BIG_SIZE        (REGION_CHUNK / 4)          /* 이보다 크면 전용 청크 */
+
+typedef struct chunk {
+    struct chunk *next;         /* 먼저 받은 청크 쪽으로 */
+} chunk_t;
+
+struct region {
+    chunk_t *chunks;            /* 청크 리스트(맨 앞이 현재 청크) */
+    chunk_t *first;             /* region_t 가 든 첫 청크 */
+    char *cur, *end;            /* 현재 청크의 남은 공간 */
+};
+
+/* ------------------------------------------------------ */
+/* new_chunk - payload size 바이트짜리 청크를 받아 after 뒤에 연결  */
+/*   after 가 NULL 이면 리스트 맨 앞. 청크의 payload 시작 리턴       */
+/* ------------------------------------------------------ */
+static char *new_chunk(region_t *r, chunk_t *after, size_t size)
+{
+    chunk_t *c = mm_malloc(CHUNK_HDR + size);
+
+    if (c == NULL)
+        return NULL;
+    if (after == NULL) {
+        c->next = r->chunks;
+        r->chunks = c;
+    } else {
+        c->next = after->next;
+        after->next = c;
+    }
+    return (char *)c + CHUNK_HDR;
+}
+
+/* ------------------------------------------------------ */
+/* region_create - 첫 청크를 받고 그 안에 region_t 를 놓음          */
+/* ------------------------------------------------------ */
+region_t *region_create(void)
+{
+    chunk_t *c = mm_malloc(REGION_CHUNK);
+    region_t *r;
+
+    if (c == NULL)
+        return NULL;
+    c->next = NULL;
+    r = (region_t *)((char *)c + CHUNK_HDR);
+    r->chunks = r->first = c;
+    r->cur = (char *)r + REGION_HDR;
+    r->end = (char *)c + REGION_CHUNK;
+    return r;
+}
+
+/* ------------------------------------------------------ */
+/* region_alloc - 현재 청크에서 bump, 모자라면 새 청크(또는 전용)   */
+/* ------------------------------------------------------ */
+void *region_alloc(region_t *r, size_t size)
+{
+    char *p;
+
+    if (size == 0)
+        return NULL;
+    if (size > SIZE_MAX - CHUNK_HDR - ALIGNMENT + 1) /* 정렬·청크 헤더를 더하면 넘침 */
+        return NULL;
+    size = ALIGN(size);
+    if (size <= (size_t)(r->end - r->cur)) {       /* 빠른 경로: 포인터만 이동 */
+        p = r->cur;
+        r->cur += size;
+        return p;
+    }
+    if (size > BIG_SIZE)                           /* 현재 청크 뒤에 전용 청크 */
+        return new_chunk(r, r->chunks, size);
+    if ((p = new_chunk(r, NULL, REGION_CHUNK - CHUNK_HDR)) == NULL)
+        return NULL;
+    r->cur = p + size;
+    r->end = p + REGION_CHUNK - CHUNK_HDR;
+    return p;
+}
+
+/* ------------------------------------------------------ */
+/* region_reset - 첫 청크만 남기고 청크를 모두 힙에 반환            */
+/* ------------------------------------------------------ */
+void region_reset(region_t *r)
+{
+    chunk_t *c, *next;
+
+    for (c = r->chunks; c != NULL; c = next) {
+        next = c->next;
+        if (c != r->first)
+            mm_free(c);
+    }
+    r->chunks = r->first;
+    r->first->next = NULL;
+    r->cur = (char *)r + REGION_HDR;
+    r->end = (char *)r->first + REGION_CHUNK;
+}
+
+/* ------------------------------------------------------ */
+/* region_destroy - 첫 청크(와 region_t)까지 모두 반환             */
+/* ------------------------------------------------------ */
+void region_destroy(region_t *r)
+{
+    region_reset(r);
+    mm_free(r->first);
+}
@@ -0,0 +1,36 @@
+/*
+ * region.h - Request-scoped memory: bump allocation, freed all at once
+ *
+ * A region hands out memory by bumping a pointer through chunks it
+ * takes from mm_malloc (REGION_CHUNK bytes, see config.h), with no
+ * header per object, and frees everything it handed out at once:
+ * region_reset keeps the region's first chunk for the next round and
+ * gives the others back with mm_free, region_destroy gives them all
+ * back. Objects can't be freed or reallocated one by one.
+ *
+ * The chunks are ordinary mm_malloc blocks, so regions and single
+ * mm_malloc blocks share the heap, and mm_check sees the chunks as
+ * allocated blocks. A region is not thread-safe; give each thread
+ * (or request) its own.
+ */
+#ifndef __REGION_H_
+#define __REGION_H_
+
+#include <stddef.h>
+
+typedef struct region region_t;
+
+/* A new, empty region, or NULL if mm_malloc fails */
+region_t *region_create(void);
+
+/* size bytes, ALIGNMENT-aligned, valid until the next reset; NULL if
+ * size is 0 or mm_malloc fails */
+void *region_alloc(region_t *r, size_t size);
+
+/* Free everything allocated from r since it was created or reset */
+void region_reset(region_t *r);
+
+/* Free r and everything allocated from it */
+void region_destroy(region_t *r);
+
+#endif /* __REGION_H_ */
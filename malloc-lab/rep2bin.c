@@ -0,0 +1,324 @@
+/*
+ * rep2bin.c - Convert text .rep traces to the binary trace format
+ *             (see trace.h) and back.
+ *
+ * usage: rep2bin <in.rep> <out.bin>
+ *        rep2bin -d <in.bin> <out.rep>
+ *        rep2bin -D <in.bin> <out.rep>
+ *        rep2bin -g <spec> <out.bin>
+ *
+ * The text parser accepts any unsigned 64-bit block ids, so a capture
+ * whose ids are sparse (e.g. addresses) converts directly; they are
+ * renumbered densely in order of first use and the originals go into
+ * the id table. Records are written as they are read, so only the id
+ * map is held in memory. -d restores the original ids; -D writes the
+ * dense ones instead, which mdriver's text reader requires, so a
+ * sparse trace (e.g. one from libmmcapture.so) still replays as a .rep.
+ * With -g, the trace of a workload model (see workload.h) is generated
+ * straight into a binary trace.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "trace.h"
+#include "workload.h"
+
+/* Open-addressing map from original id to dense id */
+typedef struct
+{
+	uint64_t *keys;		/* original ids */
+	uint32_t *vals;		/* dense id + 1 (0 = empty slot) */
+	size_t cap;			/* number of slots, a power of two */
+	size_t count;		/* ids stored */
+	uint64_t *order;	/* original ids by dense id */
+	size_t order_cap;
+} idmap_t;
+
+static void die(const char *msg)
+{
+	fprintf(stderr, "rep2bin: %s\n", msg);
+	exit(1);
+}
+
+static void *xcalloc(size_t n, size_t size)
+{
+	void *p = calloc(n, size);
+
+	if (p == NULL)
+		die("out of memory");
+	return p;
+}
+
+static size_t hash64(uint64_t x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	return (size_t)x;
+}
+
+/* Double the table when it is half full */
+static void idmap_grow(idmap_t *m)
+{
+	size_t i, j, cap = m->cap ? 2 * m->cap : 1024;
+	uint64_t *keys = xcalloc(cap, sizeof(uint64_t));
+	uint32_t *vals = xcalloc(cap, sizeof(uint32_t));
+
+	for (i = 0; i < m->cap; i++)
+	{
+		if (m->vals[i] == 0)
+			continue;
+		for (j = hash64(m->keys[i]) & (cap - 1); vals[j] != 0; j = (j + 1) & (cap - 1))
+			;
+		keys[j] = m->keys[i];
+		vals[j] = m->vals[i];
+	}
+	free(m->keys);
+	free(m->vals);
+	m->keys = keys;
+	m->vals = vals;
+	m->cap = cap;
+}
+
+/* Dense id of original id key, assigning the next one on first use */
+static uint32_t idmap_get(idmap_t *m, uint64_t key)
+{
+	size_t j;
+
+	if (2 * (m->count + 1) > m->cap)
+		idmap_grow(m);
+	for (j = hash64(key) & (m->cap - 1); m->vals[j] != 0; j = (j + 1) & (m->cap - 1))
+		if (m->keys[j] == key)
+			return m->vals[j] - 1;
+	if (m->count == UINT32_MAX)
+		die("too many block ids");
+	if (m->count == m->order_cap)
+	{
+		m->order_cap = m->order_cap ? 2 * m->order_cap : 1024;
+		if ((m->order = realloc(m->order, m->order_cap * sizeof(uint64_t))) == NULL)
+			die("out of memory");
+	}
+	m->keys[j] = key;
+	m->vals[j] = (uint32_t)m->count + 1;
+	m->order[m->count] = key;
+	return (uint32_t)m->count++;
+}
+
+/* Write v as a varint: 7 bits per byte, low bits first */
+static void put_varint(FILE *fp, uint64_t v)
+{
+	while (v >= 0x80)
+	{
+		fputc((int)(v & 0x7f) | 0x80, fp);
+		v >>= 7;
+	}
+	fputc((int)v, fp);
+}
+
+/* Read a varint at *p (below end); returns -1 if it runs off the end */
+static int get_varint(const unsigned char **p, const unsigned char *end, uint64_t *v)
+{
+	int shift = 0;
+
+	*v = 0;
+	while (*p < end && shift < 64)
+	{
+		unsigned char b = *(*p)++;
+
+		*v |= (uint64_t)(b & 0x7f) << shift;
+		if (!(b & 0x80))
+			return 0;
+		shift += 7;
+	}
+	return -1;
+}
+
+/*
+ * encode - .rep -> binary. The header is written last, once the
+ *     counts and the id table's place are known.
+ */
+static void encode(const char *in, const char *out)
+{
+	FILE *ifp, *ofp;
+	trace_hdr_t hdr;
+	traceop_t op;
+	idmap_t ids;
+	char type[64];
+	unsigned long long id, size, prev;
+	long heap, nids, nops, weight;
+	size_t i;
+
+	if ((ifp = fopen(in, "r")) == NULL)
+		die(strerror(errno));
+	if ((ofp = fopen(out, "wb")) == NULL)
+		die(strerror(errno));
+	if (fscanf(ifp, "%ld %ld %ld %ld", &heap, &nids, &nops, &weight) != 4)
+		die("bad .rep header");
+
+	memset(&hdr, 0, sizeof(hdr));
+	memset(&ids, 0, sizeof(ids));
+	hdr.ops_offset = (sizeof(hdr) + 7) & ~(size_t)7;
+	if (fseek(ofp, (long)hdr.ops_offset, SEEK_SET) < 0)
+		die(strerror(errno));
+
+	while (fscanf(ifp, "%63s", type) == 1)
+	{
+		size = 0;
+		switch (type[0])
+		{
+		case 'a':
+		case 'r':
+			if (fscanf(ifp, "%llu %llu", &id, &size) != 2)
+				die("bad alloc/realloc line");
+			op.type = (type[0] == 'a') ? ALLOC : REALLOC;
+			break;
+		case 'f':
+			if (fscanf(ifp, "%llu", &id) != 1)
+				die("bad free line");
+			op.type = FREE;
+			break;
+		default:
+			fprintf(stderr, "rep2bin: bogus type character (%c)\n", type[0]);
+			exit(1);
+		}
+		op.index = idmap_get(&ids, id);
+		op.size = size;
+		if (fwrite(&op, sizeof(op), 1, ofp) != 1)
+			die(strerror(errno));
+		hdr.num_ops++;
+	}
+	fclose(ifp);
+
+	/* The original ids, zigzag delta coded */
+	hdr.ids_offset = hdr.ops_offset + hdr.num_ops * sizeof(traceop_t);
+	prev = 0;
+	for (i = 0; i < ids.count; i++)
+	{
+		int64_t d = (int64_t)(ids.order[i] - prev);
+
+		put_varint(ofp, ((uint64_t)d << 1) ^ (uint64_t)(d >> 63));
+		prev = ids.order[i];
+	}
+	hdr.ids_len = (uint64_t)ftell(ofp) - hdr.ids_offset;
+
+	memcpy(hdr.magic, TRACE_MAGIC, TRACE_MAGIC_LEN);
+	hdr.version = TRACE_VERSION;
+	hdr.byte_order = TRACE_BYTE_ORDER;
+	hdr.op_size = sizeof(traceop_t);
+	hdr.weight = (uint32_t)weight;
+	hdr.sugg_heapsize = (uint64_t)heap;
+	hdr.num_ids = ids.count;
+	rewind(ofp);
+	if (fwrite(&hdr, sizeof(hdr), 1, ofp) != 1 || fclose(ofp) != 0)
+		die(strerror(errno));
+	if ((long)hdr.num_ops != nops || (long)hdr.num_ids != nids)
+		fprintf(stderr, "rep2bin: note: header said %ld ids/%ld ops, found %llu/%llu\n",
+				nids, nops, (unsigned long long)hdr.num_ids,
+				(unsigned long long)hdr.num_ops);
+}
+
+/*
+ * decode - binary -> .rep, restoring the original ids (or with dense,
+ *    keeping the dense ones)
+ */
+static void decode(const char *in, const char *out, int dense)
+{
+	int fd;
+	struct stat st;
+	const unsigned char *map, *p, *end;
+	const trace_hdr_t *hdr;
+	const traceop_t *ops;
+	uint64_t *orig, d, id = 0;
+	FILE *ofp;
+	size_t i;
+
+	if ((fd = open(in, O_RDONLY)) < 0 || fstat(fd, &st) < 0)
+		die(strerror(errno));
+	if ((size_t)st.st_size < sizeof(trace_hdr_t))
+		die("not a binary trace");
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED)
+		die(strerror(errno));
+	close(fd);
+	hdr = (const trace_hdr_t *)map;
+	if (memcmp(hdr->magic, TRACE_MAGIC, TRACE_MAGIC_LEN) != 0 ||
+		hdr->version != TRACE_VERSION || hdr->byte_order != TRACE_BYTE_ORDER ||
+		hdr->op_size != sizeof(traceop_t) ||
+		hdr->ids_offset + hdr->ids_len > (uint64_t)st.st_size ||
+		hdr->ops_offset + hdr->num_ops * sizeof(traceop_t) > hdr->ids_offset)
+		die("not a binary trace written on this kind of machine");
+
+	orig = xcalloc(hdr->num_ids ? hdr->num_ids : 1, sizeof(uint64_t));
+	p = map + hdr->ids_offset;
+	end = p + hdr->ids_len;
+	for (i = 0; i < hdr->num_ids; i++)
+	{
+		if (get_varint(&p, end, &d) < 0)
+			die("truncated id table");
+		id += (d >> 1) ^ -(d & 1);
+		orig[i] = dense ? i : id;
+	}
+
+	if ((ofp = fopen(out, "w")) == NULL)
+		die(strerror(errno));
+	fprintf(ofp, "%llu\n%llu\n%llu\n%u\n", (unsigned long long)hdr->sugg_heapsize,
+			(unsigned long long)hdr->num_ids, (unsigned long long)hdr->num_ops,
+			hdr->weight);
+	ops = (const traceop_t *)(map + hdr->ops_offset);
+	for (i = 0; i < hdr->num_ops; i++)
+	{
+		if (ops[i].index >= hdr->num_ids)
+			die("op refers to a missing id");
+		if (ops[i].type == FREE)
+			fprintf(ofp, "f %llu\n", (unsigned long long)orig[ops[i].index]);
+		else
+			fprintf(ofp, "%c %llu %llu\n", ops[i].type == ALLOC ? 'a' : 'r',
+					(unsigned long long)orig[ops[i].index],
+					(unsigned long long)ops[i].size);
+	}
+	if (fclose(ofp) != 0)
+		die(strerror(errno));
+	free(orig);
+}
+
+/*
+ * generate - workload spec -> binary
+ */
+static void generate(const char *spec, const char *out)
+{
+	wl_model_t model;
+	char err[1024];
+
+	if (!wl_parse(spec, &model, err, sizeof(err)))
+	{
+		fprintf(stderr, "rep2bin: bad workload spec: %s\n", err);
+		exit(1);
+	}
+	if (!wl_write(&model, out))
+		die(strerror(errno));
+	wl_free(&model);
+}
+
+int main(int argc, char **argv)
+{
+	if (argc == 4 && (!strcmp(argv[1], "-d") || !strcmp(argv[1], "-D")))
+		decode(argv[2], argv[3], argv[1][1] == 'D');
+	else if (argc == 4 && !strcmp(argv[1], "-g"))
+		generate(argv[2], argv[3]);
+	else if (argc == 3)
+		encode(argv[1], argv[2]);
+	else
+	{
+		fprintf(stderr, "usage: %s <in.rep> <out.bin>\n"
+						"       %s -d|-D <in.bin> <out.rep>\n"
+						"       %s -g <spec> <out.bin>\n", argv[0], argv[0], argv[0]);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,276 @@
+/*
+ * stream.c - Read a trace a chunk at a time, one chunk ahead (see stream.h)
+ *
+ * The reader thread fills buf[fill] whenever that buffer is free and
+ * flips fill; the caller takes buf[use], keeps it until its next call
+ * and then hands it back. A chunk of length 0 marks the end of the
+ * trace (or a bad record, with error set). Rewinding stops the reader
+ * and starts a fresh one at the first request.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "stream.h"
+
+/* Read the binary trace header and check that it fits the file */
+static int open_binary(stream_t *s)
+{
+    trace_hdr_t hdr;
+    struct stat st;
+
+    if ((s->fd = open(s->path, O_RDONLY)) < 0 || fstat(s->fd, &st) < 0)
+        return 0;
+    if (pread(s->fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr) ||
+        hdr.version != TRACE_VERSION || hdr.byte_order != TRACE_BYTE_ORDER ||
+        hdr.op_size != sizeof(traceop_t) || hdr.ops_offset % 8 != 0 ||
+        hdr.ops_offset + hdr.num_ops * sizeof(traceop_t) > (uint64_t)st.st_size) {
+        printf("Bad binary trace %s\n", s->path);
+        exit(1);
+    }
+    s->sugg_heapsize = (long)hdr.sugg_heapsize;
+    s->num_ids = (long)hdr.num_ids;
+    s->num_ops = (long)hdr.num_ops;
+    s->weight = (int)hdr.weight;
+    s->ops_offset = (off_t)hdr.ops_offset;
+    posix_fadvise(s->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    return 1;
+}
+
+stream_t *stream_open(const char *path)
+{
+    stream_t *s;
+    char magic[TRACE_MAGIC_LEN];
+
+    if ((s = calloc(1, sizeof(stream_t))) == NULL)
+        return NULL;
+    strncpy(s->path, path, sizeof(s->path) - 1);
+    s->fd = -1;
+    if ((s->fp = fopen(path, "r")) == NULL) {
+        free(s);
+        return NULL;
+    }
+
+    if (fread(magic, 1, TRACE_MAGIC_LEN, s->fp) == TRACE_MAGIC_LEN &&
+        memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_LEN) == 0) {
+        fclose(s->fp);
+        s->fp = NULL;
+        s->binary = 1;
+        if (!open_binary(s)) {
+            if (s->fd >= 0)
+                close(s->fd);
+            free(s);
+            return NULL;
+        }
+    } else {
+        rewind(s->fp);
+        if (fscanf(s->fp, "%ld %ld %ld %d", &s->sugg_heapsize, &s->num_ids,
+                   &s->num_ops, &s->weight) != 4) {
+            printf("Bad header in tracefile %s\n", path);
+            exit(1);
+        }
+        s->data_offset = ftell(s->fp);
+    }
+
+    if ((s->buf[0] = malloc(2 * STREAM_CHUNK * sizeof(traceop_t))) == NULL) {
+        stream_close(s);
+        return NULL;
+    }
+    s->buf[1] = s->buf[0] + STREAM_CHUNK;
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->cond, NULL);
+    s->held = -1;
+    return s;
+}
+
+/* Read up to STREAM_CHUNK records of a binary trace into ops */
+static size_t read_binary(stream_t *s, traceop_t *ops)
+{
+    size_t n = STREAM_CHUNK, got = 0;
+    char *dst = (char *)ops;
+    ssize_t r;
+
+    if ((long)n > s->num_ops - s->pos)
+        n = (size_t)(s->num_ops - s->pos);
+    while (got < n * sizeof(traceop_t)) {
+        r = pread(s->fd, dst + got, n * sizeof(traceop_t) - got,
+                  s->ops_offset + (off_t)(s->pos * sizeof(traceop_t) + got));
+        if (r <= 0) {
+            snprintf(s->error, sizeof(s->error), "Short read in binary trace %s", s->path);
+            return 0;
+        }
+        got += r;
+    }
+    return n;
+}
+
+/* Parse up to STREAM_CHUNK request lines of a .rep trace into ops */
+static size_t read_rep(stream_t *s, traceop_t *ops)
+{
+    char type[64];
+    unsigned long long id, size;
+    size_t n;
+
+    for (n = 0; n < STREAM_CHUNK && fscanf(s->fp, "%63s", type) == 1; n++) {
+        size = 0;
+        switch (type[0]) {
+        case 'a':
+        case 'r':
+            if (fscanf(s->fp, "%llu %llu", &id, &size) != 2)
+                id = (unsigned long long)-1;
+            ops[n].type = (type[0] == 'a') ? ALLOC : REALLOC;
+            break;
+        case 'f':
+            if (fscanf(s->fp, "%llu", &id) != 1)
+                id = (unsigned long long)-1;
+            ops[n].type = FREE;
+            break;
+        default:
+            snprintf(s->error, sizeof(s->error),
+                     "Bogus type character (%c) in tracefile %s", type[0], s->path);
+            return 0;
+        }
+        if (id >= (unsigned long long)s->num_ids) {
+            snprintf(s->error, sizeof(s->error),
+                     "Bad id in request %ld of tracefile %s", s->pos + (long)n, s->path);
+            return 0;
+        }
+        ops[n].index = (uint32_t)id;
+        ops[n].size = size;
+    }
+    return n;
+}
+
+/* Fill one buffer; 0 at the end of the trace or on a bad record */
+static size_t read_chunk(stream_t *s, traceop_t *ops)
+{
+    size_t i, n;
+
+    if (!s->binary)
+        n = read_rep(s, ops);
+    else {
+        /* The replay indexes its block map with the ids unchecked */
+        n = read_binary(s, ops);
+        for (i = 0; i < n; i++)
+            if (ops[i].type > REALLOC || ops[i].index >= (unsigned long)s->num_ids) {
+                snprintf(s->error, sizeof(s->error),
+                         "Bad request %ld in binary trace %s", s->pos + (long)i, s->path);
+                return 0;
+            }
+    }
+    s->pos += n;
+    return n;
+}
+
+static void *reader(void *arg)
+{
+    stream_t *s = arg;
+    traceop_t *ops;
+    size_t n;
+    int b;
+
+    pthread_mutex_lock(&s->lock);
+    for (;;) {
+        while (s->full[s->fill] && !s->stop)
+            pthread_cond_wait(&s->cond, &s->lock);
+        if (s->stop)
+            break;
+        b = s->fill;
+        ops = s->buf[b];
+        pthread_mutex_unlock(&s->lock);
+
+        n = read_chunk(s, ops);
+
+        pthread_mutex_lock(&s->lock);
+        s->len[b] = n;
+        s->full[b] = 1;
+        s->fill = b ^ 1;
+        pthread_cond_broadcast(&s->cond);
+        if (n == 0)
+            break;
+    }
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+/* Stop the reader thread, if there is one */
+static void stop_reader(stream_t *s)
+{
+    if (!s->running)
+        return;
+    pthread_mutex_lock(&s->lock);
+    s->stop = 1;
+    pthread_cond_broadcast(&s->cond);
+    pthread_mutex_unlock(&s->lock);
+    pthread_join(s->reader, NULL);
+    s->running = 0;
+}
+
+void stream_rewind(stream_t *s)
+{
+    stop_reader(s);
+    s->full[0] = s->full[1] = 0;
+    s->fill = s->use = 0;
+    s->held = -1;
+    s->done = s->stop = 0;
+    s->pos = 0;
+    s->error[0] = '\0';
+    if (!s->binary)
+        fseek(s->fp, s->data_offset, SEEK_SET);
+    if (pthread_create(&s->reader, NULL, reader, s) != 0) {
+        printf("Could not start the reader for %s\n", s->path);
+        exit(1);
+    }
+    s->running = 1;
+}
+
+size_t stream_next(stream_t *s, traceop_t **ops)
+{
+    size_t n;
+    int b;
+
+    pthread_mutex_lock(&s->lock);
+    if (s->held >= 0) {
+        s->full[s->held] = 0;
+        s->held = -1;
+        pthread_cond_broadcast(&s->cond);
+    }
+    if (s->done) {
+        pthread_mutex_unlock(&s->lock);
+        return 0;
+    }
+    while (!s->full[s->use])
+        pthread_cond_wait(&s->cond, &s->lock);
+    b = s->use;
+    n = s->len[b];
+    if (n == 0)
+        s->done = 1;
+    else {
+        s->held = b;
+        s->use = b ^ 1;
+    }
+    pthread_mutex_unlock(&s->lock);
+
+    if (n == 0 && s->error[0] != '\0') {
+        printf("%s\n", s->error);
+        exit(1);
+    }
+    *ops = s->buf[b];
+    return n;
+}
+
+void stream_close(stream_t *s)
+{
+    stop_reader(s);
+    if (s->fp != NULL)
+        fclose(s->fp);
+    if (s->fd >= 0)
+        close(s->fd);
+    if (s->buf[0] != NULL) {
+        pthread_mutex_destroy(&s->lock);
+        pthread_cond_destroy(&s->cond);
+    }
+    free(s->buf[0]);
+    free(s);
+}
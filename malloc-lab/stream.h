@@ -0,0 +1,65 @@
+/*
+ * stream.h - Read a trace a chunk at a time, one chunk ahead
+ *
+ * A stream replays a trace (.rep or binary, see trace.h) without
+ * holding it in memory: a reader thread fills one of two buffers of
+ * STREAM_CHUNK ops while the caller works through the other, so only
+ * 2 * STREAM_CHUNK records are ever resident however long the trace is.
+ */
+#ifndef __STREAM_H_
+#define __STREAM_H_
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include "trace.h"
+
+#define STREAM_CHUNK (1 << 16)  /* ops per buffer (1 MB of records) */
+
+typedef struct {
+    /* From the trace header */
+    long sugg_heapsize;          /* suggested heap size (unused) */
+    long num_ids;                /* ids are 0..num_ids-1 */
+    long num_ops;                /* number of requests */
+    int weight;                  /* weight for this trace (unused) */
+
+    /* The file */
+    char path[1024];
+    int binary;                  /* binary trace read with pread ... */
+    int fd;
+    off_t ops_offset;
+    FILE *fp;                    /* ... or .rep parsed with stdio */
+    long data_offset;            /* where the .rep requests start */
+
+    /* The double buffer, handed between the reader and the caller */
+    pthread_t reader;
+    int running;                 /* reader thread started and not joined */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    traceop_t *buf[2];
+    size_t len[2];               /* ops in each buffer (0 = end of trace) */
+    int full[2];                 /* buffer filled and not yet released */
+    int fill;                    /* buffer the reader fills next */
+    int use;                     /* buffer the caller takes next */
+    int held;                    /* buffer the caller has (-1 if none) */
+    int done;                    /* caller has seen the end */
+    int stop;                    /* asks the reader to quit early */
+    long pos;                    /* ops read so far (reader side) */
+    char error[1024 + 128];      /* set by the reader on a bad record */
+} stream_t;
+
+/* Open the trace at path and read its header; NULL if it can't be opened */
+stream_t *stream_open(const char *path);
+
+/* (Re)start reading at the first request */
+void stream_rewind(stream_t *s);
+
+/* Release the chunk from the last call and return the next one in
+ * *ops; returns its length, 0 at the end of the trace. Exits on a
+ * malformed record. */
+size_t stream_next(stream_t *s, traceop_t **ops);
+
+/* Stop the reader and free the stream */
+void stream_close(stream_t *s);
+
+#endif /* __STREAM_H_ */
@@ -0,0 +1,60 @@
+/*
+ * trace.h - Trace records and the binary trace file format
+ *
+ * A binary trace (.bin) is a header, the ops as an array of traceop_t
+ * records exactly as mdriver replays them, and a table of the ids the
+ * trace was captured with. mdriver maps the file and replays the
+ * records in place, so a trace is never parsed or copied.
+ *
+ * Block ids in the records are dense (0..num_ids-1), so they index the
+ * driver's block arrays directly. The original ids, which for captured
+ * traces are often sparse (e.g. addresses), are kept in the id table
+ * in order of the dense ids, each as a zigzag varint of its difference
+ * to the previous one. rep2bin writes binary traces and turns them
+ * back into .rep files.
+ *
+ * Files are in host byte order; TRACE_BYTE_ORDER tells a reader that
+ * a file came from a machine of the other endianness.
+ */
+#ifndef __TRACE_H_
+#define __TRACE_H_
+
+#include <stdint.h>
+
+/* Request types */
+enum
+{
+	ALLOC,
+	FREE,
+	REALLOC
+};
+
+/* Characterizes a single trace operation (allocator request) */
+typedef struct
+{
+	uint32_t type;	/* type of request */
+	uint32_t index; /* index for free() to use later */
+	uint64_t size;	/* byte size of alloc/realloc request (0 for free) */
+} traceop_t;
+
+#define TRACE_MAGIC "MMTRACE"	/* first TRACE_MAGIC_LEN bytes of a binary trace */
+#define TRACE_MAGIC_LEN 8		/* (the string and its NUL) */
+#define TRACE_VERSION 1
+#define TRACE_BYTE_ORDER 0x01020304
+
+typedef struct
+{
+	char magic[TRACE_MAGIC_LEN]; /* TRACE_MAGIC */
+	uint32_t version;		/* TRACE_VERSION */
+	uint32_t byte_order;	/* TRACE_BYTE_ORDER as written */
+	uint32_t op_size;		/* sizeof(traceop_t) */
+	uint32_t weight;		/* weight for this trace (unused) */
+	uint64_t sugg_heapsize; /* suggested heap size (unused) */
+	uint64_t num_ids;		/* number of alloc/realloc ids */
+	uint64_t num_ops;		/* number of records */
+	uint64_t ops_offset;	/* file offset of the records (8-byte aligned) */
+	uint64_t ids_offset;	/* file offset of the id table */
+	uint64_t ids_len;		/* its length in bytes */
+} trace_hdr_t;
+
+#endif /* __TRACE_H_ */
@@ -0,0 +1,496 @@
+/*
+ * workload.c - Synthetic traces from parameterized workload models
+ *              (see workload.h)
+ *
+ * The generator keeps the live blocks in a binary min-heap on their
+ * time of death. Before each request it frees the blocks that are due;
+ * a request then either reallocs a live block picked at random (any
+ * slot of the heap array will do, as the heap order ignores sizes) or
+ * allocates a new block with the next id. Random numbers come from
+ * xoshiro256**, seeded through splitmix64, so a trace depends only on
+ * its model.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "workload.h"
+
+#define WL_WRITE_CHUNK 4096     /* records per write in wl_write */
+
+/* ---------------- Random numbers ---------------- */
+
+static uint64_t splitmix64(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static uint64_t rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t rand64(wl_gen_t *g)
+{
+    uint64_t *s = g->rng, r = rotl(s[1] * 5, 7) * 9, t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+    return r;
+}
+
+/* Uniform on [0, 1) */
+static double rand01(wl_gen_t *g)
+{
+    return (double)(rand64(g) >> 11) * 0x1.0p-53;
+}
+
+/* Standard normal (Box-Muller; one of the pair is dropped) */
+static double rand_normal(wl_gen_t *g)
+{
+    double u = 1.0 - rand01(g), v = rand01(g);
+
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+/* One draw from distribution d */
+static double sample(wl_gen_t *g, const wl_dist_t *d)
+{
+    double u, r;
+    size_t lo, hi, mid;
+
+    switch (d->kind) {
+    case WL_UNIFORM:
+        return d->a + (d->b - d->a) * rand01(g);
+    case WL_EXP:
+        return -d->a * log(1.0 - rand01(g));
+    case WL_LOGNORMAL:
+        return d->a * exp(d->b * rand_normal(g));
+    case WL_POWERLAW:
+        /* Inverse of the bounded Pareto CDF */
+        u = rand01(g);
+        return d->b * pow(1.0 - u * (1.0 - pow(d->b / d->c, d->a)), -1.0 / d->a);
+    case WL_HIST:
+        r = rand01(g) * d->hist->cum[d->hist->n - 1];
+        for (lo = 0, hi = d->hist->n - 1; lo < hi; ) {
+            mid = (lo + hi) / 2;
+            if (d->hist->cum[mid] > r)
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+        return d->hist->vals[lo];
+    default:
+        return d->a;
+    }
+}
+
+/* A size drawn as x, rounded and clamped to 1..maxsize */
+static uint64_t clamp_size(double x, size_t maxsize)
+{
+    if (!(x >= 1.0))
+        return 1;                        /* (also NaN) */
+    if (x >= (double)maxsize)
+        return maxsize;
+    return (uint64_t)llround(x);
+}
+
+/* ---------------- Spec parsing ---------------- */
+
+/* Read a histogram file of "<value> <weight>" lines */
+static wl_hist_t *load_hist(const char *path, char *err, size_t errlen)
+{
+    FILE *fp;
+    wl_hist_t *h;
+    char line[256];
+    double v, w, sum = 0;
+    size_t cap = 0;
+
+    if ((fp = fopen(path, "r")) == NULL) {
+        snprintf(err, errlen, "can't open histogram %s", path);
+        return NULL;
+    }
+    h = calloc(1, sizeof(wl_hist_t));
+    while (h != NULL && fgets(line, sizeof(line), fp) != NULL) {
+        char *p = line + strspn(line, " \t");
+
+        if (*p == '#' || *p == '\n' || *p == '\0')
+            continue;
+        if (sscanf(p, "%lf %lf", &v, &w) != 2 || !(v > 0) || !(w >= 0)) {
+            snprintf(err, errlen, "bad line in histogram %s: %s", path, p);
+            goto fail;
+        }
+        if (h->n == cap) {
+            cap = cap ? 2 * cap : 256;
+            if ((h->vals = realloc(h->vals, cap * sizeof(double))) == NULL ||
+                (h->cum = realloc(h->cum, cap * sizeof(double))) == NULL)
+                goto oom;
+        }
+        sum += w;
+        h->vals[h->n] = v;
+        h->cum[h->n++] = sum;
+    }
+    if (h == NULL)
+        goto oom;
+    if (!(sum > 0)) {
+        snprintf(err, errlen, "histogram %s has no weight", path);
+        goto fail;
+    }
+    fclose(fp);
+    return h;
+
+oom:
+    snprintf(err, errlen, "out of memory reading histogram %s", path);
+fail:
+    fclose(fp);
+    if (h != NULL) {
+        free(h->vals);
+        free(h->cum);
+        free(h);
+    }
+    return NULL;
+}
+
+/* Parse a number, the whole of s */
+static int parse_num(const char *s, double *v)
+{
+    char *end;
+
+    *v = strtod(s, &end);
+    return end != s && *end == '\0';
+}
+
+/* Parse a <dist> */
+static int parse_dist(wl_model_t *m, const char *s, wl_dist_t *d, char *err, size_t errlen)
+{
+    static const struct { const char *name; int kind, nargs; } kinds[] = {
+        {"fixed", WL_FIXED, 1}, {"uniform", WL_UNIFORM, 2}, {"exp", WL_EXP, 1},
+        {"lognormal", WL_LOGNORMAL, 2}, {"powerlaw", WL_POWERLAW, 3},
+    };
+    char buf[256], *arg[4], *p;
+    double v[3] = {0, 0, 0};
+    int i, n;
+
+    if (strncmp(s, "hist:", 5) == 0) {
+        if (m->nhists == (int)(sizeof(m->hists) / sizeof(m->hists[0]))) {
+            snprintf(err, errlen, "too many histograms");
+            return 0;
+        }
+        if ((m->hists[m->nhists] = load_hist(s + 5, err, errlen)) == NULL)
+            return 0;
+        d->kind = WL_HIST;
+        d->hist = m->hists[m->nhists++];
+        return 1;
+    }
+
+    snprintf(buf, sizeof(buf), "%s", s);
+    for (n = 0, p = buf; n < 4 && p != NULL; n++) {
+        arg[n] = p;
+        if ((p = strchr(p, ':')) != NULL)
+            *p++ = '\0';
+    }
+    for (i = 0; i < (int)(sizeof(kinds) / sizeof(kinds[0])); i++)
+        if (strcmp(arg[0], kinds[i].name) == 0)
+            break;
+    if (i == (int)(sizeof(kinds) / sizeof(kinds[0]))) {
+        snprintf(err, errlen, "unknown distribution %s", s);
+        return 0;
+    }
+    if (n - 1 != kinds[i].nargs || p != NULL) {
+        snprintf(err, errlen, "%s takes %d parameter%s", arg[0], kinds[i].nargs,
+                 kinds[i].nargs > 1 ? "s" : "");
+        return 0;
+    }
+    for (n = 0; n < kinds[i].nargs; n++)
+        if (!parse_num(arg[n + 1], &v[n])) {
+            snprintf(err, errlen, "bad number %s in %s", arg[n + 1], s);
+            return 0;
+        }
+    d->kind = kinds[i].kind;
+    d->a = v[0];
+    d->b = v[1];
+    d->c = v[2];
+    d->hist = NULL;
+    if ((d->kind == WL_UNIFORM && d->b < d->a) ||
+        (d->kind == WL_EXP && !(d->a > 0)) ||
+        (d->kind == WL_LOGNORMAL && (!(d->a > 0) || d->b < 0)) ||
+        (d->kind == WL_POWERLAW && (!(d->a > 0) || !(d->b > 0) || d->c < d->b))) {
+        snprintf(err, errlen, "bad parameters in %s", s);
+        return 0;
+    }
+    return 1;
+}
+
+/* Apply one key=value setting to phase p */
+static int parse_setting(wl_model_t *m, wl_phase_t *p, char *kv, char *err, size_t errlen)
+{
+    char *val = strchr(kv, '=');
+    double v;
+
+    if (val == NULL) {
+        snprintf(err, errlen, "expected key=value, got %s", kv);
+        return 0;
+    }
+    *val++ = '\0';
+    if (strcmp(kv, "size") == 0)
+        return parse_dist(m, val, &p->size, err, errlen);
+    if (strcmp(kv, "life") == 0)
+        return parse_dist(m, val, &p->life, err, errlen);
+    if (strcmp(kv, "grow") == 0)
+        return parse_dist(m, val, &p->grow, err, errlen);
+    if (strcmp(kv, "seed") == 0) {
+        char *end;
+
+        m->seed = strtoull(val, &end, 0);
+        if (end != val && *end == '\0')
+            return 1;
+    }
+    if (!parse_num(val, &v) || v < 0) {
+        snprintf(err, errlen, "bad value %s for %s", val, kv);
+        return 0;
+    }
+    if (strcmp(kv, "ops") == 0)
+        p->ops = (long)v;
+    else if (strcmp(kv, "maxsize") == 0 && v >= 1)
+        p->maxsize = (size_t)v;
+    else if (strcmp(kv, "live") == 0)
+        p->live = (long)v;
+    else if (strcmp(kv, "realloc") == 0 && v <= 1)
+        p->realloc = v;
+    else {
+        snprintf(err, errlen, "unknown key %s (or bad value %s)", kv, val);
+        return 0;
+    }
+    return 1;
+}
+
+int wl_parse(const char *spec, wl_model_t *m, char *err, size_t errlen)
+{
+    char *buf, *phase, *kv, *sp, *sk;
+    wl_phase_t *p;
+    double total = 0;
+    int i;
+
+    memset(m, 0, sizeof(*m));
+    m->seed = 1;
+    p = &m->phase[0];
+    p->ops = 100000;
+    p->size.kind = WL_LOGNORMAL;
+    p->size.a = 48;
+    p->size.b = 1;
+    p->maxsize = 1 << 20;
+    p->life.kind = WL_EXP;
+    p->life.a = 1000;
+    p->grow.kind = WL_FIXED;
+    p->grow.a = 2;
+
+    if ((buf = strdup(spec)) == NULL) {
+        snprintf(err, errlen, "out of memory");
+        return 0;
+    }
+    for (phase = strtok_r(buf, ";", &sp); phase != NULL; phase = strtok_r(NULL, ";", &sp)) {
+        if (m->nphases == WL_MAX_PHASES) {
+            snprintf(err, errlen, "more than %d phases", WL_MAX_PHASES);
+            goto fail;
+        }
+        p = &m->phase[m->nphases];
+        if (m->nphases > 0)
+            *p = m->phase[m->nphases - 1];       /* settings carry over */
+        for (kv = strtok_r(phase, ", \t\n", &sk); kv != NULL; kv = strtok_r(NULL, ", \t\n", &sk))
+            if (!parse_setting(m, p, kv, err, errlen))
+                goto fail;
+        m->nphases++;
+    }
+    free(buf);
+    if (m->nphases == 0)
+        m->nphases = 1;                          /* an empty spec: the defaults */
+
+    /* The driver keeps ids and record counts in ints */
+    for (i = 0; i < m->nphases; i++)
+        total += m->phase[i].ops;
+    if (2 * total > INT32_MAX) {
+        snprintf(err, errlen, "too many ops");
+        wl_free(m);
+        return 0;
+    }
+    return 1;
+
+fail:
+    free(buf);
+    wl_free(m);
+    return 0;
+}
+
+void wl_free(wl_model_t *m)
+{
+    int i;
+
+    for (i = 0; i < m->nhists; i++) {
+        free(m->hists[i]->vals);
+        free(m->hists[i]->cum);
+        free(m->hists[i]);
+    }
+    m->nhists = 0;
+}
+
+/* ---------------- Generation ---------------- */
+
+/* Add block b to the heap of live blocks */
+static void heap_push(wl_gen_t *g, wl_block_t b)
+{
+    size_t i, up;
+
+    if (g->nlive == g->cap) {
+        g->cap = g->cap ? 2 * g->cap : 1024;
+        if ((g->live = realloc(g->live, g->cap * sizeof(wl_block_t))) == NULL) {
+            fprintf(stderr, "workload: out of memory\n");
+            exit(1);
+        }
+    }
+    for (i = g->nlive++; i > 0 && g->live[up = (i - 1) / 2].death > b.death; i = up)
+        g->live[i] = g->live[up];
+    g->live[i] = b;
+}
+
+/* Remove and return the block that dies first */
+static wl_block_t heap_pop(wl_gen_t *g)
+{
+    wl_block_t top = g->live[0], last = g->live[--g->nlive];
+    size_t i = 0, c;
+
+    while ((c = 2 * i + 1) < g->nlive) {
+        if (c + 1 < g->nlive && g->live[c + 1].death < g->live[c].death)
+            c++;
+        if (g->live[c].death >= last.death)
+            break;
+        g->live[i] = g->live[c];
+        i = c;
+    }
+    if (g->nlive > 0)
+        g->live[i] = last;
+    return top;
+}
+
+void wl_start(wl_gen_t *g, const wl_model_t *m)
+{
+    uint64_t x = m->seed;
+    int i;
+
+    memset(g, 0, sizeof(*g));
+    g->model = m;
+    for (i = 0; i < 4; i++)
+        g->rng[i] = splitmix64(&x);
+    g->left = m->phase[0].ops;
+}
+
+size_t wl_next(wl_gen_t *g, traceop_t *ops, size_t n)
+{
+    const wl_phase_t *p;
+    wl_block_t b;
+    double life;
+    size_t k = 0;
+
+    while (k < n) {
+        /* Free the blocks that are due, and at the end all of them */
+        if (g->nlive > 0 && (g->live[0].death <= g->clock ||
+                             (g->left == 0 && g->phase == g->model->nphases - 1))) {
+            b = heap_pop(g);
+            ops[k].type = FREE;
+            ops[k].index = b.id;
+            ops[k++].size = 0;
+            continue;
+        }
+        if (g->left == 0) {
+            if (g->phase == g->model->nphases - 1)
+                break;                            /* all freed: the end */
+            g->left = g->model->phase[++g->phase].ops;
+            continue;
+        }
+        p = &g->model->phase[g->phase];
+
+        if (p->live > 0 && g->nlive >= (size_t)p->live) {
+            b = heap_pop(g);                      /* make room */
+            ops[k].type = FREE;
+            ops[k].index = b.id;
+            ops[k++].size = 0;
+            continue;
+        }
+        if (g->nlive > 0 && p->realloc > 0 && rand01(g) < p->realloc) {
+            wl_block_t *r = &g->live[rand64(g) % g->nlive];
+
+            r->size = clamp_size((double)r->size * sample(g, &p->grow), p->maxsize);
+            ops[k].type = REALLOC;
+            ops[k].index = r->id;
+            ops[k++].size = r->size;
+        } else {
+            b.id = (uint32_t)g->num_ids++;
+            b.size = clamp_size(sample(g, &p->size), p->maxsize);
+            life = sample(g, &p->life);
+            b.death = (life > 0) ? g->clock + 1 + (uint64_t)llround(life > 1 ? life : 1) : UINT64_MAX;
+            heap_push(g, b);
+            ops[k].type = ALLOC;
+            ops[k].index = b.id;
+            ops[k++].size = b.size;
+        }
+        g->clock++;
+        g->left--;
+    }
+    g->num_ops += k;
+    return k;
+}
+
+void wl_stop(wl_gen_t *g)
+{
+    free(g->live);
+    g->live = NULL;
+    g->nlive = g->cap = 0;
+}
+
+int wl_write(const wl_model_t *m, const char *path)
+{
+    FILE *fp;
+    trace_hdr_t hdr;
+    traceop_t ops[WL_WRITE_CHUNK];
+    wl_gen_t g;
+    size_t n;
+    long i;
+    int ok;
+
+    if ((fp = fopen(path, "wb")) == NULL)
+        return 0;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.ops_offset = (sizeof(hdr) + 7) & ~(size_t)7;
+    ok = fseek(fp, (long)hdr.ops_offset, SEEK_SET) == 0;
+
+    wl_start(&g, m);
+    while (ok && (n = wl_next(&g, ops, WL_WRITE_CHUNK)) > 0)
+        ok = fwrite(ops, sizeof(traceop_t), n, fp) == n;
+    wl_stop(&g);
+
+    /* The ids are dense already: the table is 0, then deltas of 1 (zigzag 2) */
+    hdr.ids_offset = hdr.ops_offset + (uint64_t)g.num_ops * sizeof(traceop_t);
+    for (i = 0; ok && i < g.num_ids; i++)
+        ok = fputc(i == 0 ? 0 : 2, fp) != EOF;
+    hdr.ids_len = (uint64_t)g.num_ids;
+
+    memcpy(hdr.magic, TRACE_MAGIC, TRACE_MAGIC_LEN);
+    hdr.version = TRACE_VERSION;
+    hdr.byte_order = TRACE_BYTE_ORDER;
+    hdr.op_size = sizeof(traceop_t);
+    hdr.weight = 1;
+    hdr.num_ids = (uint64_t)g.num_ids;
+    hdr.num_ops = (uint64_t)g.num_ops;
+    if (ok) {
+        rewind(fp);
+        ok = fwrite(&hdr, sizeof(hdr), 1, fp) == 1;
+    }
+    return (fclose(fp) == 0) && ok;
+}
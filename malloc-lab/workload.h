@@ -0,0 +1,129 @@
+/*
+ * workload.h - Synthetic traces from parameterized workload models
+ *
+ * A model is a sequence of phases. Each phase makes a number of
+ * requests whose sizes, lifetimes and reallocations are drawn from
+ * the phase's distributions; blocks outlive the phase they were made
+ * in, so a phase change shifts the workload rather than resetting it.
+ * Time is counted in allocation requests: a block with lifetime L is
+ * freed once L more mallocs or reallocs have been made. At the end all
+ * the blocks still live are freed, in the order they would have died.
+ *
+ * The generator hands the trace out a chunk at a time (like stream.h),
+ * so a trace of any length can be replayed from memory or written
+ * straight to a binary trace (see trace.h) without being held whole.
+ * The same model and seed always give the same trace.
+ *
+ * Models are written as specs: phases separated by ';', each a list
+ * of key=value settings separated by ',' that start from the previous
+ * phase's settings:
+ *
+ *   seed=<n>         random seed (the whole trace; default 1)
+ *   ops=<n>          mallocs and reallocs in the phase (default 100000)
+ *   size=<dist>      request size in bytes (default lognormal:48:1)
+ *   maxsize=<n>      sizes are clamped to 1..<n> (default 1048576)
+ *   life=<dist>      block lifetime; 0 or less lives to the end
+ *                    (default exp:1000)
+ *   live=<n>         at most <n> live blocks: the one due to die
+ *                    first is freed early to make room (0 = no limit)
+ *   realloc=<p>      fraction of requests that realloc a random live
+ *                    block instead of making a new one (default 0)
+ *   grow=<dist>      factor a realloc scales the size by (default fixed:2)
+ *
+ * and <dist> is one of
+ *
+ *   fixed:<v>              always v
+ *   uniform:<lo>:<hi>      uniform on [lo, hi]
+ *   exp:<mean>             exponential
+ *   lognormal:<median>:<sigma>   exp of a normal with that median
+ *                          and standard deviation (of the log)
+ *   powerlaw:<alpha>:<lo>:<hi>   Pareto with tail index alpha,
+ *                          bounded to [lo, hi]
+ *   hist:<file>            drawn from a histogram: "<value> <weight>"
+ *                          lines, e.g. sizes counted in a capture
+ *
+ * e.g. "seed=3,ops=50000,size=powerlaw:1.2:16:65536,life=exp:500;
+ *       ops=50000,size=hist:prod.hist,realloc=0.1,grow=uniform:1.2:2"
+ */
+#ifndef __WORKLOAD_H_
+#define __WORKLOAD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "trace.h"
+
+#define WL_PREFIX "gen:"    /* mdriver: a trace named gen:<spec> is generated */
+#define WL_MAX_PHASES 16
+
+/* Distribution kinds */
+enum { WL_FIXED, WL_UNIFORM, WL_EXP, WL_LOGNORMAL, WL_POWERLAW, WL_HIST };
+
+/* An imported histogram: values with cumulative weights */
+typedef struct {
+    size_t n;
+    double *vals;
+    double *cum;                /* cum[i] = weight of vals[0..i] */
+} wl_hist_t;
+
+typedef struct {
+    int kind;
+    double a, b, c;             /* parameters, in the order of the spec */
+    const wl_hist_t *hist;      /* WL_HIST */
+} wl_dist_t;
+
+typedef struct {
+    long ops;                   /* mallocs and reallocs */
+    wl_dist_t size;
+    size_t maxsize;
+    wl_dist_t life;
+    long live;                  /* live block limit (0 = none) */
+    double realloc;             /* fraction of requests that are reallocs */
+    wl_dist_t grow;
+} wl_phase_t;
+
+typedef struct {
+    uint64_t seed;
+    int nphases;
+    wl_phase_t phase[WL_MAX_PHASES];
+    int nhists;                 /* histograms the phases point into */
+    wl_hist_t *hists[WL_MAX_PHASES * 3];
+} wl_model_t;
+
+/* A live block, in a min-heap on its time of death */
+typedef struct {
+    uint64_t death;
+    uint32_t id;
+    uint64_t size;
+} wl_block_t;
+
+typedef struct {
+    const wl_model_t *model;
+    uint64_t rng[4];            /* xoshiro256** state */
+    int phase;                  /* current phase ... */
+    long left;                  /* ... and its requests still to make */
+    uint64_t clock;             /* allocation requests made so far */
+    wl_block_t *live;           /* the live blocks (heap order) */
+    size_t nlive, cap;
+    long num_ids;               /* ids handed out so far (0..num_ids-1) */
+    long num_ops;               /* records handed out so far */
+} wl_gen_t;
+
+/* Parse spec into m. Returns 0 and puts the reason in err if it is bad */
+int wl_parse(const char *spec, wl_model_t *m, char *err, size_t errlen);
+
+/* Free the histograms a parsed model holds */
+void wl_free(wl_model_t *m);
+
+/* Start generating the trace of model m, which must outlive g */
+void wl_start(wl_gen_t *g, const wl_model_t *m);
+
+/* Put up to n more records in ops; returns how many, 0 at the end */
+size_t wl_next(wl_gen_t *g, traceop_t *ops, size_t n);
+
+/* Release the generator's state */
+void wl_stop(wl_gen_t *g);
+
+/* Generate the trace of model m into a binary trace file; 0 on error */
+int wl_write(const wl_model_t *m, const char *path);
+
+#endif /* __WORKLOAD_H_ */